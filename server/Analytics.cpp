@@ -0,0 +1,116 @@
+#include "Analytics.h"
+
+#include "GameModel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SeaBattle::Analytics
+{
+    namespace
+    {
+        static_assert(LargeRules::Rows <= MaxRows && LargeRules::Cols <= MaxCols, "analytics grid is smaller than the largest board");
+
+        using Counter = std::atomic<std::uint64_t>;
+
+        // Счётчики одного потока. Пишет только владелец - обычные load/store без lock-префикса;
+        // atomic нужен, чтобы снимок из другого потока читал целые значения.
+        // Каждый блок с начала своей линии кэша, чтобы соседние блоки в куче не делили линию
+        struct alignas(64) ThreadCounters
+        {
+            std::array<Counter, MaxCells> cellShots{};
+            std::array<Counter, MaxCells> cellHits{};
+            std::array<Counter, MaxTurns> turnShots{};
+            std::array<Counter, MaxTurns> turnHits{};
+            std::array<Counter, MaxTurns + 1> gameLengths{};
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadCounters>> counters;
+        };
+
+        Registry& registry()
+        {
+            static Registry instance;
+            return instance;
+        }
+
+        ThreadCounters& threadCounters()
+        {
+            // Блокировка только при первом выстреле потока; счётчики живут до конца процесса,
+            // чтобы снимок учитывал и завершившиеся потоки
+            thread_local ThreadCounters* counters = []()
+            {
+                auto& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                reg.counters.push_back(std::make_unique<ThreadCounters>());
+                return reg.counters.back().get();
+            }();
+            return *counters;
+        }
+
+        void bump(Counter& counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        template <std::size_t N>
+        void add(std::array<std::uint64_t, N>& total, const std::array<Counter, N>& counters)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                total[i] += counters[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void RecordShot(int row, int col, int turn, bool hit)
+    {
+        auto& counters = threadCounters();
+        const auto cell = static_cast<std::size_t>(row * MaxCols + col);
+        const auto index = static_cast<std::size_t>(std::clamp(turn, 0, MaxTurns - 1));
+        bump(counters.cellShots[cell]);
+        bump(counters.turnShots[index]);
+        if (hit)
+        {
+            bump(counters.cellHits[cell]);
+            bump(counters.turnHits[index]);
+        }
+    }
+
+    void RecordGame(int shots)
+    {
+        bump(threadCounters().gameLengths[static_cast<std::size_t>(std::clamp(shots, 0, MaxTurns))]);
+    }
+
+    Snapshot TakeSnapshot()
+    {
+        Snapshot snapshot;
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& counters : reg.counters)
+        {
+            add(snapshot.cellShots, counters->cellShots);
+            add(snapshot.cellHits, counters->cellHits);
+            add(snapshot.turnShots, counters->turnShots);
+            add(snapshot.turnHits, counters->turnHits);
+            add(snapshot.gameLengths, counters->gameLengths);
+        }
+        snapshot.threads = reg.counters.size();
+        for (int cell = 0; cell < MaxCells; ++cell)
+        {
+            snapshot.shots += snapshot.cellShots[static_cast<std::size_t>(cell)];
+            snapshot.hits += snapshot.cellHits[static_cast<std::size_t>(cell)];
+        }
+        for (auto games : snapshot.gameLengths)
+        {
+            snapshot.games += games;
+        }
+        return snapshot;
+    }
+}
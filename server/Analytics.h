@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Статистика партий для живых панелей: тепловая карта выстрелов, попадания по номеру
+// выстрела в партии, распределение длины партий. Каждый поток пишет в свои счётчики
+// (отдельные линии кэша, без атомарных read-modify-write и блокировок), снимок
+// складывает счётчики всех потоков. Снимок читает их без остановки писателей, поэтому
+// итоги разных счётчиков могут расходиться на выстрелы, сделанные во время сложения.
+namespace SeaBattle::Analytics
+{
+    // Наибольшее поле из поддерживаемых правил; клетка row * MaxCols + col
+    inline constexpr int MaxRows = 12;
+    inline constexpr int MaxCols = 12;
+    inline constexpr int MaxCells = MaxRows * MaxCols;
+    // Выстрелов в партии не больше, чем клеток на обоих полях
+    inline constexpr int MaxTurns = 2 * MaxCells;
+
+    struct Snapshot
+    {
+        std::uint64_t shots = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t games = 0;
+        std::array<std::uint64_t, MaxCells> cellShots{};
+        std::array<std::uint64_t, MaxCells> cellHits{};
+        // Номер выстрела в партии (с нуля, оба игрока подряд)
+        std::array<std::uint64_t, MaxTurns> turnShots{};
+        std::array<std::uint64_t, MaxTurns> turnHits{};
+        // gameLengths[n] - партий из n выстрелов
+        std::array<std::uint64_t, MaxTurns + 1> gameLengths{};
+        std::size_t threads = 0;    // потоков, писавших статистику
+    };
+
+    // turn - номер выстрела в партии; за пределами MaxTurns учитывается в последнем
+    void RecordShot(int row, int col, int turn, bool hit);
+    // Партия закончилась после shots выстрелов
+    void RecordGame(int shots);
+
+    Snapshot TakeSnapshot();
+}
@@ -0,0 +1,247 @@
+#include "BotExecutor.h"
+
+#include <algorithm>
+#include <random>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+namespace SeaBattle
+{
+    namespace
+    {
+        constexpr std::size_t LatencyWindow = 4096;
+        // Средняя стоимость хода сглаживается экспоненциально с таким весом нового хода
+        constexpr double CostWeight = 0.2;
+        // Бюджет копится не больше чем за секунду простоя
+        constexpr double BurstSeconds = 1.0;
+
+        // Ходы ботов не должны отнимать процессор у обработки ходов людей
+        void lowerThreadPriority()
+        {
+#ifdef __linux__
+            sched_param param{};
+            pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+        }
+
+        // Процессорное время текущего потока; где его не достать - настенное
+        double threadCpuSeconds()
+        {
+#ifdef __linux__
+            timespec ts{};
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        double percentile(std::vector<double>& values, double fraction)
+        {
+            if (values.empty())
+            {
+                return 0.0;
+            }
+            auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1));
+            std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+            return values[index];
+        }
+    }
+
+    BotExecutor::BotExecutor(BotExecutorConfig config)
+        : m_config(std::move(config))
+        , m_tokens(m_config.cpuShare * BurstSeconds)
+        , m_refilled(Clock::now())
+    {
+        m_latencies.reserve(LatencyWindow);
+    }
+
+    BotExecutor::~BotExecutor()
+    {
+        Stop();
+    }
+
+    const std::array<std::string_view, BotExecutorStats::Tiers>& BotExecutor::TierNames()
+    {
+        static const std::array<std::string_view, BotExecutorStats::Tiers> names = { "book", "endgame", "density", "parity", "random" };
+        return names;
+    }
+
+    void BotExecutor::Start()
+    {
+        if (!m_workers.empty())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = false;
+        }
+        for (unsigned i = 0; i < std::max(1u, m_config.threads); ++i)
+        {
+            m_workers.emplace_back([this]() { run(); });
+        }
+    }
+
+    void BotExecutor::Stop()
+    {
+        if (m_workers.empty())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeup.notify_all();
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.clear();
+    }
+
+    void BotExecutor::Submit(const ShotBoard& board, std::uint64_t seed, Done done)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back({ board, seed, Clock::now(), std::move(done) });
+        }
+        m_wakeup.notify_one();
+    }
+
+    bool BotExecutor::throttle()
+    {
+        double deficit = 0.0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto now = Clock::now();
+            const double idle = std::chrono::duration<double>(now - m_refilled).count();
+            m_tokens = std::min(m_config.cpuShare * BurstSeconds, m_tokens + idle * m_config.cpuShare);
+            m_refilled = now;
+            if (m_tokens > 0.0)
+            {
+                return false;
+            }
+            deficit = -m_tokens;
+            ++m_stats.throttled;
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(deficit / m_config.cpuShare));
+        return true;
+    }
+
+    void BotExecutor::charge(double cpuSeconds)
+    {
+        m_tokens -= cpuSeconds;
+        m_stats.cpuSeconds += cpuSeconds;
+    }
+
+    void BotExecutor::run()
+    {
+        lowerThreadPriority();
+
+        const auto& names = TierNames();
+        std::array<std::unique_ptr<IShotStrategy>, BotExecutorStats::Tiers> strategies;
+        for (std::size_t tier = 1; tier < names.size(); ++tier)
+        {
+            strategies[tier] = MakeStrategy(names[tier]);
+        }
+
+        for (;;)
+        {
+            Task task;
+            std::size_t behind = 0;
+            std::array<double, BotExecutorStats::Tiers> cost{};
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeup.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping)
+                {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                behind = m_tasks.size();
+                cost = m_cost;
+            }
+
+            throttle();
+
+            const auto start = Clock::now();
+            const double cpuStart = threadCpuSeconds();
+            std::mt19937 gen{ static_cast<std::uint32_t>(task.seed ^ (task.seed >> 32)) };
+            std::size_t tier = 0;
+            Position shot;
+            if (auto move = m_config.book ? m_config.book->Lookup(task.board) : std::nullopt)
+            {
+                shot = *move;
+            }
+            else
+            {
+                // Оставшееся до срока время делится с ходами, которые ждут за этим
+                const double remaining = std::chrono::duration<double>(task.submitted + m_config.moveDeadline - start).count();
+                const double allowance = remaining / static_cast<double>(behind + 1);
+                tier = strategies.size() - 1;
+                for (std::size_t t = 1; t < strategies.size(); ++t)
+                {
+                    if (cost[t] <= allowance)
+                    {
+                        tier = t;
+                        break;
+                    }
+                }
+                shot = strategies[tier]->NextShot(task.board, gen);
+            }
+            const double cpu = threadCpuSeconds() - cpuStart;
+            const auto finished = Clock::now();
+            const double latency = std::chrono::duration<double, std::micro>(finished - task.submitted).count();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                // Стоимость - процессорное время: вытеснение потоками людей не должно удорожать стратегию
+                m_cost[tier] = m_cost[tier] == 0.0 ? cpu : m_cost[tier] + CostWeight * (cpu - m_cost[tier]);
+                charge(cpu);
+                ++m_stats.moves;
+                ++m_stats.movesByTier[tier];
+                if (finished - task.submitted > m_config.moveDeadline)
+                {
+                    ++m_stats.deadlineMisses;
+                }
+                if (m_latencies.size() < LatencyWindow)
+                {
+                    m_latencies.push_back(latency);
+                }
+                else
+                {
+                    m_latencies[m_latencyNext] = latency;
+                    m_latencyNext = (m_latencyNext + 1) % LatencyWindow;
+                }
+            }
+
+            task.done(shot);
+        }
+    }
+
+    BotExecutorStats BotExecutor::Stats() const
+    {
+        std::vector<double> latencies;
+        BotExecutorStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stats = m_stats;
+            stats.queued = m_tasks.size();
+            latencies = m_latencies;
+        }
+        stats.latencyP50 = percentile(latencies, 0.50);
+        stats.latencyP99 = percentile(latencies, 0.99);
+        stats.latencyMax = percentile(latencies, 1.0);
+        return stats;
+    }
+}
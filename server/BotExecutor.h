@@ -0,0 +1,110 @@
+#pragma once
+
+#include "OpeningBook.h"
+#include "Strategy.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace SeaBattle
+{
+    struct BotExecutorConfig
+    {
+        unsigned threads = 1;
+        // Доля одного ядра, которую боты могут занять в сумме; сверх неё ходы ждут
+        double cpuShare = 0.25;
+        // За сколько от запроса бот должен сходить; не успевает дорогая стратегия - берётся дешевле
+        std::chrono::milliseconds moveDeadline{ 200 };
+        // Если задана - дебют разыгрывается по ней
+        std::shared_ptr<const OpeningBook> book;
+    };
+
+    struct BotExecutorStats
+    {
+        static constexpr int Tiers = 5;  // книга и стратегии из BotExecutor::TierNames
+
+        std::uint64_t moves = 0;
+        std::array<std::uint64_t, Tiers> movesByTier{};
+        std::uint64_t deadlineMisses = 0;   // ход отдан позже moveDeadline
+        std::uint64_t throttled = 0;        // ход ждал, пока восстановится бюджет процессора
+        std::size_t queued = 0;
+        double cpuSeconds = 0.0;            // процессорное время потоков ботов
+        // Задержка хода от Submit до вызова done по последним ходам, мкс
+        double latencyP50 = 0.0;
+        double latencyP99 = 0.0;
+        double latencyMax = 0.0;
+    };
+
+    // Ходы ботов, живущих в сервере. Отдельные потоки с самым низким приоритетом (SCHED_IDLE)
+    // не отнимают процессор у обработки ходов людей, а общий бюджет (ведро токенов
+    // в секундах процессорного времени) ограничивает их долю, даже когда процессор свободен.
+    // Стратегия выбирается на каждый ход: самая сильная из тех, чья средняя стоимость
+    // укладывается в оставшееся до срока время, поделённое на ходы в очереди, - под нагрузкой
+    // боты сами переходят на дешёвые стратегии.
+    class BotExecutor
+    {
+    public:
+        using Done = std::function<void(Position)>;
+
+        explicit BotExecutor(BotExecutorConfig config);
+        ~BotExecutor();
+
+        BotExecutor(const BotExecutor&) = delete;
+        BotExecutor& operator=(const BotExecutor&) = delete;
+
+        void Start();
+        void Stop();
+
+        // Ход бота по полю противника; done вызывается в потоке исполнителя.
+        // Ходы, не сделанные до Stop, отбрасываются
+        void Submit(const ShotBoard& board, std::uint64_t seed, Done done);
+
+        BotExecutorStats Stats() const;
+
+        // От сильной к дешёвой; "book" - ход из книги дебютов
+        static const std::array<std::string_view, BotExecutorStats::Tiers>& TierNames();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Task
+        {
+            ShotBoard board;
+            std::uint64_t seed = 0;
+            Clock::time_point submitted;
+            Done done;
+        };
+
+        void run();
+        // Ждёт, пока бюджет станет положительным; true - ждали
+        bool throttle();
+        void charge(double cpuSeconds);
+
+        BotExecutorConfig m_config;
+        std::vector<std::thread> m_workers;
+
+        mutable std::mutex m_mutex;     // очередь, бюджет и статистика
+        std::condition_variable m_wakeup;
+        std::deque<Task> m_tasks;
+        bool m_stopping = false;
+
+        double m_tokens = 0.0;          // секунд процессора, можно уйти в минус на один ход
+        Clock::time_point m_refilled;
+
+        // Средняя стоимость хода стратегией, секунд процессора; общая для потоков
+        std::array<double, BotExecutorStats::Tiers> m_cost{};
+
+        BotExecutorStats m_stats;
+        std::vector<double> m_latencies;    // кольцо последних задержек, мкс
+        std::size_t m_latencyNext = 0;
+    };
+}
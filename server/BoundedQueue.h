@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace SeaBattle
+{
+    // Очередь фиксированной ёмкости без блокировок для нескольких писателей и читателей
+    // (кольцо Вьюкова: у каждой ячейки свой счётчик последовательности).
+    // Ёмкость округляется вверх до степени двойки; T копируется целиком.
+    template <typename T>
+    class BoundedQueue
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "BoundedQueue stores values by copy");
+
+    public:
+        using ValueType = T;
+
+        explicit BoundedQueue(std::size_t capacity)
+        {
+            std::size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            m_mask = size - 1;
+            m_cells.reset(new Cell[size]);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // false - очередь заполнена
+        bool TryPush(const T& value)
+        {
+            std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell& cell = m_cells[pos & m_mask];
+                std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = value;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // false - очередь пуста
+        bool TryPop(T& value)
+        {
+            std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell& cell = m_cells[pos & m_mask];
+                std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        value = cell.value;
+                        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Приблизительное число элементов: при одновременных операциях может отставать
+        std::size_t SizeApprox() const
+        {
+            std::size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+            std::size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+            return enqueued > dequeued ? enqueued - dequeued : 0;
+        }
+
+        std::size_t Capacity() const { return m_mask + 1; }
+
+    private:
+        static constexpr std::size_t CacheLine = 64;
+
+        struct alignas(CacheLine) Cell
+        {
+            std::atomic<std::size_t> sequence{ 0 };
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        std::size_t m_mask = 0;
+        // Позиции записи и чтения на разных линиях кэша, чтобы писатель и читатель не мешали друг другу
+        alignas(CacheLine) std::atomic<std::size_t> m_enqueuePos{ 0 };
+        alignas(CacheLine) std::atomic<std::size_t> m_dequeuePos{ 0 };
+    };
+}
@@ -0,0 +1,562 @@
+#include "Endgame.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <limits>
+#include <numeric>
+
+namespace SeaBattle
+{
+    namespace
+    {
+        constexpr int Rows = ShotBoard::ROWS;
+        constexpr int Cols = ShotBoard::COLS;
+        constexpr int Cells = Rows * Cols;
+        constexpr int CellStates = static_cast<int>(CellState::Destroyed) + 1;
+
+        constexpr std::uint64_t splitmix64(std::uint64_t x)
+        {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        // Ключи фиксированы: записи таблицы не зависят от запуска
+        constexpr auto MakeZobristKeys()
+        {
+            std::array<std::array<std::uint64_t, CellStates>, Cells> keys{};
+            std::uint64_t seed = 0x5EAB477E5EAB477Eull;
+            for (auto& cell : keys)
+            {
+                for (auto& key : cell)
+                {
+                    seed = splitmix64(seed);
+                    key = seed;
+                }
+            }
+            return keys;
+        }
+
+        constexpr auto g_zobristKeys = MakeZobristKeys();
+
+        std::uint64_t zobristKey(int cell, CellState state)
+        {
+            return g_zobristKeys[static_cast<std::size_t>(cell)][static_cast<std::size_t>(state)];
+        }
+
+
+        // Положение корабля: его клетки и клетки вместе с ореолом, куда нельзя ставить другие корабли
+        struct Placement
+        {
+            BoardMask cells;
+            BoardMask zone;
+        };
+
+        template <typename F>
+        void forEachCell(const BoardMask& mask, F&& f)
+        {
+            for (int word = 0; word < 2; ++word)
+            {
+                for (std::uint64_t bits = mask.words[static_cast<std::size_t>(word)]; bits != 0; bits &= bits - 1)
+                {
+                    f(word * 64 + std::countr_zero(bits));
+                }
+            }
+        }
+
+        // Ключ клеток кораблей. Корабли не касаются, поэтому клетки раскладки однозначно
+        // задают её корабли; перемешивание делает XOR ключей раскладок ключом их множества
+        std::uint64_t shipsKey(const BoardMask& cells)
+        {
+            std::uint64_t key = 0;
+            forEachCell(cells, [&](int cell) { key ^= zobristKey(cell, CellState::Ship); });
+            return splitmix64(key);
+        }
+
+        // Отрезки [first, last) раскладок с одинаковым ключом позиции
+        template <typename F>
+        void forEachGroup(const std::vector<std::pair<std::uint64_t, std::uint32_t>>& keys, F&& f)
+        {
+            for (std::size_t first = 0; first < keys.size();)
+            {
+                std::size_t last = first + 1;
+                while (last < keys.size() && keys[last].first == keys[first].first)
+                {
+                    ++last;
+                }
+                f(first, last);
+                first = last;
+            }
+        }
+
+        int countCells(const BoardMask& mask)
+        {
+            return std::popcount(mask.words[0]) + std::popcount(mask.words[1]);
+        }
+
+        // Все положения корабля size, не противоречащие полю: клетки не стреляны или подбиты,
+        // и корабль не касается потопленных
+        std::vector<Placement> placementsOf(const ShotBoard& board, const BoardMask& destroyed, int size)
+        {
+            std::vector<Placement> placements;
+            for (int vertical = 0; vertical < (size > 1 ? 2 : 1); ++vertical)
+            {
+                for (int row = 0; row + (vertical ? size - 1 : 0) < Rows; ++row)
+                {
+                    for (int col = 0; col + (vertical ? 0 : size - 1) < Cols; ++col)
+                    {
+                        Placement placement;
+                        bool fits = true;
+                        for (int i = 0; i < size && fits; ++i)
+                        {
+                            const int r = vertical ? row + i : row;
+                            const int c = vertical ? col : col + i;
+                            const CellState state = board.at(r, c);
+                            fits = state == CellState::Empty || state == CellState::Hit;
+                            placement.cells.set(r * Cols + c);
+                            for (int dr = -1; dr <= 1; ++dr)
+                            {
+                                for (int dc = -1; dc <= 1; ++dc)
+                                {
+                                    if (GameField::isValidCoordinate(r + dr, c + dc))
+                                    {
+                                        placement.zone.set((r + dr) * Cols + c + dc);
+                                    }
+                                }
+                            }
+                        }
+                        if (fits && !placement.zone.intersects(destroyed))
+                        {
+                            placements.push_back(placement);
+                        }
+                    }
+                }
+            }
+            return placements;
+        }
+
+        // Перебор раскладок в глубину. Корабли одного размера ставятся по возрастанию номера
+        // положения, чтобы каждая раскладка встретилась один раз
+        struct LayoutSearch
+        {
+            std::vector<const std::vector<Placement>*> placements;  // по кораблям
+            std::vector<int> sizes;
+            BoardMask hits;
+            std::size_t maxLayouts = 0;
+            std::uint64_t maxNodes = 0;
+
+            std::uint64_t nodes = 0;
+            std::vector<std::size_t> chosen;
+            std::vector<BoardMask>* ships = nullptr;
+            std::vector<BoardMask>* unions = nullptr;
+            std::vector<std::uint64_t>* layoutKeys = nullptr;
+
+            // false - раскладок или узлов больше пределов
+            bool place(std::size_t ship, std::size_t first, const BoardMask& taken, const BoardMask& covered, int capacity)
+            {
+                if (++nodes > maxNodes)
+                {
+                    return false;
+                }
+                // Непокрытые попадания должны поместиться в оставшиеся корабли
+                if (countCells(hits & ~covered) > capacity)
+                {
+                    return true;
+                }
+                if (ship == sizes.size())
+                {
+                    if (unions->size() == maxLayouts)
+                    {
+                        return false;
+                    }
+                    for (std::size_t s = 0; s < sizes.size(); ++s)
+                    {
+                        ships->push_back((*placements[s])[chosen[s]].cells);
+                    }
+                    unions->push_back(covered);
+                    layoutKeys->push_back(shipsKey(covered));
+                    return true;
+                }
+
+                const auto& options = *placements[ship];
+                for (std::size_t p = first; p < options.size(); ++p)
+                {
+                    if (options[p].cells.intersects(taken))
+                    {
+                        continue;
+                    }
+                    chosen[ship] = p;
+                    const bool sameNext = ship + 1 < sizes.size() && sizes[ship + 1] == sizes[ship];
+                    if (!place(ship + 1, sameNext ? p + 1 : 0, taken | options[p].zone, covered | options[p].cells,
+                        capacity - sizes[ship]))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+        constexpr std::uint64_t DataPresent = std::uint64_t{ 1 } << 63;
+
+        std::uint64_t packEntry(TranspositionTable::Entry entry, std::uint8_t generation, std::uint8_t work)
+        {
+            return DataPresent
+                | std::bit_cast<std::uint32_t>(entry.value)
+                | static_cast<std::uint64_t>(static_cast<std::uint8_t>(entry.cell + 1)) << 32
+                | static_cast<std::uint64_t>(generation) << 40
+                | static_cast<std::uint64_t>(work) << 48;
+        }
+
+        TranspositionTable::Entry unpackEntry(std::uint64_t data)
+        {
+            return { std::bit_cast<float>(static_cast<std::uint32_t>(data)), static_cast<int>((data >> 32) & 0xFF) - 1 };
+        }
+    }
+
+    TranspositionTable::TranspositionTable(std::size_t bytes)
+    {
+        const std::size_t buckets = std::bit_floor(std::max<std::size_t>(bytes / sizeof(Bucket), 1));
+        m_buckets = std::make_unique<Bucket[]>(buckets);
+        m_mask = buckets - 1;
+    }
+
+    std::optional<TranspositionTable::Entry> TranspositionTable::Probe(std::uint64_t key) const
+    {
+        const Bucket& bucket = m_buckets[key & m_mask];
+        for (const Slot& slot : bucket.slots)
+        {
+            const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+            const std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+            if (data != 0 && (check ^ data) == key)
+            {
+                return unpackEntry(data);
+            }
+        }
+        return std::nullopt;
+    }
+
+    void TranspositionTable::Store(std::uint64_t key, Entry entry, std::uint64_t work)
+    {
+        const std::uint8_t generation = m_generation.load(std::memory_order_relaxed);
+        Bucket& bucket = m_buckets[key & m_mask];
+
+        // Та же позиция, иначе пустая запись, иначе самая старая и дешёвая
+        Slot* victim = nullptr;
+        int victimScore = std::numeric_limits<int>::max();
+        for (Slot& slot : bucket.slots)
+        {
+            const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+            const std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+            if (data == 0 || (check ^ data) == key)
+            {
+                victim = &slot;
+                break;
+            }
+            const auto age = static_cast<std::uint8_t>(generation - static_cast<std::uint8_t>(data >> 40));
+            const int score = (age == 0 ? 256 : 0) + static_cast<int>((data >> 48) & 0xFF);
+            if (score < victimScore)
+            {
+                victim = &slot;
+                victimScore = score;
+            }
+        }
+
+        const auto workBits = static_cast<std::uint8_t>(std::bit_width(work));
+        const std::uint64_t data = packEntry(entry, generation, workBits);
+        victim->data.store(data, std::memory_order_relaxed);
+        victim->check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    EndgameSolver::EndgameSolver(TranspositionTable& table, EndgameLimits limits)
+        : m_table(table)
+        , m_limits(limits)
+        , m_groups(Cells + 1)
+        , m_keys(Cells + 1)
+    {
+    }
+
+    std::optional<Position> EndgameSolver::Solve(const ShotBoard& board)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!enumerate(board))
+        {
+            ++m_stats.declined;
+            return std::nullopt;
+        }
+
+        BoardMask shot;
+        for (int cell = 0; cell < Cells; ++cell)
+        {
+            if (board.cells[static_cast<std::size_t>(cell)] != CellState::Empty)
+            {
+                shot.set(cell);
+            }
+        }
+
+        std::vector<std::uint32_t> layouts(m_unions.size());
+        std::iota(layouts.begin(), layouts.end(), 0u);
+        m_table.NewSearch();
+        m_searchNodes = 0;
+        int cell = -1;
+        try
+        {
+            m_expected = solve(positionKey(shot, layouts), shot, layouts, 0, &cell);
+        }
+        catch (const Aborted&)
+        {
+            ++m_stats.aborted;
+            m_stats.nodes += m_searchNodes;
+            return std::nullopt;
+        }
+
+        if (cell < 0)
+        {
+            // Раскладка одна - добиваем её по порядку
+            forEachCell(m_unions[0] & ~shot, [&](int c) { cell = cell < 0 ? c : cell; });
+        }
+        ++m_stats.solves;
+        m_stats.layouts += m_unions.size();
+        m_stats.nodes += m_searchNodes;
+        m_stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return Position{ static_cast<std::int8_t>(cell / Cols), static_cast<std::int8_t>(cell % Cols) };
+    }
+
+    bool EndgameSolver::enumerate(const ShotBoard& board)
+    {
+        const auto sizes = RemainingShips(board);
+        if (sizes.empty())
+        {
+            return false;
+        }
+
+        BoardMask hits;
+        BoardMask destroyed;
+        for (int cell = 0; cell < Cells; ++cell)
+        {
+            const CellState state = board.cells[static_cast<std::size_t>(cell)];
+            if (state == CellState::Hit)
+            {
+                hits.set(cell);
+            }
+            else if (state == CellState::Destroyed)
+            {
+                destroyed.set(cell);
+            }
+        }
+
+        std::array<std::vector<Placement>, MaxShipSize + 1> placements;
+        LayoutSearch search;
+        search.hits = hits;
+        search.maxLayouts = m_limits.maxLayouts;
+        // Тупиковых ветвей (попадания не покрыты) бывает намного больше, чем раскладок
+        search.maxNodes = m_limits.maxLayouts * 1000;
+        int capacity = 0;
+        for (int size : sizes)
+        {
+            if (placements[static_cast<std::size_t>(size)].empty())
+            {
+                placements[static_cast<std::size_t>(size)] = placementsOf(board, destroyed, size);
+            }
+            search.placements.push_back(&placements[static_cast<std::size_t>(size)]);
+            search.sizes.push_back(size);
+            capacity += size;
+        }
+        search.chosen.resize(sizes.size());
+
+        m_shipCount = static_cast<int>(sizes.size());
+        m_ships.clear();
+        m_unions.clear();
+        search.ships = &m_ships;
+        search.unions = &m_unions;
+        m_layoutKeys.clear();
+        search.layoutKeys = &m_layoutKeys;
+        return search.place(0, 0, BoardMask{}, BoardMask{}, capacity) && !m_unions.empty();
+    }
+
+    double EndgameSolver::solve(std::uint64_t key, const BoardMask& shot, std::span<const std::uint32_t> layouts, int depth, int* bestCell)
+    {
+        // Раскладка известна - остались только попадания
+        if (layouts.size() <= 1)
+        {
+            return 0.0;
+        }
+
+        ++m_stats.probes;
+        if (auto entry = m_table.Probe(key))
+        {
+            ++m_stats.hits;
+            if (bestCell)
+            {
+                *bestCell = entry->cell;
+            }
+            return entry->value;
+        }
+        if (++m_searchNodes > m_limits.maxNodes)
+        {
+            throw Aborted{};
+        }
+        const std::uint64_t nodesBefore = m_searchNodes;
+
+        // Сколько раскладок занимает каждую нестрелянную клетку
+        std::array<std::uint32_t, Cells> counts{};
+        for (std::uint32_t layout : layouts)
+        {
+            forEachCell(m_unions[layout] & ~shot, [&](int cell) { ++counts[static_cast<std::size_t>(cell)]; });
+        }
+
+        // Клетка, занятая во всех раскладках, - попадание без риска: стрелять её сразу не хуже
+        // любого другого порядка. Иначе пробуем клетки, начиная с самых вероятных
+        const auto total = static_cast<std::uint32_t>(layouts.size());
+        StaticVector<std::uint8_t, Cells> candidates;
+        for (int cell = 0; cell < Cells; ++cell)
+        {
+            const std::uint32_t count = counts[static_cast<std::size_t>(cell)];
+            if (count == total)
+            {
+                candidates.clear();
+                candidates.push_back(static_cast<std::uint8_t>(cell));
+                break;
+            }
+            if (count != 0)
+            {
+                candidates.push_back(static_cast<std::uint8_t>(cell));
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [&](std::uint8_t a, std::uint8_t b) { return counts[a] > counts[b]; });
+
+        auto& keys = m_keys[static_cast<std::size_t>(depth)];
+        auto& groups = m_groups[static_cast<std::size_t>(depth)];
+
+        // Оценка снизу каждого выстрела: доля промаха плюс оценки групп исходов.
+        // Выстрелы перебираются от меньшей оценки; как только она не лучше найденного, перебор кончен
+        StaticVector<std::pair<double, std::uint8_t>, Cells> ordered;
+        for (std::uint8_t cell : candidates)
+        {
+            BoardMask after = shot;
+            after.set(cell);
+            partition(after, cell, layouts, depth);
+            double bound = static_cast<double>(total - counts[cell]) / total;
+            forEachGroup(keys, [&](std::size_t first, std::size_t last) {
+                bound += static_cast<double>(last - first) / total * lowerBound(after, std::span(groups.data() + first, last - first));
+                });
+            ordered.push_back({ bound, cell });
+        }
+        std::stable_sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        double best = std::numeric_limits<double>::infinity();
+        int bestShot = -1;
+        for (const auto& [bound, cell] : ordered)
+        {
+            if (bound >= best)
+            {
+                break;
+            }
+
+            BoardMask after = shot;
+            after.set(cell);
+            partition(after, cell, layouts, depth);
+            double value = static_cast<double>(total - counts[cell]) / total;
+            // Оценка ещё не посчитанных групп: перебор выстрела прекращается, когда даже с ней
+            // он не лучше найденного
+            double rest = bound - value;
+            forEachGroup(keys, [&](std::size_t first, std::size_t last) {
+                if (value + rest >= best)
+                {
+                    return;
+                }
+                const std::span<const std::uint32_t> group(groups.data() + first, last - first);
+                const double share = static_cast<double>(last - first) / total;
+                rest -= share * lowerBound(after, group);
+                value += share * solve(positionKey(after, group), after, group, depth + 1, nullptr);
+                });
+            if (value + rest < best)
+            {
+                best = value;
+                bestShot = cell;
+            }
+        }
+
+        // Значение округляется так же, как хранится в таблице: выбор выстрела не зависит от того,
+        // пришла оценка из таблицы или посчитана заново
+        const auto rounded = static_cast<float>(best);
+        m_table.Store(key, { rounded, bestShot }, m_searchNodes - nodesBefore + 1);
+        if (bestCell)
+        {
+            *bestCell = bestShot;
+        }
+        return rounded;
+    }
+
+    void EndgameSolver::partition(const BoardMask& after, int cell, std::span<const std::uint32_t> layouts, int depth)
+    {
+        // Исход выстрела в каждой раскладке: промах (0), попадание (1) или потопление корабля
+        // с этой клеткой (ключ корабля). Раскладки с одинаковым исходом дальше идут вместе
+        auto& keys = m_keys[static_cast<std::size_t>(depth)];
+        auto& groups = m_groups[static_cast<std::size_t>(depth)];
+        keys.resize(layouts.size());
+        groups.resize(layouts.size());
+        for (std::size_t i = 0; i < layouts.size(); ++i)
+        {
+            const std::uint32_t layout = layouts[i];
+            std::uint64_t outcome = 0;
+            if (m_unions[layout].test(cell))
+            {
+                outcome = 1;
+                for (int s = 0; s < m_shipCount; ++s)
+                {
+                    const BoardMask& ship = m_ships[static_cast<std::size_t>(layout) * static_cast<std::size_t>(m_shipCount) + static_cast<std::size_t>(s)];
+                    if (ship.test(cell) && ship.within(after))
+                    {
+                        outcome = shipsKey(ship);
+                        break;
+                    }
+                }
+            }
+            keys[i] = { outcome, layout };
+        }
+        // Сортировка раскладок по исходу: группы становятся отрезками
+        std::sort(keys.begin(), keys.end());
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            groups[i] = keys[i].second;
+        }
+    }
+
+    std::uint64_t EndgameSolver::positionKey(const BoardMask& shot, std::span<const std::uint32_t> layouts) const
+    {
+        // Оценка зависит только от множества раскладок и от того, какие их клетки уже подбиты;
+        // промахи мимо всех раскладок на неё не влияют. Поэтому разные последовательности
+        // выстрелов, оставившие те же раскладки, - одна запись таблицы
+        std::uint64_t key = 0;
+        BoardMask cells;
+        for (std::uint32_t layout : layouts)
+        {
+            key ^= m_layoutKeys[layout];
+            cells |= m_unions[layout];
+        }
+        forEachCell(cells & shot, [&](int cell) { key ^= zobristKey(cell, CellState::Hit); });
+        return key;
+    }
+
+    double EndgameSolver::lowerBound(const BoardMask& shot, std::span<const std::uint32_t> layouts) const
+    {
+        // Если ни одна клетка не занята во всех раскладках, первый же выстрел промахивается
+        // с вероятностью не меньше 1 - (самая занятая клетка) / (раскладок)
+        if (layouts.size() <= 1)
+        {
+            return 0.0;
+        }
+        std::array<std::uint32_t, Cells> counts{};
+        std::uint32_t most = 0;
+        for (std::uint32_t layout : layouts)
+        {
+            forEachCell(m_unions[layout] & ~shot, [&](int cell) {
+                most = std::max(most, ++counts[static_cast<std::size_t>(cell)]);
+                });
+        }
+        return 1.0 - static_cast<double>(most) / static_cast<double>(layouts.size());
+    }
+}
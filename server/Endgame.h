@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Strategy.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace SeaBattle
+{
+    // Клетки классического поля битами: клетка row * COLS + col - бит (cell % 64) слова cell / 64
+    struct BoardMask
+    {
+        std::array<std::uint64_t, 2> words{};
+
+        void set(int cell) { words[static_cast<std::size_t>(cell / 64)] |= std::uint64_t{ 1 } << (cell % 64); }
+        bool test(int cell) const { return (words[static_cast<std::size_t>(cell / 64)] >> (cell % 64)) & 1; }
+        bool empty() const { return (words[0] | words[1]) == 0; }
+        bool intersects(const BoardMask& other) const { return ((words[0] & other.words[0]) | (words[1] & other.words[1])) != 0; }
+        // Все клетки this лежат в other
+        bool within(const BoardMask& other) const { return ((words[0] & ~other.words[0]) | (words[1] & ~other.words[1])) == 0; }
+
+        BoardMask& operator|=(const BoardMask& other)
+        {
+            words[0] |= other.words[0];
+            words[1] |= other.words[1];
+            return *this;
+        }
+        BoardMask operator|(const BoardMask& other) const { return BoardMask(*this) |= other; }
+        BoardMask operator&(const BoardMask& other) const { return { { words[0] & other.words[0], words[1] & other.words[1] } }; }
+        BoardMask operator~() const { return { { ~words[0], ~words[1] } }; }
+    };
+
+    // Таблица транспозиций, общая для потоков: фиксированный объём, корзины по четыре
+    // записи в одной кэш-линии, без блокировок. Запись - два атомарных слова, в первом
+    // ключ XOR данные: запись, разорванная параллельным Store, просто не найдётся.
+    // Поколение растёт с каждым поиском; при вытеснении старые записи уходят первыми,
+    // среди записей одного поколения - самые дешёвые для повторного счёта.
+    class TranspositionTable
+    {
+    public:
+        struct Entry
+        {
+            float value = 0.0f;
+            int cell = -1;
+        };
+
+        // bytes округляется вниз до степени двойки корзин, не меньше одной
+        explicit TranspositionTable(std::size_t bytes);
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        void NewSearch() { m_generation.fetch_add(1, std::memory_order_relaxed); }
+
+        std::optional<Entry> Probe(std::uint64_t key) const;
+        // work - сколько узлов стоил расчёт; дорогие записи вытесняются последними
+        void Store(std::uint64_t key, Entry entry, std::uint64_t work);
+
+        std::size_t Capacity() const { return (m_mask + 1) * SlotsPerBucket; }
+        std::size_t Bytes() const { return (m_mask + 1) * sizeof(Bucket); }
+
+    private:
+        static constexpr int SlotsPerBucket = 4;
+
+        struct Slot
+        {
+            std::atomic<std::uint64_t> check{ 0 };  // ключ XOR data
+            std::atomic<std::uint64_t> data{ 0 };
+        };
+
+        struct alignas(64) Bucket
+        {
+            Slot slots[SlotsPerBucket];
+        };
+
+        std::unique_ptr<Bucket[]> m_buckets;
+        std::size_t m_mask = 0;
+        std::atomic<std::uint8_t> m_generation{ 1 };
+    };
+
+    struct EndgameLimits
+    {
+        // Решатель берётся за позицию, только если раскладок оставшихся кораблей не больше
+        std::size_t maxLayouts = 20;
+        // Предел узлов перебора на один выстрел; при превышении выстрел выбирает эвристика
+        std::uint64_t maxNodes = 10000;
+    };
+
+    struct EndgameStats
+    {
+        std::uint64_t solves = 0;       // позиций решено точно
+        std::uint64_t declined = 0;     // раскладок оказалось слишком много
+        std::uint64_t aborted = 0;      // превышен предел узлов
+        std::uint64_t layouts = 0;      // раскладок перебрано во всех решённых позициях
+        std::uint64_t nodes = 0;        // позиций, посчитанных перебором
+        std::uint64_t probes = 0;
+        std::uint64_t hits = 0;         // probes, найденные в таблице
+        double seconds = 0.0;
+    };
+
+    // Точный эндшпиль: перебирает все раскладки оставшихся кораблей, согласные с полем,
+    // и выбирает выстрел с наименьшим ожидаемым числом промахов до конца партии (при
+    // равновероятных раскладках). Попаданий до конца одинаково при любом порядке выстрелов,
+    // поэтому минимум промахов - это минимум оставшихся выстрелов.
+    class EndgameSolver
+    {
+    public:
+        explicit EndgameSolver(TranspositionTable& table, EndgameLimits limits = {});
+
+        // Лучший выстрел или nullopt, если позиция не по силам решателю
+        std::optional<Position> Solve(const ShotBoard& board);
+
+        // Ожидаемое число промахов после последнего удачного Solve
+        double ExpectedMisses() const { return m_expected; }
+        const EndgameStats& Stats() const { return m_stats; }
+
+    private:
+        struct Aborted
+        {
+        };
+
+        bool enumerate(const ShotBoard& board);
+        // Раскладки по исходам выстрела в cell: m_keys и m_groups уровня depth
+        void partition(const BoardMask& after, int cell, std::span<const std::uint32_t> layouts, int depth);
+        // Ключ Зобриста позиции перебора для таблицы транспозиций
+        std::uint64_t positionKey(const BoardMask& shot, std::span<const std::uint32_t> layouts) const;
+        double lowerBound(const BoardMask& shot, std::span<const std::uint32_t> layouts) const;
+        double solve(std::uint64_t key, const BoardMask& shot, std::span<const std::uint32_t> layouts, int depth, int* bestCell);
+
+        TranspositionTable& m_table;
+        EndgameLimits m_limits;
+        EndgameStats m_stats;
+        double m_expected = 0.0;
+
+        // Раскладки позиции: m_ships[i * m_shipCount + s] - клетки корабля s раскладки i
+        int m_shipCount = 0;
+        std::vector<BoardMask> m_ships;
+        std::vector<BoardMask> m_unions;
+        std::vector<std::uint64_t> m_layoutKeys;
+        std::uint64_t m_searchNodes = 0;
+        // Буферы перебора по глубине: раскладки групп исходов и их ключи
+        std::vector<std::vector<std::uint32_t>> m_groups;
+        std::vector<std::vector<std::pair<std::uint64_t, std::uint32_t>>> m_keys;
+    };
+}
@@ -0,0 +1,179 @@
+#include "FleetPool.h"
+
+#include <chrono>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace SeaBattle
+{
+    namespace
+    {
+        template <typename R>
+        using QueuePtr = std::unique_ptr<BoundedQueue<BasicGameField<R>>>;
+
+        // Фоновое заполнение не должно отнимать процессор у обработки ходов
+        void lowerThreadPriority()
+        {
+#ifdef __linux__
+            sched_param param{};
+            pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+        }
+    }
+
+    FleetPool::FleetPool(GameMode mode, std::size_t capacity)
+        : m_mode(mode)
+    {
+        if (capacity == 0)
+        {
+            return;
+        }
+
+        switch (mode)
+        {
+        case GameMode::Blitz:
+            m_queue = std::make_unique<BoundedQueue<BasicGameField<BlitzRules>>>(capacity);
+            break;
+        case GameMode::Large:
+            m_queue = std::make_unique<BoundedQueue<BasicGameField<LargeRules>>>(capacity);
+            break;
+        case GameMode::Touching:
+            m_queue = std::make_unique<BoundedQueue<BasicGameField<TouchingRules>>>(capacity);
+            break;
+        case GameMode::Salvo:
+            m_queue = std::make_unique<BoundedQueue<BasicGameField<SalvoRules>>>(capacity);
+            break;
+        case GameMode::Classic:
+        default:
+            m_queue = std::make_unique<BoundedQueue<BasicGameField<ClassicRules>>>(capacity);
+            break;
+        }
+    }
+
+    FleetPool::~FleetPool()
+    {
+        Stop();
+    }
+
+    void FleetPool::Start()
+    {
+        if (std::holds_alternative<std::monostate>(m_queue) || m_worker.joinable())
+        {
+            return;
+        }
+        m_stopping.store(false);
+        m_worker = std::thread([this]() { run(); });
+    }
+
+    void FleetPool::Stop()
+    {
+        if (!m_worker.joinable())
+        {
+            return;
+        }
+        m_stopping.store(true);
+        m_wakeups.fetch_add(1, std::memory_order_release);
+        m_wakeups.notify_one();
+        m_worker.join();
+    }
+
+    void FleetPool::Fill()
+    {
+        std::mt19937 gen{ std::random_device{}() };
+        refill(gen);
+    }
+
+    bool FleetPool::refill(std::mt19937& gen)
+    {
+        return std::visit(
+            [this, &gen](auto& queue) -> bool
+            {
+                if constexpr (std::is_same_v<std::decay_t<decltype(queue)>, std::monostate>)
+                {
+                    return true;
+                }
+                else
+                {
+                    using R = typename std::decay_t<decltype(*queue)>::ValueType::RulesType;
+                    auto start = std::chrono::steady_clock::now();
+                    std::uint64_t generated = 0;
+                    bool running = true;
+                    while (queue->SizeApprox() < queue->Capacity())
+                    {
+                        if (m_stopping.load(std::memory_order_relaxed))
+                        {
+                            running = false;
+                            break;
+                        }
+                        if (!queue->TryPush(MakeFleet<R>(gen)))
+                        {
+                            break;
+                        }
+                        ++generated;
+                    }
+                    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                    m_generated.fetch_add(generated, std::memory_order_relaxed);
+                    m_refillNs.fetch_add(static_cast<std::uint64_t>(elapsed.count()), std::memory_order_relaxed);
+                    return running;
+                }
+            },
+            m_queue);
+    }
+
+    void FleetPool::run()
+    {
+        lowerThreadPriority();
+        std::mt19937 gen{ std::random_device{}() };
+
+        while (!m_stopping.load())
+        {
+            std::uint32_t seen = m_wakeups.load(std::memory_order_acquire);
+            if (!refill(gen))
+            {
+                break;
+            }
+
+            // Засыпаем до сигнала от Take; сигнал, пришедший после чтения seen, не теряется
+            m_sleeping.store(true);
+            if (!m_stopping.load())
+            {
+                m_wakeups.wait(seen, std::memory_order_acquire);
+            }
+            m_sleeping.store(false);
+        }
+    }
+
+    void FleetPool::wake()
+    {
+        if (m_sleeping.load())
+        {
+            m_wakeups.fetch_add(1, std::memory_order_release);
+            m_wakeups.notify_one();
+        }
+    }
+
+    FleetPoolStats FleetPool::Stats() const
+    {
+        FleetPoolStats stats;
+        stats.mode = m_mode;
+        std::visit(
+            [&stats](const auto& queue)
+            {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(queue)>, std::monostate>)
+                {
+                    stats.depth = queue->SizeApprox();
+                    stats.capacity = queue->Capacity();
+                }
+            },
+            m_queue);
+        stats.generated = m_generated.load(std::memory_order_relaxed);
+        stats.taken = m_taken.load(std::memory_order_relaxed);
+        stats.misses = m_misses.load(std::memory_order_relaxed);
+        std::uint64_t refillNs = m_refillNs.load(std::memory_order_relaxed);
+        stats.refillRate = refillNs == 0 ? 0.0 : static_cast<double>(stats.generated) * 1e9 / static_cast<double>(refillNs);
+        return stats;
+    }
+}
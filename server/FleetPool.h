@@ -0,0 +1,125 @@
+#pragma once
+
+#include "BoundedQueue.h"
+#include "GameModel.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <variant>
+
+namespace SeaBattle
+{
+    struct FleetPoolStats
+    {
+        GameMode mode = GameMode::Classic;
+        std::size_t depth = 0;          // готовых расстановок сейчас
+        std::size_t capacity = 0;
+        std::uint64_t generated = 0;    // расставлено фоновым потоком
+        std::uint64_t taken = 0;        // выдано из пула
+        std::uint64_t misses = 0;       // пул был пуст - расставили на месте
+        double refillRate = 0.0;        // расстановок в секунду, пока фоновый поток работает
+    };
+
+    // Запас готовых расстановок флота для одного варианта игры. Фоновый поток с низким
+    // приоритетом дополняет пул, когда он опускается ниже половины; начало партии
+    // забирает две расстановки без блокировок. Если пул пуст, расстановка делается на месте.
+    class FleetPool
+    {
+    public:
+        // capacity == 0 - пул выключен, каждая расстановка делается на месте
+        FleetPool(GameMode mode, std::size_t capacity);
+        ~FleetPool();
+
+        FleetPool(const FleetPool&) = delete;
+        FleetPool& operator=(const FleetPool&) = delete;
+
+        // Запускает фоновое заполнение; до этого пул пуст
+        void Start();
+        void Stop();
+
+        // Заполняет пул в текущем потоке (например, до приёма подключений)
+        void Fill();
+
+        template <typename R>
+        BasicGameField<R> Take();
+
+        FleetPoolStats Stats() const;
+
+        // Случайная расстановка с проверкой полноты флота; бросает std::runtime_error, если не вышло
+        template <typename R>
+        static BasicGameField<R> MakeFleet(std::mt19937& gen);
+
+    private:
+        template <typename R>
+        using FieldQueue = BoundedQueue<BasicGameField<R>>;
+
+        using AnyFieldQueue = std::variant<
+            std::monostate,
+            std::unique_ptr<FieldQueue<ClassicRules>>,
+            std::unique_ptr<FieldQueue<BlitzRules>>,
+            std::unique_ptr<FieldQueue<LargeRules>>,
+            std::unique_ptr<FieldQueue<TouchingRules>>,
+            std::unique_ptr<FieldQueue<SalvoRules>>>;
+
+        void run();
+        // Дополняет пул до ёмкости; false - остановка
+        bool refill(std::mt19937& gen);
+        // Будит фоновый поток, только если он спит: иначе каждое взятие стоило бы системного вызова
+        void wake();
+
+        GameMode m_mode;
+        AnyFieldQueue m_queue;
+        std::thread m_worker;
+        std::atomic<bool> m_stopping{ false };
+        std::atomic<bool> m_sleeping{ false };
+        std::atomic<std::uint32_t> m_wakeups{ 0 };
+
+        std::atomic<std::uint64_t> m_generated{ 0 };
+        std::atomic<std::uint64_t> m_taken{ 0 };
+        std::atomic<std::uint64_t> m_misses{ 0 };
+        std::atomic<std::uint64_t> m_refillNs{ 0 };
+    };
+
+    template <typename R>
+    BasicGameField<R> FleetPool::MakeFleet(std::mt19937& gen)
+    {
+        // Жадная расстановка изредка упирается в тупик - тогда начинаем заново
+        constexpr int maxAttempts = 100;
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            BasicGameField<R> field;
+            if (BasicShipPlacer<R>::autoPlaceShips(field, gen) && field.getShips().size() == static_cast<std::size_t>(R::FleetSize))
+            {
+                return field;
+            }
+        }
+        throw std::runtime_error("Failed to place ships");
+    }
+
+    template <typename R>
+    BasicGameField<R> FleetPool::Take()
+    {
+        if (auto* queue = std::get_if<std::unique_ptr<FieldQueue<R>>>(&m_queue))
+        {
+            BasicGameField<R> field;
+            if ((*queue)->TryPop(field))
+            {
+                m_taken.fetch_add(1, std::memory_order_relaxed);
+                if ((*queue)->SizeApprox() < (*queue)->Capacity() / 2)
+                {
+                    wake();
+                }
+                return field;
+            }
+            wake();
+        }
+
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        thread_local std::mt19937 gen{ std::random_device{}() };
+        return MakeFleet<R>(gen);
+    }
+}
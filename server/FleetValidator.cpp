@@ -0,0 +1,115 @@
+#include "FleetValidator.h"
+
+#include <array>
+
+namespace SeaBattle
+{
+    namespace
+    {
+        // Сколько кораблей каждого размера требуют правила
+        template <typename R>
+        constexpr std::array<int, MaxShipSize + 1> FleetComposition()
+        {
+            std::array<int, MaxShipSize + 1> counts{};
+            for (ShipType type : R::Fleet)
+            {
+                ++counts[static_cast<int>(type)];
+            }
+            return counts;
+        }
+    }
+
+    template <typename R>
+    const std::vector<typename BasicFleetValidator<R>::Masks>& BasicFleetValidator<R>::table()
+    {
+        static const std::vector<Masks> masks = []()
+        {
+            std::vector<Masks> result(static_cast<std::size_t>(MaxShipSize) * 2 * R::Cells);
+            for (int size = 1; size <= MaxShipSize; ++size)
+            {
+                for (bool vertical : { false, true })
+                {
+                    for (int row = 0; row < R::Rows; ++row)
+                    {
+                        for (int col = 0; col < R::Cols; ++col)
+                        {
+                            ShipPlacement ship{ size, row, col, vertical };
+                            if (!Fits(ship))
+                            {
+                                continue;
+                            }
+                            Masks& entry = result[index(ship)];
+                            for (int i = 0; i < size; ++i)
+                            {
+                                int r = row + (vertical ? i : 0);
+                                int c = col + (vertical ? 0 : i);
+                                entry.occupancy.set(static_cast<std::size_t>(r * R::Cols + c));
+                                for (int dr = -1; dr <= 1; ++dr)
+                                {
+                                    for (int dc = -1; dc <= 1; ++dc)
+                                    {
+                                        int nr = r + dr;
+                                        int nc = c + dc;
+                                        if (nr >= 0 && nr < R::Rows && nc >= 0 && nc < R::Cols)
+                                        {
+                                            entry.halo.set(static_cast<std::size_t>(nr * R::Cols + nc));
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            return result;
+        }();
+        return masks;
+    }
+
+    template <typename R>
+    FleetError BasicFleetValidator<R>::Validate(std::span<const ShipPlacement> ships)
+    {
+        if (ships.size() != static_cast<std::size_t>(R::FleetSize))
+        {
+            return FleetError::WrongFleet;
+        }
+
+        const auto& masks = table();
+        auto remaining = FleetComposition<R>();
+        Board occupied;
+        Board forbidden; // клетки и ореолы уже проверенных кораблей
+        for (const auto& ship : ships)
+        {
+            if (ship.size < 1 || ship.size > MaxShipSize || --remaining[ship.size] < 0)
+            {
+                return FleetError::WrongFleet;
+            }
+            if (!Fits(ship))
+            {
+                return FleetError::OutOfBounds;
+            }
+
+            const Masks& entry = masks[index(ship)];
+            if ((entry.occupancy & occupied).any())
+            {
+                return FleetError::Overlap;
+            }
+            if constexpr (!R::ShipsMayTouch)
+            {
+                if ((entry.occupancy & forbidden).any())
+                {
+                    return FleetError::Touching;
+                }
+                forbidden |= entry.halo;
+            }
+            occupied |= entry.occupancy;
+        }
+        return FleetError::None;
+    }
+
+    template class BasicFleetValidator<ClassicRules>;
+    template class BasicFleetValidator<BlitzRules>;
+    template class BasicFleetValidator<LargeRules>;
+    template class BasicFleetValidator<TouchingRules>;
+    template class BasicFleetValidator<SalvoRules>;
+}
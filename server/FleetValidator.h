@@ -0,0 +1,61 @@
+#pragma once
+
+#include "GameModel.h"
+
+#include <bitset>
+#include <span>
+#include <vector>
+
+namespace SeaBattle
+{
+    // Проверка присланной клиентом расстановки. Для каждой возможной позиции корабля заранее
+    // посчитаны две битовые доски: его клетки и клетки вместе с соседними (ореол). Проверка
+    // корабля - пересечение с уже занятыми клетками и ореолами, без обхода соседей по клеткам.
+    template <typename R>
+    class BasicFleetValidator
+    {
+    public:
+        using Board = std::bitset<R::Cells>;
+
+        static FleetError Validate(std::span<const ShipPlacement> ships);
+
+        // Корабль целиком лежит на поле. Координаты приходят из JSON клиента как есть: сначала
+        // нос проверяется по границам поля, и только потом к нему прибавляется длина
+        static bool Fits(const ShipPlacement& ship)
+        {
+            if (ship.size < 1 || ship.size > MaxShipSize || ship.row < 0 || ship.row >= R::Rows
+                || ship.col < 0 || ship.col >= R::Cols)
+            {
+                return false;
+            }
+            int lastRow = ship.row + (ship.vertical ? ship.size - 1 : 0);
+            int lastCol = ship.col + (ship.vertical ? 0 : ship.size - 1);
+            return lastRow < R::Rows && lastCol < R::Cols;
+        }
+
+        // Маски позиции, для которой Fits() == true; ореол обрезан по краю поля
+        static const Board& Occupancy(const ShipPlacement& ship) { return table()[index(ship)].occupancy; }
+        static const Board& Halo(const ShipPlacement& ship) { return table()[index(ship)].halo; }
+
+    private:
+        struct Masks
+        {
+            Board occupancy;
+            Board halo;
+        };
+
+        static std::size_t index(const ShipPlacement& ship)
+        {
+            return ((static_cast<std::size_t>(ship.size - 1) * 2 + (ship.vertical ? 1 : 0)) * R::Cells)
+                + static_cast<std::size_t>(ship.row * R::Cols + ship.col);
+        }
+
+        static const std::vector<Masks>& table();
+    };
+
+    extern template class BasicFleetValidator<ClassicRules>;
+    extern template class BasicFleetValidator<BlitzRules>;
+    extern template class BasicFleetValidator<LargeRules>;
+    extern template class BasicFleetValidator<TouchingRules>;
+    extern template class BasicFleetValidator<SalvoRules>;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace SeaBattle
+{
+    struct FreeListStats
+    {
+        std::size_t blockSize = 0;
+        std::size_t free = 0;           // блоков ждёт выделения
+        std::uint64_t allocated = 0;    // выделено из кучи
+        std::uint64_t reused = 0;       // взято из списка
+    };
+
+    // Освобождённые блоки одного размера не возвращаются в кучу, а ждут следующего выделения.
+    // Размер блока задаёт первое выделение, блоки другого размера идут мимо списка; сверх
+    // maxFree блоки отдаются куче. Потокобезопасно: мьютекс берётся раз на объект
+    class FreeList
+    {
+    public:
+        explicit FreeList(std::size_t maxFree)
+            : m_maxFree(maxFree)
+        {
+            // Возврат блока в список не выделяет память
+            m_free.reserve(maxFree);
+        }
+
+        FreeList(const FreeList&) = delete;
+        FreeList& operator=(const FreeList&) = delete;
+
+        ~FreeList()
+        {
+            for (void* block : m_free)
+            {
+                ::operator delete(block);
+            }
+        }
+
+        void* Allocate(std::size_t size)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_blockSize == 0)
+                {
+                    m_blockSize = size;
+                }
+                if (size == m_blockSize && !m_free.empty())
+                {
+                    void* block = m_free.back();
+                    m_free.pop_back();
+                    ++m_reused;
+                    return block;
+                }
+                m_allocated += size == m_blockSize ? 1 : 0;
+            }
+            return ::operator new(size);
+        }
+
+        void Deallocate(void* block, std::size_t size) noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (size == m_blockSize && m_free.size() < m_maxFree)
+                {
+                    m_free.push_back(block);
+                    return;
+                }
+            }
+            ::operator delete(block);
+        }
+
+        FreeListStats Stats() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return { m_blockSize, m_free.size(), m_allocated, m_reused };
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<void*> m_free;
+        std::size_t m_maxFree;
+        std::size_t m_blockSize = 0;
+        std::uint64_t m_allocated = 0;
+        std::uint64_t m_reused = 0;
+    };
+
+    // Аллокатор для std::allocate_shared: объект вместе со счётчиком ссылок - один блок из FreeList
+    template <typename T>
+    class FreeListAllocator
+    {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "FreeList blocks use default new alignment");
+
+    public:
+        using value_type = T;
+
+        explicit FreeListAllocator(FreeList& list) noexcept
+            : m_list(&list)
+        {
+        }
+
+        template <typename U>
+        FreeListAllocator(const FreeListAllocator<U>& other) noexcept
+            : m_list(other.list())
+        {
+        }
+
+        T* allocate(std::size_t n) { return static_cast<T*>(m_list->Allocate(n * sizeof(T))); }
+        void deallocate(T* block, std::size_t n) noexcept { m_list->Deallocate(block, n * sizeof(T)); }
+
+        FreeList* list() const noexcept { return m_list; }
+
+        template <typename U>
+        bool operator==(const FreeListAllocator<U>& other) const noexcept { return m_list == other.list(); }
+
+    private:
+        FreeList* m_list;
+    };
+}
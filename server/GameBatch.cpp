@@ -0,0 +1,301 @@
+#include "GameBatch.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace SeaBattle
+{
+// GCC и Clang на x86-64 собирают ядро шага дважды, для AVX2 и для базового набора команд,
+// и выбирают вариант при запуске: без AVX2 (64-битные сравнения и сдвиги на разное число бит
+// в каждой партии) циклы по партиям не векторизуются. Остальные компиляторы - один вариант.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define SEABATTLE_BATCH_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define SEABATTLE_BATCH_KERNEL
+#endif
+
+    namespace
+    {
+        constexpr auto PlayingState = static_cast<std::uint8_t>(GameState::Playing);
+        constexpr auto GameOverState = static_cast<std::uint8_t>(GameState::GameOver);
+
+        // Массивы пачки в раскладке BasicGameBatch: [owner][word][game], [owner][ship][bound][game] и т.д.
+        struct StepArrays
+        {
+            const std::uint8_t* cells;
+            std::uint8_t* outcomes;
+            const std::uint64_t* ships;
+            std::uint64_t* shots;
+            std::uint64_t* hits;
+            const std::uint8_t* bounds;
+            std::uint8_t* health;
+            std::uint8_t* remaining;
+            std::uint8_t* current;
+            std::uint8_t* state;
+            std::int8_t* winner;
+            std::uint8_t* row;
+            std::uint8_t* col;
+            std::uint8_t* hit;
+            std::uint8_t* sunk;
+        };
+
+        // Здоровье кораблей поля owner: попадание в партии снимает палубу у корабля, в границы
+        // которого попала клетка. Только байтовые величины - 32 партии на AVX2-команду
+        template <int FleetSize>
+        inline void HitShips(int owner, const std::uint8_t* __restrict bounds, std::uint8_t* __restrict health,
+            const std::uint8_t* __restrict row, const std::uint8_t* __restrict col, const std::uint8_t* __restrict hit,
+            const std::uint8_t* __restrict current, std::uint8_t* __restrict sunk, std::size_t n)
+        {
+            for (int ship = 0; ship < FleetSize; ++ship)
+            {
+                const std::uint8_t* top = bounds + (static_cast<std::size_t>(ship) * 4) * n;
+                const std::uint8_t* left = top + n;
+                const std::uint8_t* height = left + n;
+                const std::uint8_t* width = height + n;
+                std::uint8_t* shipHealth = health + static_cast<std::size_t>(ship) * n;
+                for (std::size_t g = 0; g < n; ++g)
+                {
+                    // Беззнаковое вычитание: клетка выше или левее корабля даёт большое число
+                    const auto inside = static_cast<std::uint8_t>(hit[g] & (current[g] != owner)
+                        & (static_cast<std::uint8_t>(row[g] - top[g]) <= height[g])
+                        & (static_cast<std::uint8_t>(col[g] - left[g]) <= width[g]));
+                    const auto decks = static_cast<std::uint8_t>(shipHealth[g] - inside);
+                    shipHealth[g] = decks;
+                    sunk[g] |= static_cast<std::uint8_t>(inside & (decks == 0));
+                }
+            }
+        }
+
+        // Последний проход шага: исход, конец партии и смена хода (после промаха ход переходит,
+        // после попадания - нет). Все массивы разные; без __restrict проверок их пересечения
+        // больше, чем GCC готов вставить, и цикл не векторизуется
+        inline void FinishStep(std::uint8_t* __restrict outcomes, const std::uint8_t* __restrict hits,
+            const std::uint8_t* __restrict sunk, std::uint8_t* __restrict remaining0, std::uint8_t* __restrict remaining1,
+            std::uint8_t* __restrict current, std::uint8_t* __restrict state, std::int8_t* __restrict winner, std::size_t n)
+        {
+            for (std::size_t g = 0; g < n; ++g)
+            {
+                const std::uint8_t hit = hits[g];
+                const std::uint8_t player = current[g];
+                const std::uint8_t gameState = state[g];
+                const auto playing = static_cast<std::uint8_t>(gameState == PlayingState);
+                // Стрелял второй игрок - значит, по полю первого
+                const auto targetFirst = static_cast<std::uint8_t>(player != 0);
+                const auto targetSecond = static_cast<std::uint8_t>(targetFirst ^ 1);
+
+                const auto left0 = static_cast<std::uint8_t>(remaining0[g] - (hit & targetFirst));
+                const auto left1 = static_cast<std::uint8_t>(remaining1[g] - (hit & targetSecond));
+                remaining0[g] = left0;
+                remaining1[g] = left1;
+                const auto left = static_cast<std::uint8_t>(left0 * targetFirst + left1 * targetSecond);
+                const auto over = static_cast<std::uint8_t>(hit & (left == 0));
+
+                // Miss = 0, Hit = 1, Sunk = 2, GameOver = 3: конец партии - всегда потопление, потопление - попадание
+                outcomes[g] = static_cast<std::uint8_t>(playing * (hit + sunk[g] + over)
+                    + (playing ^ 1) * static_cast<std::uint8_t>(ShotOutcome::Ignored));
+                winner[g] = static_cast<std::int8_t>(winner[g] + over * (player - winner[g]));
+                state[g] = static_cast<std::uint8_t>(gameState + over * (GameOverState - gameState));
+                current[g] = static_cast<std::uint8_t>(player ^ (playing & (hit ^ 1)));
+            }
+        }
+
+        // Каждый проход - простой цикл по партиям без ветвлений: поле, слово и исход выбираются
+        // масками и арифметикой, поэтому компилятор векторизует проходы
+        template <typename R>
+        SEABATTLE_BATCH_KERNEL void StepKernel(const StepArrays& a, std::size_t n)
+        {
+            constexpr int Words = BasicGameBatch<R>::Words;
+            const std::uint8_t* cell = a.cells;
+            const std::uint8_t* current = a.current;
+            const std::uint8_t* state = a.state;
+
+            // 1. Выстрел по битовым доскам. Бит ставится только в поле противника текущего игрока
+            // и только в слове с клеткой, в остальных досках маска нулевая
+            for (int owner = 0; owner < 2; ++owner)
+            {
+                for (int word = 0; word < Words; ++word)
+                {
+                    const std::size_t board = (static_cast<std::size_t>(owner) * Words + word) * n;
+                    const std::uint64_t* ships = a.ships + board;
+                    std::uint64_t* shots = a.shots + board;
+                    std::uint64_t* hits = a.hits + board;
+                    for (std::size_t g = 0; g < n; ++g)
+                    {
+                        const std::uint64_t target = static_cast<std::uint64_t>(
+                            (current[g] != owner) & (state[g] == PlayingState) & ((cell[g] >> 6) == word));
+                        const std::uint64_t bit = target << (cell[g] & 63);
+                        // Повторный выстрел не попадает: клетка уже в shots
+                        hits[g] = bit & ships[g] & ~shots[g];
+                        shots[g] |= bit;
+                    }
+                }
+            }
+
+            // 2. Флаг попадания отдельным проходом по 64-битным доскам: в одном цикле
+            // с байтовыми величинами GCC его не векторизует
+            std::uint8_t* hit = a.hit;
+            const std::uint64_t* hits = a.hits;
+            for (std::size_t g = 0; g < n; ++g)
+            {
+                std::uint64_t touched = 0;
+                for (int board = 0; board < 2 * Words; ++board)
+                {
+                    touched |= hits[static_cast<std::size_t>(board) * n + g];
+                }
+                hit[g] = static_cast<std::uint8_t>(touched != 0);
+            }
+
+            // 3. Корабли. Деление на константу векторизуется умножением
+            std::uint8_t* row = a.row;
+            std::uint8_t* col = a.col;
+            std::uint8_t* sunk = a.sunk;
+            for (std::size_t g = 0; g < n; ++g)
+            {
+                row[g] = static_cast<std::uint8_t>(cell[g] / R::Cols);
+                col[g] = static_cast<std::uint8_t>(cell[g] % R::Cols);
+                sunk[g] = 0;
+            }
+            for (int owner = 0; owner < 2; ++owner)
+            {
+                const std::size_t fleet = static_cast<std::size_t>(owner) * R::FleetSize;
+                HitShips<R::FleetSize>(owner, a.bounds + fleet * 4 * n, a.health + fleet * n, row, col, hit, current, sunk, n);
+            }
+
+            // 4. Исход, конец партии и смена хода
+            FinishStep(a.outcomes, hit, sunk, a.remaining, a.remaining + n, a.current, a.state, a.winner, n);
+        }
+    }
+
+    template <typename R>
+    BasicGameBatch<R>::BasicGameBatch(std::size_t games)
+        : m_games(games)
+        , m_ships(2 * Words * games)
+        , m_shots(2 * Words * games)
+        , m_hits(2 * Words * games)
+        , m_bounds(2 * R::FleetSize * 4 * games)
+        , m_health(2 * R::FleetSize * games)
+        , m_remaining(2 * games)
+        , m_current(games)
+        , m_state(games, static_cast<std::uint8_t>(GameState::WaitingForPlayers))
+        , m_winner(games, -1)
+        , m_row(games)
+        , m_col(games)
+        , m_hit(games)
+        , m_sunk(games)
+    {
+    }
+
+    template <typename R>
+    void BasicGameBatch<R>::Load(std::size_t index, const Model& model)
+    {
+        for (int owner = 0; owner < 2; ++owner)
+        {
+            const auto& field = model.GetPlayerField(owner);
+            for (int word = 0; word < Words; ++word)
+            {
+                m_ships[boardAt(owner, word) + index] = 0;
+                m_shots[boardAt(owner, word) + index] = 0;
+            }
+            for (int cell = 0; cell < R::Cells; ++cell)
+            {
+                CellState state = field.getCellState(cell / R::Cols, cell % R::Cols);
+                const std::uint64_t bit = std::uint64_t{ 1 } << (cell % 64);
+                if (state != CellState::Empty && state != CellState::Miss)
+                {
+                    m_ships[boardAt(owner, cell / 64) + index] |= bit;
+                }
+                if (state != CellState::Empty && state != CellState::Ship)
+                {
+                    m_shots[boardAt(owner, cell / 64) + index] |= bit;
+                }
+            }
+
+            int remaining = 0;
+            const auto& ships = field.getShips();
+            for (int ship = 0; ship < R::FleetSize; ++ship)
+            {
+                // Пустой слот флота: строка 255 высотой 1 не совпадает ни с одной клеткой
+                std::uint8_t bounds[4] = { 255, 0, 0, 0 };
+                std::uint8_t health = 0;
+                if (static_cast<std::size_t>(ship) < ships.size() && !ships[static_cast<std::size_t>(ship)].positions.empty())
+                {
+                    const Ship& placed = ships[static_cast<std::size_t>(ship)];
+                    health = static_cast<std::uint8_t>(placed.health);
+                    const auto& first = placed.positions[0];
+                    const auto& last = placed.positions.back();
+                    bounds[0] = static_cast<std::uint8_t>(std::min(first.row, last.row));
+                    bounds[1] = static_cast<std::uint8_t>(std::min(first.col, last.col));
+                    bounds[2] = static_cast<std::uint8_t>(std::abs(last.row - first.row));
+                    bounds[3] = static_cast<std::uint8_t>(std::abs(last.col - first.col));
+                }
+                for (int bound = 0; bound < 4; ++bound)
+                {
+                    m_bounds[boundAt(owner, ship, bound) + index] = bounds[bound];
+                }
+                m_health[shipAt(owner, ship) + index] = health;
+                remaining += health;
+            }
+            m_remaining[static_cast<std::size_t>(owner) * m_games + index] = static_cast<std::uint8_t>(remaining);
+        }
+
+        m_current[index] = static_cast<std::uint8_t>(model.GetCurrentPlayer());
+        m_state[index] = static_cast<std::uint8_t>(model.GetGameState());
+        m_winner[index] = static_cast<std::int8_t>(model.GetWinner());
+    }
+
+    template <typename R>
+    void BasicGameBatch<R>::Step(std::span<const std::uint8_t> cells, std::span<ShotOutcome> outcomes)
+    {
+        StepArrays arrays{
+            cells.data(),
+            reinterpret_cast<std::uint8_t*>(outcomes.data()),
+            m_ships.data(),
+            m_shots.data(),
+            m_hits.data(),
+            m_bounds.data(),
+            m_health.data(),
+            m_remaining.data(),
+            m_current.data(),
+            m_state.data(),
+            m_winner.data(),
+            m_row.data(),
+            m_col.data(),
+            m_hit.data(),
+            m_sunk.data() };
+        StepKernel<R>(arrays, m_games);
+    }
+
+    template <typename R>
+    CellState BasicGameBatch<R>::Cell(std::size_t index, int owner, int row, int col) const
+    {
+        const int cell = row * R::Cols + col;
+        const std::uint64_t bit = std::uint64_t{ 1 } << (cell % 64);
+        const bool ship = (m_ships[boardAt(owner, cell / 64) + index] & bit) != 0;
+        const bool shot = (m_shots[boardAt(owner, cell / 64) + index] & bit) != 0;
+        if (!shot)
+        {
+            return ship ? CellState::Ship : CellState::Empty;
+        }
+        if (!ship)
+        {
+            return CellState::Miss;
+        }
+        for (int s = 0; s < R::FleetSize; ++s)
+        {
+            const auto inside = [&](int bound, int value) {
+                return value - m_bounds[boundAt(owner, s, bound) + index] >= 0
+                    && value - m_bounds[boundAt(owner, s, bound) + index] <= m_bounds[boundAt(owner, s, bound + 2) + index];
+            };
+            if (inside(0, row) && inside(1, col))
+            {
+                return m_health[shipAt(owner, s) + index] == 0 ? CellState::Destroyed : CellState::Hit;
+            }
+        }
+        return CellState::Hit;
+    }
+
+    template class BasicGameBatch<ClassicRules>;
+    template class BasicGameBatch<BlitzRules>;
+    template class BasicGameBatch<LargeRules>;
+    template class BasicGameBatch<TouchingRules>;
+}
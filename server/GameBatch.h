@@ -0,0 +1,93 @@
+#pragma once
+
+#include "GameModel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SeaBattle
+{
+    enum class ShotOutcome : std::uint8_t
+    {
+        Miss,       // промах или повторный выстрел по клетке - ход переходит
+        Hit,
+        Sunk,       // корабль потоплен, игра продолжается
+        GameOver,   // потоплен последний корабль
+        Ignored     // партия уже окончена
+    };
+
+    // Пачка партий для симуляций в структуре массивов: у каждой величины (слово битовой
+    // доски кораблей и выстрелов, здоровье корабля, текущий игрок) свой массив по всем
+    // партиям. Step делает по выстрелу в каждой партии проходами по массивам без ветвлений,
+    // которые компилятор векторизует; результаты те же, что у BasicGameModel::ProcessShot.
+    template <typename R>
+    class BasicGameBatch
+    {
+    public:
+        using Model = BasicGameModel<R>;
+
+        // Слов битовой доски на поле: клетка row * Cols + col - бит (cell % 64) слова cell / 64
+        static constexpr int Words = (R::Cells + 63) / 64;
+
+        explicit BasicGameBatch(std::size_t games);
+
+        std::size_t Size() const { return m_games; }
+
+        // Копирует позицию партии (в любой момент игры) в слот index
+        void Load(std::size_t index, const Model& model);
+
+        // Выстрел текущего игрока в каждой партии: cells[g] - клетка row * Cols + col поля
+        // противника. Клетки должны лежать на поле; в оконченных партиях выстрел не делается.
+        void Step(std::span<const std::uint8_t> cells, std::span<ShotOutcome> outcomes);
+
+        int CurrentPlayer(std::size_t index) const { return m_current[index]; }
+        GameState State(std::size_t index) const { return static_cast<GameState>(m_state[index]); }
+        int Winner(std::size_t index) const { return m_winner[index]; }
+        // Состояние клетки поля игрока owner в той же нумерации, что у BasicGameField
+        CellState Cell(std::size_t index, int owner, int row, int col) const;
+
+    private:
+        // Начало массива величины [owner][word] (или [owner][ship]) по всем партиям
+        std::size_t boardAt(int owner, int word) const { return (static_cast<std::size_t>(owner) * Words + word) * m_games; }
+        std::size_t shipAt(int owner, int ship) const { return (static_cast<std::size_t>(owner) * R::FleetSize + ship) * m_games; }
+        // Границы корабля: [owner][ship][bound][game]
+        std::size_t boundAt(int owner, int ship, int bound) const
+        {
+            return ((static_cast<std::size_t>(owner) * R::FleetSize + ship) * 4 + bound) * m_games;
+        }
+
+        std::size_t m_games;
+
+        // [owner][word][game]
+        std::vector<std::uint64_t> m_ships;
+        std::vector<std::uint64_t> m_shots;
+        // Попадания текущего шага: [owner][word][game]
+        std::vector<std::uint64_t> m_hits;
+        // Корабль - отрезок строки или столбца, поэтому вместо битовой доски у каждого корабля
+        // четыре байта: верхняя строка, левый столбец, высота - 1, ширина - 1. [owner][ship][4][game]
+        std::vector<std::uint8_t> m_bounds;
+        // [owner][ship][game]
+        std::vector<std::uint8_t> m_health;
+        // Непотопленных палуб: [owner][game]
+        std::vector<std::uint8_t> m_remaining;
+
+        // [game]
+        std::vector<std::uint8_t> m_current;
+        std::vector<std::uint8_t> m_state;      // GameState
+        std::vector<std::int8_t> m_winner;
+        // Промежуточные величины шага
+        std::vector<std::uint8_t> m_row;
+        std::vector<std::uint8_t> m_col;
+        std::vector<std::uint8_t> m_hit;
+        std::vector<std::uint8_t> m_sunk;       // в этом шаге потоплен корабль
+    };
+
+    using GameBatch = BasicGameBatch<ClassicRules>;
+
+    extern template class BasicGameBatch<ClassicRules>;
+    extern template class BasicGameBatch<BlitzRules>;
+    extern template class BasicGameBatch<LargeRules>;
+    extern template class BasicGameBatch<TouchingRules>;
+}
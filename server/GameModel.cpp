@@ -1,20 +1,26 @@
 #include "GameModel.h"
 
+#include "FleetValidator.h"
+
+#include <algorithm>
+
 namespace SeaBattle
 {
-    GameField::GameField()
+    template <typename R>
+    BasicGameField<R>::BasicGameField()
     {
         m_grid.fill(CellState::Empty);
-        m_ships.reserve(10);
     }
 
-    CellState GameField::getCellState(int row, int col) const
+    template <typename R>
+    CellState BasicGameField<R>::getCellState(int row, int col) const
     {
         validateCoordinates(row, col);
-        return m_grid[row * SIZE + col];
+        return m_grid[row * COLS + col];
     }
 
-    bool GameField::placeShip(const Ship& ship)
+    template <typename R>
+    bool BasicGameField<R>::placeShip(const Ship& ship)
     {
         if (!canPlaceShip(ship))
         {
@@ -23,14 +29,31 @@ namespace SeaBattle
 
         for (const auto& [row, col] : ship.positions)
         {
-            m_grid[row * SIZE + col] = CellState::Ship;
+            m_grid[row * COLS + col] = CellState::Ship;
         }
 
         m_ships.push_back(ship);
         return true;
     }
 
-    bool GameField::canPlaceShip(const Ship& ship) const
+    template <typename R>
+    void BasicGameField<R>::placeFleet(std::span<const ShipPlacement> ships)
+    {
+        m_grid.fill(CellState::Empty);
+        m_ships.clear();
+        for (const auto& placement : ships)
+        {
+            Ship ship(static_cast<ShipType>(placement.size), placement.row, placement.col, placement.vertical);
+            for (const auto& [row, col] : ship.positions)
+            {
+                m_grid[row * COLS + col] = CellState::Ship;
+            }
+            m_ships.push_back(ship);
+        }
+    }
+
+    template <typename R>
+    bool BasicGameField<R>::canPlaceShip(const Ship& ship) const
     {
         for (const auto& [row, col] : ship.positions)
         {
@@ -39,20 +62,23 @@ namespace SeaBattle
                 return false;
             }
 
-            if (getCellState(row, col) != CellState::Empty)
+            if (m_grid[row * COLS + col] != CellState::Empty)
             {
                 return false;
             }
 
-            for (int dr = -1; dr <= 1; ++dr)
+            if constexpr (!R::ShipsMayTouch)
             {
-                for (int dc = -1; dc <= 1; ++dc)
+                for (int dr = -1; dr <= 1; ++dr)
                 {
-                    int nr = row + dr;
-                    int nc = col + dc;
-                    if (isValidCoordinate(nr, nc) && getCellState(nr, nc) == CellState::Ship)
+                    for (int dc = -1; dc <= 1; ++dc)
                     {
-                        return false;
+                        int nr = row + dr;
+                        int nc = col + dc;
+                        if (isValidCoordinate(nr, nc) && m_grid[nr * COLS + nc] == CellState::Ship)
+                        {
+                            return false;
+                        }
                     }
                 }
             }
@@ -61,11 +87,12 @@ namespace SeaBattle
         return true;
     }
 
-    bool GameField::shoot(int row, int col)
+    template <typename R>
+    bool BasicGameField<R>::shoot(int row, int col)
     {
         validateCoordinates(row, col);
 
-        CellState& cell = m_grid[row * SIZE + col];
+        CellState& cell = m_grid[row * COLS + col];
 
         if (cell == CellState::Miss || cell == CellState::Hit || cell == CellState::Destroyed)
         {
@@ -78,7 +105,8 @@ namespace SeaBattle
 
             for (auto& ship : m_ships)
             {
-                auto it = std::find(ship.positions.begin(), ship.positions.end(), std::make_pair(row, col));
+                const Position target{ static_cast<std::int8_t>(row), static_cast<std::int8_t>(col) };
+                auto it = std::find(ship.positions.begin(), ship.positions.end(), target);
                 if (it != ship.positions.end())
                 {
                     ship.health--;
@@ -87,7 +115,7 @@ namespace SeaBattle
                     {
                         for (const auto& pos : ship.positions)
                         {
-                            m_grid[pos.first * SIZE + pos.second] = CellState::Destroyed;
+                            m_grid[pos.row * COLS + pos.col] = CellState::Destroyed;
                         }
                     }
 
@@ -103,17 +131,14 @@ namespace SeaBattle
         return false;
     }
 
-    bool GameField::allShipsDestroyed() const
+    template <typename R>
+    bool BasicGameField<R>::allShipsDestroyed() const
     {
         return std::all_of(m_ships.begin(), m_ships.end(), [](const Ship& ship) { return ship.isDestroyed(); });
     }
 
-    bool GameField::isValidCoordinate(int row, int col) const
-    {
-        return row >= 0 && row < SIZE && col >= 0 && col < SIZE;
-    }
-
-    void GameField::validateCoordinates(int row, int col) const
+    template <typename R>
+    void BasicGameField<R>::validateCoordinates(int row, int col) const
     {
         if (!isValidCoordinate(row, col))
         {
@@ -121,18 +146,18 @@ namespace SeaBattle
         }
     }
 
-    bool ShipPlacer::autoPlaceShips(GameField& field)
+    template <typename R>
+    bool BasicShipPlacer<R>::autoPlaceShips(BasicGameField<R>& field)
     {
-        std::vector<ShipType> shipsToPlace = {
-            ShipType::FourDeck,
-            ShipType::TripleDeck, ShipType::TripleDeck,
-            ShipType::DoubleDeck, ShipType::DoubleDeck, ShipType::DoubleDeck,
-            ShipType::SingleDeck, ShipType::SingleDeck, ShipType::SingleDeck, ShipType::SingleDeck};
-
         std::random_device rd;
         std::mt19937 gen(rd());
+        return autoPlaceShips(field, gen);
+    }
 
-        for (ShipType type : shipsToPlace)
+    template <typename R>
+    bool BasicShipPlacer<R>::autoPlaceShips(BasicGameField<R>& field, std::mt19937& gen)
+    {
+        for (ShipType type : R::Fleet)
         {
             if (!placeSingleShip(field, type, gen))
             {
@@ -143,7 +168,8 @@ namespace SeaBattle
         return true;
     }
 
-    bool ShipPlacer::placeSingleShip(GameField& field, ShipType type, std::mt19937& gen)
+    template <typename R>
+    bool BasicShipPlacer<R>::placeSingleShip(BasicGameField<R>& field, ShipType type, std::mt19937& gen)
     {
         std::uniform_int_distribution<> dist(0, 1);
         bool vertical = dist(gen) == 0;
@@ -152,8 +178,8 @@ namespace SeaBattle
 
         for (int attempt = 0; attempt < maxAttempts; ++attempt)
         {
-            int maxRow = GameField::SIZE - (vertical ? static_cast<int>(type) : 1);
-            int maxCol = GameField::SIZE - (vertical ? 1 : static_cast<int>(type));
+            int maxRow = R::Rows - (vertical ? static_cast<int>(type) : 1);
+            int maxCol = R::Cols - (vertical ? 1 : static_cast<int>(type));
 
             if (maxRow < 0 || maxCol < 0)
                 continue;
@@ -180,34 +206,55 @@ namespace SeaBattle
         return false;
     }
 
-    GameModel::GameModel()
+    template <typename R>
+    BasicGameModel<R>::BasicGameModel()
         : m_currentPlayer(0)
         , m_gameState(GameState::WaitingForPlayers)
         , m_winner(-1)
     {
     }
 
-    void GameModel::StartGame()
+    template <typename R>
+    void BasicGameModel<R>::StartGame()
+    {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        StartGame(gen);
+    }
+
+    template <typename R>
+    void BasicGameModel<R>::StartGame(std::mt19937& gen)
     {
-        m_playerFields[0] = GameField();
-        m_playerFields[1] = GameField();
+        Field first;
+        Field second;
 
-        if (!ShipPlacer::autoPlaceShips(m_playerFields[0]))
+        if (!BasicShipPlacer<R>::autoPlaceShips(first, gen))
         {
             throw std::runtime_error("Failed to place ships for player 1");
         }
 
-        if (!ShipPlacer::autoPlaceShips(m_playerFields[1]))
+        if (!BasicShipPlacer<R>::autoPlaceShips(second, gen))
         {
             throw std::runtime_error("Failed to place ships for player 2");
         }
 
+        StartGame(first, second);
+    }
+
+    template <typename R>
+    void BasicGameModel<R>::StartGame(const Field& firstPlayer, const Field& secondPlayer)
+    {
+        m_playerFields[0] = firstPlayer;
+        m_playerFields[1] = secondPlayer;
+        m_fleetLocked = {};
+
         m_gameState = GameState::Playing;
         m_currentPlayer = 0;
         m_winner = -1;
     }
 
-    bool GameModel::ProcessShot(int playerIndex, int row, int col)
+    template <typename R>
+    bool BasicGameModel<R>::ProcessShot(int playerIndex, int row, int col)
     {
         if (m_gameState != GameState::Playing)
         {
@@ -219,8 +266,9 @@ namespace SeaBattle
             return false;
         }
 
-        GameField& enemyField = m_playerFields[(playerIndex + 1) % 2];
+        Field& enemyField = m_playerFields[(playerIndex + 1) % 2];
         bool hit = enemyField.shoot(row, col);
+        m_fleetLocked[(playerIndex + 1) % 2] = true;
 
         if (hit)
         {
@@ -238,18 +286,243 @@ namespace SeaBattle
         return hit;
     }
 
-    const GameField& GameModel::GetPlayerField(int playerIndex) const
+    template <typename R>
+    bool BasicGameModel<R>::IsValidShot(int playerIndex, int row, int col) const
+    {
+        if constexpr (R::Salvo)
+        {
+            return false;
+        }
+        if (m_gameState != GameState::Playing || playerIndex != m_currentPlayer || !Field::isValidCoordinate(row, col))
+        {
+            return false;
+        }
+
+        CellState cell = m_playerFields[(playerIndex + 1) % 2].getCellState(row, col);
+        return cell == CellState::Empty || cell == CellState::Ship;
+    }
+
+    template <typename R>
+    int BasicGameModel<R>::SalvoSize(int playerIndex) const
+    {
+        if constexpr (!R::Salvo)
+        {
+            return 0;
+        }
+        if (playerIndex != 0 && playerIndex != 1)
+        {
+            return 0;
+        }
+        const auto& ships = m_playerFields[playerIndex].getShips();
+        const int alive = static_cast<int>(std::count_if(ships.begin(), ships.end(), [](const Ship& ship) { return !ship.isDestroyed(); }));
+
+        const Field& enemyField = m_playerFields[(playerIndex + 1) % 2];
+        int untouched = 0;
+        for (int cell = 0; cell < R::Cells; ++cell)
+        {
+            const CellState state = enemyField.getCellState(cell / R::Cols, cell % R::Cols);
+            untouched += state == CellState::Empty || state == CellState::Ship ? 1 : 0;
+        }
+        return std::min(alive, untouched);
+    }
+
+    template <typename R>
+    bool BasicGameModel<R>::IsValidSalvo(int playerIndex, const ShotMask& shots) const
+    {
+        if (!R::Salvo || m_gameState != GameState::Playing || playerIndex != m_currentPlayer)
+        {
+            return false;
+        }
+        // Биты за последней клеткой поля
+        constexpr int tail = ShotMask::Words * 64 - R::Cells;
+        if constexpr (tail > 0)
+        {
+            if (shots.words.back() >> (64 - tail) != 0)
+            {
+                return false;
+            }
+        }
+        if (shots.count() != SalvoSize(playerIndex))
+        {
+            return false;
+        }
+
+        const Field& enemyField = m_playerFields[(playerIndex + 1) % 2];
+        bool untouched = true;
+        shots.forEach([&](int cell)
+            {
+                const CellState state = enemyField.getCellState(cell / R::Cols, cell % R::Cols);
+                untouched = untouched && (state == CellState::Empty || state == CellState::Ship);
+            });
+        return untouched;
+    }
+
+    template <typename R>
+    typename BasicGameModel<R>::ShotMask BasicGameModel<R>::ProcessSalvo(int playerIndex, const ShotMask& shots)
+    {
+        ShotMask hits;
+        if (!R::Salvo || m_gameState != GameState::Playing || playerIndex != m_currentPlayer)
+        {
+            return hits;
+        }
+
+        Field& enemyField = m_playerFields[(playerIndex + 1) % 2];
+        shots.forEach([&](int cell)
+            {
+                if (enemyField.shoot(cell / R::Cols, cell % R::Cols))
+                {
+                    hits.set(cell);
+                }
+            });
+        m_fleetLocked[(playerIndex + 1) % 2] = true;
+
+        if (enemyField.allShipsDestroyed())
+        {
+            m_gameState = GameState::GameOver;
+            m_winner = playerIndex;
+        }
+        else
+        {
+            switchPlayer();
+        }
+        return hits;
+    }
+
+    template <typename R>
+    bool BasicGameModel<R>::Forfeit(int playerIndex)
+    {
+        if (m_gameState != GameState::Playing || (playerIndex != 0 && playerIndex != 1))
+        {
+            return false;
+        }
+        m_gameState = GameState::GameOver;
+        m_winner = (playerIndex + 1) % 2;
+        return true;
+    }
+
+    template <typename R>
+    bool BasicGameModel<R>::CanPlaceFleet(int playerIndex) const
+    {
+        return m_gameState == GameState::Playing && (playerIndex == 0 || playerIndex == 1) && !m_fleetLocked[playerIndex];
+    }
+
+    template <typename R>
+    FleetError BasicGameModel<R>::PlaceFleet(int playerIndex, std::span<const ShipPlacement> ships)
+    {
+        if (!CanPlaceFleet(playerIndex))
+        {
+            return FleetError::SetupOver;
+        }
+
+        FleetError error = BasicFleetValidator<R>::Validate(ships);
+        if (error == FleetError::None)
+        {
+            m_playerFields[playerIndex].placeFleet(ships);
+        }
+        return error;
+    }
+
+    template <typename R>
+    const typename BasicGameModel<R>::Field& BasicGameModel<R>::GetPlayerField(int playerIndex) const
     {
         return m_playerFields[playerIndex];
     }
 
-    const GameField& GameModel::GetEnemyField(int playerIndex) const
+    template <typename R>
+    const typename BasicGameModel<R>::Field& BasicGameModel<R>::GetEnemyField(int playerIndex) const
     {
         return m_playerFields[(playerIndex + 1) % 2];
     }
 
-    void GameModel::switchPlayer()
+    template <typename R>
+    void BasicGameModel<R>::switchPlayer()
     {
         m_currentPlayer = (m_currentPlayer + 1) % 2;
     }
+
+    AnyGameModel MakeGameModel(GameMode mode)
+    {
+        switch (mode)
+        {
+        case GameMode::Blitz:
+            return BasicGameModel<BlitzRules>();
+        case GameMode::Large:
+            return BasicGameModel<LargeRules>();
+        case GameMode::Touching:
+            return BasicGameModel<TouchingRules>();
+        case GameMode::Salvo:
+            return BasicGameModel<SalvoRules>();
+        case GameMode::Classic:
+        default:
+            return BasicGameModel<ClassicRules>();
+        }
+    }
+
+    std::optional<GameMode> ParseGameMode(std::string_view name)
+    {
+        for (GameMode mode : GameModes)
+        {
+            if (ToString(mode) == name)
+            {
+                return mode;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string_view ToString(GameMode mode)
+    {
+        switch (mode)
+        {
+        case GameMode::Blitz:
+            return "blitz";
+        case GameMode::Large:
+            return "large";
+        case GameMode::Touching:
+            return "touching";
+        case GameMode::Salvo:
+            return "salvo";
+        case GameMode::Classic:
+        default:
+            return "classic";
+        }
+    }
+
+    std::string_view ToString(FleetError error)
+    {
+        switch (error)
+        {
+        case FleetError::WrongFleet:
+            return "wrong_fleet";
+        case FleetError::OutOfBounds:
+            return "out_of_bounds";
+        case FleetError::Overlap:
+            return "overlap";
+        case FleetError::Touching:
+            return "touching";
+        case FleetError::SetupOver:
+            return "setup_over";
+        case FleetError::None:
+        default:
+            return "none";
+        }
+    }
+
+    template class BasicGameField<ClassicRules>;
+    template class BasicGameField<BlitzRules>;
+    template class BasicGameField<LargeRules>;
+    template class BasicGameField<TouchingRules>;
+    template class BasicGameField<SalvoRules>;
+
+    template class BasicShipPlacer<ClassicRules>;
+    template class BasicShipPlacer<BlitzRules>;
+    template class BasicShipPlacer<LargeRules>;
+    template class BasicShipPlacer<TouchingRules>;
+    template class BasicShipPlacer<SalvoRules>;
+
+    template class BasicGameModel<ClassicRules>;
+    template class BasicGameModel<BlitzRules>;
+    template class BasicGameModel<LargeRules>;
+    template class BasicGameModel<TouchingRules>;
+    template class BasicGameModel<SalvoRules>;
 }
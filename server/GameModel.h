@@ -1,14 +1,21 @@
 #pragma once
 
+#include "StaticVector.h"
+
 #include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
 #include <random>
+#include <span>
 #include <stdexcept>
-#include <utility>
-#include <vector>
+#include <string_view>
+#include <type_traits>
+#include <variant>
 
 namespace SeaBattle
 {
-    enum class CellState
+    enum class CellState : std::uint8_t
     {
         Empty,
         Ship,
@@ -17,36 +24,49 @@ namespace SeaBattle
         Destroyed
     };
 
-    enum class ShipType
+    enum class ShipType : std::uint8_t
     {
         SingleDeck = 1,
         DoubleDeck = 2,
         TripleDeck = 3,
-        FourDeck = 4
+        FourDeck = 4,
+        FiveDeck = 5
+    };
+
+    constexpr int MaxShipSize = 5;
+
+    struct Position
+    {
+        std::int8_t row = 0;
+        std::int8_t col = 0;
+
+        bool operator==(const Position&) const = default;
     };
 
+    // Корабль хранит клетки внутри себя, без выделений памяти в куче
     struct Ship
     {
-        ShipType type;
-        int health;
-        std::vector<std::pair<int, int>> positions;
-        bool isVertical;
+        ShipType type = ShipType::SingleDeck;
+        std::int8_t health = 0;
+        bool isVertical = false;
+        StaticVector<Position, MaxShipSize> positions;
+
+        Ship() = default;
 
         Ship(ShipType t, int startRow, int startCol, bool vertical)
             : type(t)
-            , health(static_cast<int>(t))
+            , health(static_cast<std::int8_t>(t))
             , isVertical(vertical)
         {
-            positions.reserve(health);
             for (int i = 0; i < health; ++i)
             {
                 if (vertical)
                 {
-                    positions.emplace_back(startRow + i, startCol);
+                    positions.push_back({ static_cast<std::int8_t>(startRow + i), static_cast<std::int8_t>(startCol) });
                 }
                 else
                 {
-                    positions.emplace_back(startRow, startCol + i);
+                    positions.push_back({ static_cast<std::int8_t>(startRow), static_cast<std::int8_t>(startCol + i) });
                 }
             }
         }
@@ -54,65 +74,246 @@ namespace SeaBattle
         bool isDestroyed() const { return health == 0; }
     };
 
-    class GameField
+    // Корабль из расстановки, присланной клиентом: значения ещё не проверены
+    struct ShipPlacement
+    {
+        int size = 0;
+        int row = 0;
+        int col = 0;
+        bool vertical = false;
+    };
+
+    enum class FleetError : std::uint8_t
+    {
+        None,
+        WrongFleet,     // состав флота не совпадает с правилами
+        OutOfBounds,
+        Overlap,        // корабли пересекаются
+        Touching,       // корабли касаются, а правила это запрещают
+        SetupOver       // по полю игрока уже стреляли
+    };
+
+    // Правила варианта игры: размеры поля, состав флота и правило касания.
+    // Все циклы по полю и по флоту разворачиваются на этапе компиляции.
+    template <int BoardRows, int BoardCols, bool TouchingAllowed, int... ShipSizes>
+    struct Rules
+    {
+        static constexpr int Rows = BoardRows;
+        static constexpr int Cols = BoardCols;
+        static constexpr int Cells = Rows * Cols;
+        static constexpr bool ShipsMayTouch = TouchingAllowed;
+        static constexpr int FleetSize = static_cast<int>(sizeof...(ShipSizes));
+        static constexpr std::array<ShipType, sizeof...(ShipSizes)> Fleet = { static_cast<ShipType>(ShipSizes)... };
+        // Ход - залп из нескольких выстрелов (SalvoRules), а не один выстрел
+        static constexpr bool Salvo = false;
+    };
+
+    using ClassicRules = Rules<10, 10, false, 4, 3, 3, 2, 2, 2, 1, 1, 1, 1>;
+    using BlitzRules = Rules<8, 8, false, 3, 2, 2, 1, 1, 1>;
+    using LargeRules = Rules<12, 12, false, 5, 4, 3, 3, 2, 2, 2, 1, 1, 1, 1>;
+    using TouchingRules = Rules<10, 10, true, 4, 3, 3, 2, 2, 2, 1, 1, 1, 1>;
+
+    // Залп: поле и флот классические, но за ход - по выстрелу на каждый уцелевший корабль
+    struct SalvoRules : ClassicRules
+    {
+        static constexpr bool Salvo = true;
+    };
+
+    // Набор клеток поля битами: бит row * Cols + col
+    template <typename R>
+    struct BasicShotMask
+    {
+        static constexpr int Words = (R::Cells + 63) / 64;
+
+        std::array<std::uint64_t, Words> words{};
+
+        void set(int cell) { words[static_cast<std::size_t>(cell / 64)] |= std::uint64_t{ 1 } << (cell % 64); }
+        bool test(int cell) const { return (words[static_cast<std::size_t>(cell / 64)] >> (cell % 64)) & 1; }
+
+        int count() const
+        {
+            int total = 0;
+            for (auto word : words)
+            {
+                total += std::popcount(word);
+            }
+            return total;
+        }
+
+        // Вызывает fn(cell) для клеток набора по возрастанию
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            for (int word = 0; word < Words; ++word)
+            {
+                for (auto bits = words[static_cast<std::size_t>(word)]; bits != 0; bits &= bits - 1)
+                {
+                    fn(word * 64 + std::countr_zero(bits));
+                }
+            }
+        }
+
+        bool operator==(const BasicShotMask&) const = default;
+    };
+
+    template <typename R>
+    class BasicGameField
     {
     public:
-        static const int SIZE = 10;
+        using RulesType = R;
+        using Fleet = StaticVector<Ship, R::FleetSize>;
+
+        static constexpr int ROWS = R::Rows;
+        static constexpr int COLS = R::Cols;
 
-        GameField();
+        BasicGameField();
 
         CellState getCellState(int row, int col) const;
         bool placeShip(const Ship& ship);
         bool canPlaceShip(const Ship& ship) const;
         bool shoot(int row, int col);
         bool allShipsDestroyed() const;
-        const std::vector<Ship>& getShips() const { return m_ships; }
+        const Fleet& getShips() const { return m_ships; }
+        // Заменяет флот расстановкой, уже проверенной BasicFleetValidator, без повторной проверки клеток
+        void placeFleet(std::span<const ShipPlacement> ships);
+
+        static bool isValidCoordinate(int row, int col)
+        {
+            return row >= 0 && row < ROWS && col >= 0 && col < COLS;
+        }
 
     private:
-        std::array<CellState, SIZE * SIZE> m_grid{};
-        std::vector<Ship> m_ships;
+        std::array<CellState, R::Cells> m_grid{};
+        Fleet m_ships;
 
-        bool isValidCoordinate(int row, int col) const;
         void validateCoordinates(int row, int col) const;
     };
 
-    class ShipPlacer
+    template <typename R>
+    class BasicShipPlacer
     {
     public:
-        static bool autoPlaceShips(GameField& field);
+        static bool autoPlaceShips(BasicGameField<R>& field);
+        // Воспроизводимая расстановка: одинаковое состояние генератора даёт одинаковый флот
+        static bool autoPlaceShips(BasicGameField<R>& field, std::mt19937& gen);
 
     private:
-        static bool placeSingleShip(GameField& field, ShipType type, std::mt19937& gen);
+        static bool placeSingleShip(BasicGameField<R>& field, ShipType type, std::mt19937& gen);
     };
 
-    enum class GameState
+    enum class GameState : std::uint8_t
     {
         WaitingForPlayers,
         Playing,
         GameOver
     };
 
-    class GameModel
+    template <typename R>
+    class BasicGameModel
     {
     public:
-        GameModel();
+        using RulesType = R;
+        using Field = BasicGameField<R>;
+        using ShotMask = BasicShotMask<R>;
+
+        BasicGameModel();
 
         void StartGame();
+        void StartGame(std::mt19937& gen);
+        // Начало партии с готовыми расстановками (например, из FleetPool)
+        void StartGame(const Field& firstPlayer, const Field& secondPlayer);
         bool ProcessShot(int playerIndex, int row, int col);
+        // Выстрел допустим: идёт игра, ход этого игрока, клетка на поле и по ней ещё не стреляли.
+        // По правилам залпа одиночных выстрелов нет
+        bool IsValidShot(int playerIndex, int row, int col) const;
+
+        // Выстрелов в залпе игрока: по одному на его уцелевший корабль, но не больше клеток
+        // соперника, по которым ещё не стреляли; 0 - правила не залповые
+        int SalvoSize(int playerIndex) const;
+        // Залп допустим: правила залповые, идёт игра, ход этого игрока, в маске ровно SalvoSize
+        // клеток поля и по ним ещё не стреляли
+        bool IsValidSalvo(int playerIndex, const ShotMask& shots) const;
+        // Весь залп за один проход по битам маски; возвращает попадания. Ход переходит к сопернику,
+        // если партия не кончилась. Залп должен быть допустим (IsValidSalvo)
+        ShotMask ProcessSalvo(int playerIndex, const ShotMask& shots);
+
+        // Игрок проиграл не по доске (например, истекли его часы): партия кончается победой
+        // соперника. false - партия не идёт
+        bool Forfeit(int playerIndex);
+
+        // Ручная расстановка: игрок может заменить свой флот, пока по его полю не стреляли
+        bool CanPlaceFleet(int playerIndex) const;
+        FleetError PlaceFleet(int playerIndex, std::span<const ShipPlacement> ships);
 
         int GetCurrentPlayer() const { return m_currentPlayer; }
         GameState GetGameState() const { return m_gameState; }
         int GetWinner() const { return m_winner; }
 
-        const GameField& GetPlayerField(int playerIndex) const;
-        const GameField& GetEnemyField(int playerIndex) const;
+        const Field& GetPlayerField(int playerIndex) const;
+        const Field& GetEnemyField(int playerIndex) const;
 
     private:
-        GameField m_playerFields[2];
+        Field m_playerFields[2];
         int m_currentPlayer;
         GameState m_gameState;
         int m_winner;
+        std::array<bool, 2> m_fleetLocked{};
 
         void switchPlayer();
     };
+
+    // Модель целиком лежит внутри объекта: снимок партии - это один memcpy
+    static_assert(std::is_trivially_copyable_v<BasicGameModel<ClassicRules>>);
+    static_assert(std::is_trivially_copyable_v<BasicGameModel<LargeRules>>);
+    static_assert(std::is_trivially_copyable_v<BasicGameModel<SalvoRules>>);
+
+    using GameField = BasicGameField<ClassicRules>;
+    using ShipPlacer = BasicShipPlacer<ClassicRules>;
+    using GameModel = BasicGameModel<ClassicRules>;
+
+    // Поддерживаемые варианты игры. Шаблоны инстанцируются только для них,
+    // выбор варианта происходит один раз - при создании комнаты.
+    enum class GameMode
+    {
+        Classic,
+        Blitz,
+        Large,
+        Touching,
+        Salvo
+    };
+
+    // Все варианты по порядку: по этому списку разбирается имя варианта и строятся подсказки
+    inline constexpr std::array<GameMode, 5> GameModes = {
+        GameMode::Classic, GameMode::Blitz, GameMode::Large, GameMode::Touching, GameMode::Salvo
+    };
+
+    using AnyGameModel = std::variant<
+        BasicGameModel<ClassicRules>,
+        BasicGameModel<BlitzRules>,
+        BasicGameModel<LargeRules>,
+        BasicGameModel<TouchingRules>,
+        BasicGameModel<SalvoRules>>;
+
+    AnyGameModel MakeGameModel(GameMode mode);
+    std::optional<GameMode> ParseGameMode(std::string_view name);
+    std::string_view ToString(GameMode mode);
+    std::string_view ToString(FleetError error);
+
+    extern template class BasicGameField<ClassicRules>;
+    extern template class BasicGameField<BlitzRules>;
+    extern template class BasicGameField<LargeRules>;
+    extern template class BasicGameField<TouchingRules>;
+    extern template class BasicGameField<SalvoRules>;
+
+    extern template class BasicShipPlacer<ClassicRules>;
+    extern template class BasicShipPlacer<BlitzRules>;
+    extern template class BasicShipPlacer<LargeRules>;
+    extern template class BasicShipPlacer<TouchingRules>;
+    extern template class BasicShipPlacer<SalvoRules>;
+
+    extern template class BasicGameModel<ClassicRules>;
+    extern template class BasicGameModel<BlitzRules>;
+    extern template class BasicGameModel<LargeRules>;
+    extern template class BasicGameModel<TouchingRules>;
+    extern template class BasicGameModel<SalvoRules>;
 }
@@ -0,0 +1,312 @@
+#include "OpeningBook.h"
+
+#include "Endgame.h"
+#include "FleetPool.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+namespace SeaBattle
+{
+    namespace
+    {
+        constexpr int Cols = ShotBoard::COLS;
+        constexpr int Cells = ClassicRules::Cells;
+        constexpr char Magic[8] = { 'S', 'B', 'O', 'P', 'E', 'N', 'B', 'K' };
+        constexpr std::uint32_t Version = 1;
+
+        constexpr std::uint64_t splitmix64(std::uint64_t x)
+        {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        // Ключи зашиты в формат файла: изменить их - значит поднять Version
+        constexpr auto MakeKeys()
+        {
+            std::array<std::array<std::uint64_t, static_cast<int>(CellState::Destroyed) + 1>, Cells> keys{};
+            std::uint64_t seed = 0x0B00C0B00C0B00C0ull;
+            for (auto& cell : keys)
+            {
+                for (auto& key : cell)
+                {
+                    seed = splitmix64(seed);
+                    key = seed;
+                }
+            }
+            return keys;
+        }
+
+        constexpr auto g_keys = MakeKeys();
+
+        // Расстановка из выборки: клетки флота и каждого корабля
+        struct SampleFleet
+        {
+            BoardMask cells;
+            std::array<BoardMask, ClassicRules::FleetSize> ships;
+        };
+
+        class TreeBuilder
+        {
+        public:
+            TreeBuilder(const OpeningBookOptions& options, std::vector<SampleFleet> fleets)
+                : m_options(options)
+                , m_fleets(std::move(fleets))
+            {
+            }
+
+            std::vector<OpeningMove> Run()
+            {
+                std::vector<std::uint32_t> all(m_fleets.size());
+                for (std::uint32_t i = 0; i < all.size(); ++i)
+                {
+                    all[i] = i;
+                }
+                expand(ShotBoard{}, all, 0);
+                return std::move(m_moves);
+            }
+
+        private:
+            void expand(const ShotBoard& board, const std::vector<std::uint32_t>& fleets, int depth)
+            {
+                if (depth >= m_options.depth || fleets.size() < static_cast<std::size_t>(m_options.minSamples))
+                {
+                    return;
+                }
+
+                std::array<std::uint32_t, Cells> counts{};
+                for (std::uint32_t fleet : fleets)
+                {
+                    for (int cell = 0; cell < Cells; ++cell)
+                    {
+                        counts[static_cast<std::size_t>(cell)] += m_fleets[fleet].cells.test(cell) ? 1 : 0;
+                    }
+                }
+                int shot = -1;
+                for (int cell = 0; cell < Cells; ++cell)
+                {
+                    if (board.cells[static_cast<std::size_t>(cell)] == CellState::Empty
+                        && (shot < 0 || counts[static_cast<std::size_t>(cell)] > counts[static_cast<std::size_t>(shot)]))
+                    {
+                        shot = cell;
+                    }
+                }
+                if (shot < 0 || counts[static_cast<std::size_t>(shot)] == 0)
+                {
+                    return;
+                }
+                m_moves.push_back({ OpeningBook::Key(board), { static_cast<std::int8_t>(shot / Cols), static_cast<std::int8_t>(shot % Cols) } });
+
+                // Исходы выстрела: промах, попадание без потопления и потопление - по кораблям
+                BoardMask hit;
+                for (int cell = 0; cell < Cells; ++cell)
+                {
+                    if (board.cells[static_cast<std::size_t>(cell)] == CellState::Hit || cell == shot)
+                    {
+                        hit.set(cell);
+                    }
+                }
+                std::vector<std::uint32_t> misses;
+                std::vector<std::uint32_t> hits;
+                std::map<std::array<std::uint64_t, 2>, std::vector<std::uint32_t>> sunk;
+                for (std::uint32_t fleet : fleets)
+                {
+                    const SampleFleet& sample = m_fleets[fleet];
+                    if (!sample.cells.test(shot))
+                    {
+                        misses.push_back(fleet);
+                        continue;
+                    }
+                    bool destroyed = false;
+                    for (const BoardMask& ship : sample.ships)
+                    {
+                        if (ship.test(shot))
+                        {
+                            destroyed = ship.within(hit);
+                            if (destroyed)
+                            {
+                                sunk[ship.words].push_back(fleet);
+                            }
+                            break;
+                        }
+                    }
+                    if (!destroyed)
+                    {
+                        hits.push_back(fleet);
+                    }
+                }
+
+                ShotBoard next = board;
+                next.cells[static_cast<std::size_t>(shot)] = CellState::Miss;
+                expand(next, misses, depth + 1);
+                next.cells[static_cast<std::size_t>(shot)] = CellState::Hit;
+                expand(next, hits, depth + 1);
+                for (const auto& [words, group] : sunk)
+                {
+                    ShotBoard destroyed = board;
+                    BoardMask ship;
+                    ship.words = words;
+                    for (int cell = 0; cell < Cells; ++cell)
+                    {
+                        if (ship.test(cell))
+                        {
+                            destroyed.cells[static_cast<std::size_t>(cell)] = CellState::Destroyed;
+                        }
+                    }
+                    expand(destroyed, group, depth + 1);
+                }
+            }
+
+            const OpeningBookOptions& m_options;
+            std::vector<SampleFleet> m_fleets;
+            std::vector<OpeningMove> m_moves;
+        };
+    }
+
+    OpeningBook::OpeningBook(const std::string& path)
+    {
+        try
+        {
+            m_file = boost::interprocess::file_mapping(path.c_str(), boost::interprocess::read_only);
+            m_region = boost::interprocess::mapped_region(m_file, boost::interprocess::read_only);
+        }
+        catch (const boost::interprocess::interprocess_exception& ex)
+        {
+            throw std::runtime_error("opening book '" + path + "': " + ex.what());
+        }
+
+        const auto* data = static_cast<const std::uint8_t*>(m_region.get_address());
+        const std::size_t size = m_region.get_size();
+        if (size < sizeof(Header))
+        {
+            throw std::runtime_error("opening book '" + path + "': file is too short");
+        }
+        m_header = reinterpret_cast<const Header*>(data);
+        if (std::memcmp(m_header->magic, Magic, sizeof(Magic)) != 0 || m_header->version != Version)
+        {
+            throw std::runtime_error("opening book '" + path + "': not an opening book of version " + std::to_string(Version));
+        }
+        if (m_header->rules != RulesKey())
+        {
+            throw std::runtime_error("opening book '" + path + "': built for different rules");
+        }
+        if (!std::has_single_bit(m_header->slots) || size != sizeof(Header) + std::size_t{ m_header->slots } * sizeof(Slot))
+        {
+            throw std::runtime_error("opening book '" + path + "': corrupted table");
+        }
+        m_slots = reinterpret_cast<const Slot*>(data + sizeof(Header));
+        m_mask = m_header->slots - 1;
+    }
+
+    std::optional<Position> OpeningBook::Lookup(const ShotBoard& board) const
+    {
+        const std::uint64_t key = Key(board);
+        for (std::uint64_t index = key & m_mask;; index = (index + 1) & m_mask)
+        {
+            const Slot& slot = m_slots[index];
+            if (slot.key == key)
+            {
+                return Position{ static_cast<std::int8_t>(slot.cell / Cols), static_cast<std::int8_t>(slot.cell % Cols) };
+            }
+            if (slot.key == 0)
+            {
+                return std::nullopt;
+            }
+        }
+    }
+
+    std::uint64_t OpeningBook::Key(const ShotBoard& board)
+    {
+        std::uint64_t key = 0;
+        for (int cell = 0; cell < Cells; ++cell)
+        {
+            key ^= g_keys[static_cast<std::size_t>(cell)][static_cast<std::size_t>(board.cells[static_cast<std::size_t>(cell)])];
+        }
+        return key != 0 ? key : 1;
+    }
+
+    std::uint32_t OpeningBook::RulesKey()
+    {
+        std::uint32_t key = static_cast<std::uint32_t>(ClassicRules::Rows) << 24 | static_cast<std::uint32_t>(ClassicRules::Cols) << 16;
+        for (ShipType type : ClassicRules::Fleet)
+        {
+            key = key * 31 + static_cast<std::uint32_t>(type);
+        }
+        return key;
+    }
+
+    std::vector<OpeningMove> OpeningBook::Build(const OpeningBookOptions& options)
+    {
+        std::mt19937 gen{ options.seed };
+        std::vector<SampleFleet> fleets(static_cast<std::size_t>(options.samples));
+        for (auto& fleet : fleets)
+        {
+            const auto field = FleetPool::MakeFleet<ClassicRules>(gen);
+            const auto& ships = field.getShips();
+            for (std::size_t s = 0; s < ships.size(); ++s)
+            {
+                for (const auto& [row, col] : ships[s].positions)
+                {
+                    fleet.ships[s].set(row * Cols + col);
+                }
+                fleet.cells |= fleet.ships[s];
+            }
+        }
+        return TreeBuilder(options, std::move(fleets)).Run();
+    }
+
+    void OpeningBook::Write(const std::string& path, const std::vector<OpeningMove>& moves, const OpeningBookOptions& options)
+    {
+        // Заполнение не больше половины: промах поиска кончается за пару слотов
+        const auto slotCount = static_cast<std::uint32_t>(std::bit_ceil(std::max<std::size_t>(moves.size() * 2, 16)));
+        std::vector<Slot> slots(slotCount, Slot{});
+        for (const auto& move : moves)
+        {
+            std::uint64_t index = move.key & (slotCount - 1);
+            while (slots[index].key != 0 && slots[index].key != move.key)
+            {
+                index = (index + 1) & (slotCount - 1);
+            }
+            slots[index].key = move.key;
+            slots[index].cell = static_cast<std::uint8_t>(move.shot.row * Cols + move.shot.col);
+        }
+
+        // Порядок байтов - как у машины, где собрана книга; книга собирается там же, где используется
+        Header header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.rules = RulesKey();
+        header.slots = slotCount;
+        header.moves = static_cast<std::uint32_t>(moves.size());
+        header.depth = static_cast<std::uint32_t>(options.depth);
+        header.samples = static_cast<std::uint32_t>(options.samples);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Slot)));
+        if (!out)
+        {
+            throw std::runtime_error("failed to write opening book '" + path + "'");
+        }
+    }
+
+    BookStrategy::BookStrategy(std::shared_ptr<const OpeningBook> book, std::unique_ptr<IShotStrategy> fallback)
+        : m_book(std::move(book))
+        , m_fallback(std::move(fallback))
+    {
+    }
+
+    Position BookStrategy::NextShot(const ShotBoard& board, std::mt19937& gen)
+    {
+        if (auto shot = m_book->Lookup(board))
+        {
+            return *shot;
+        }
+        return m_fallback->NextShot(board, gen);
+    }
+}
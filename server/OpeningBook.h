@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Strategy.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace SeaBattle
+{
+    struct OpeningBookOptions
+    {
+        int samples = 200000;       // расстановок ShipPlacer, по которым считаются вероятности
+        int depth = 15;             // выстрелов от начала партии
+        int minSamples = 500;       // позиции с меньшим числом согласных расстановок в книгу не идут
+        std::uint32_t seed = 1;
+    };
+
+    struct OpeningMove
+    {
+        std::uint64_t key = 0;      // OpeningBook::Key позиции
+        Position shot;
+    };
+
+    // Книга дебютов классических правил: позиция (поле противника глазами стреляющего) -> выстрел.
+    // Файл - заголовок и хэш-таблица с открытой адресацией, загрузка - отображение файла в память
+    // только для чтения, без разбора: страницы подгружаются при первых обращениях и общие
+    // для всех процессов, открывших книгу. Поиск - один хэш поля и несколько сравнений.
+    class OpeningBook
+    {
+    public:
+        // Бросает std::runtime_error, если файла нет или он не книга классических правил
+        explicit OpeningBook(const std::string& path);
+
+        OpeningBook(const OpeningBook&) = delete;
+        OpeningBook& operator=(const OpeningBook&) = delete;
+
+        std::optional<Position> Lookup(const ShotBoard& board) const;
+
+        std::size_t Size() const { return m_header->moves; }
+        int Depth() const { return static_cast<int>(m_header->depth); }
+        std::size_t Bytes() const { return m_region.get_size(); }
+
+        // Хэш Зобриста позиции: XOR ключей (клетка, состояние), ноль не бывает
+        static std::uint64_t Key(const ShotBoard& board);
+
+        // Дебютное дерево: из каждой позиции стреляем в клетку, где корабль стоит в наибольшем
+        // числе расстановок, согласных с позицией; исходы (промах, попадание, потопление)
+        // ведут в дочерние позиции. Детерминировано при одинаковых options
+        static std::vector<OpeningMove> Build(const OpeningBookOptions& options);
+        // Бросает std::runtime_error, если файл не записался
+        static void Write(const std::string& path, const std::vector<OpeningMove>& moves, const OpeningBookOptions& options);
+
+    private:
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t rules;        // размеры поля и состав флота, см. RulesKey
+            std::uint32_t slots;        // степень двойки
+            std::uint32_t moves;
+            std::uint32_t depth;
+            std::uint32_t samples;
+        };
+
+        // Пустой слот - key == 0
+        struct Slot
+        {
+            std::uint64_t key;
+            std::uint8_t cell;
+            std::uint8_t reserved[7];
+        };
+
+        static std::uint32_t RulesKey();
+
+        boost::interprocess::file_mapping m_file;
+        boost::interprocess::mapped_region m_region;
+        const Header* m_header = nullptr;
+        const Slot* m_slots = nullptr;
+        std::uint64_t m_mask = 0;
+    };
+
+    // Стреляет по книге, пока позиция в ней есть, дальше - как fallback
+    class BookStrategy : public IShotStrategy
+    {
+    public:
+        BookStrategy(std::shared_ptr<const OpeningBook> book, std::unique_ptr<IShotStrategy> fallback);
+
+        std::string_view Name() const override { return "book"; }
+        Position NextShot(const ShotBoard& board, std::mt19937& gen) override;
+
+    private:
+        std::shared_ptr<const OpeningBook> m_book;
+        std::unique_ptr<IShotStrategy> m_fallback;
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "GameModel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SeaBattle
+{
+    struct ReplayShot
+    {
+        std::int8_t player = 0;
+        std::int8_t row = 0;
+        std::int8_t col = 0;
+    };
+
+    // Записанная партия с быстрой перемоткой. Каждые checkpointInterval ходов хранится
+    // копия модели (она целиком лежит в объекте, копия - один memcpy), поэтому переход
+    // к любому ходу - восстановление ближайшей контрольной точки и не больше
+    // checkpointInterval - 1 выстрелов. Шаг вперёд от текущей позиции - один выстрел.
+    template <typename R>
+    class BasicReplay
+    {
+    public:
+        using Model = BasicGameModel<R>;
+
+        static constexpr int DefaultCheckpointInterval = 8;
+
+        // start - позиция до первого выстрела. Бросает std::invalid_argument, если какой-то
+        // выстрел недопустим в своей позиции (не его ход, клетка уже обстреляна, игра окончена)
+        BasicReplay(const Model& start, std::vector<ReplayShot> shots, int checkpointInterval = DefaultCheckpointInterval);
+
+        int MoveCount() const { return static_cast<int>(m_shots.size()); }
+        // Сколько выстрелов применено к текущей позиции
+        int Position() const { return m_position; }
+        const ReplayShot& Shot(int move) const { return m_shots[static_cast<std::size_t>(move)]; }
+        const Model& Current() const { return m_current; }
+
+        // Позиция после move выстрелов; move ограничивается диапазоном [0, MoveCount()]
+        const Model& Seek(int move);
+
+    private:
+        void apply(int move);
+
+        std::vector<ReplayShot> m_shots;
+        std::vector<Model> m_checkpoints;   // m_checkpoints[i] - позиция после i * m_interval выстрелов
+        int m_interval;
+        Model m_current;
+        int m_position = 0;
+    };
+
+    template <typename R>
+    BasicReplay<R>::BasicReplay(const Model& start, std::vector<ReplayShot> shots, int checkpointInterval)
+        : m_shots(std::move(shots))
+        , m_interval(checkpointInterval > 0 ? checkpointInterval : DefaultCheckpointInterval)
+        , m_current(start)
+    {
+        m_checkpoints.reserve(m_shots.size() / static_cast<std::size_t>(m_interval) + 1);
+        for (int move = 0; move < MoveCount(); ++move)
+        {
+            if (move % m_interval == 0)
+            {
+                m_checkpoints.push_back(m_current);
+            }
+            const ReplayShot& shot = m_shots[static_cast<std::size_t>(move)];
+            if (!m_current.IsValidShot(shot.player, shot.row, shot.col))
+            {
+                throw std::invalid_argument("Replay shot " + std::to_string(move + 1) + " is not valid");
+            }
+            m_current.ProcessShot(shot.player, shot.row, shot.col);
+        }
+        if (MoveCount() % m_interval == 0)
+        {
+            m_checkpoints.push_back(m_current);
+        }
+        m_position = MoveCount();
+        Seek(0);
+    }
+
+    template <typename R>
+    const typename BasicReplay<R>::Model& BasicReplay<R>::Seek(int move)
+    {
+        move = std::clamp(move, 0, MoveCount());
+
+        // Вперёд в пределах того же отрезка между контрольными точками - просто доигрываем
+        if (move < m_position || move / m_interval != m_position / m_interval)
+        {
+            m_position = move / m_interval * m_interval;
+            m_current = m_checkpoints[static_cast<std::size_t>(move / m_interval)];
+        }
+        while (m_position < move)
+        {
+            apply(m_position++);
+        }
+        return m_current;
+    }
+
+    template <typename R>
+    void BasicReplay<R>::apply(int move)
+    {
+        const ReplayShot& shot = m_shots[static_cast<std::size_t>(move)];
+        m_current.ProcessShot(shot.player, shot.row, shot.col);
+    }
+
+    using Replay = BasicReplay<ClassicRules>;
+}
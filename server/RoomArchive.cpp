@@ -0,0 +1,34 @@
+#include "RoomArchive.h"
+
+#include <stdexcept>
+
+namespace SeaBattle
+{
+    RoomArchive::RoomArchive(const std::string& path)
+        : m_out(path, std::ios::app)
+    {
+        if (!m_out)
+        {
+            throw std::runtime_error("cannot open room archive '" + path + "'");
+        }
+    }
+
+    void RoomArchive::Write(const std::string& line)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_out << line << '\n';
+        ++m_games;
+    }
+
+    void RoomArchive::Flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_out.flush();
+    }
+
+    std::uint64_t RoomArchive::Games() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_games;
+    }
+}
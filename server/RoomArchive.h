@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace SeaBattle
+{
+    // Архив вытесненных и законченных партий: по строке JSON на партию (флоты и выстрелы) в конец
+    // файла. Запись буферизована, файл дописывается при Flush и при уничтожении архива.
+    // Потокобезопасно: строки пишут strand'ы разных комнат
+    class RoomArchive
+    {
+    public:
+        // Бросает std::runtime_error, если файл не открывается на дозапись
+        explicit RoomArchive(const std::string& path);
+
+        void Write(const std::string& line);
+        void Flush();
+
+        std::uint64_t Games() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::ofstream m_out;
+        std::uint64_t m_games = 0;
+    };
+}
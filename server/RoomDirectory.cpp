@@ -0,0 +1,302 @@
+#include "RoomDirectory.h"
+
+#ifdef _WIN32
+#include <process.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace SeaBattle
+{
+    namespace
+    {
+        std::uint64_t packOwner(RoomOwner owner)
+        {
+            // Нулевое значение зарезервировано под "ещё не записан"
+            return (static_cast<std::uint64_t>(owner.pid) << 32) | (std::uint64_t{ owner.port } << 1) | 1;
+        }
+
+        RoomOwner unpackOwner(std::uint64_t value)
+        {
+            return { static_cast<std::uint32_t>(value >> 32), static_cast<std::uint16_t>((value >> 1) & 0xFFFF) };
+        }
+    }
+
+    RoomDirectory::RoomDirectory(const std::string& name, std::size_t capacity)
+        : m_name(name)
+        , m_memory(boost::interprocess::open_or_create, name.c_str(), boost::interprocess::read_write)
+        , m_capacity(capacity)
+    {
+        const auto size = static_cast<boost::interprocess::offset_t>(sizeof(Header) + capacity * sizeof(Slot));
+        boost::interprocess::offset_t currentSize = 0;
+        if (!m_memory.get_size(currentSize) || currentSize < size)
+        {
+            m_memory.truncate(size);
+        }
+
+        m_region = boost::interprocess::mapped_region(m_memory, boost::interprocess::read_write, 0, static_cast<std::size_t>(size));
+        m_header = static_cast<Header*>(m_region.get_address());
+        m_slots = reinterpret_cast<Slot*>(m_header + 1);
+
+        // Отмечаемся среди процессов каталога: свободное место или место упавшего процесса
+        const std::uint32_t self = CurrentProcessId();
+        for (auto& process : m_header->processes)
+        {
+            std::uint32_t current = process.load(std::memory_order_acquire);
+            if ((current == 0 || current == self || !IsAlive(current))
+                && process.compare_exchange_strong(current, self, std::memory_order_acq_rel))
+            {
+                m_attached = &process;
+                break;
+            }
+        }
+    }
+
+    RoomDirectory::~RoomDirectory()
+    {
+        // Последний живой процесс убирает сегмент; если отметиться не удалось (процессов больше
+        // MaxProcesses), сегмент остаётся до ручного удаления
+        if (!m_attached)
+        {
+            return;
+        }
+        m_attached->store(0, std::memory_order_release);
+        for (const auto& process : m_header->processes)
+        {
+            const std::uint32_t pid = process.load(std::memory_order_acquire);
+            if (pid != 0 && IsAlive(pid))
+            {
+                return;
+            }
+        }
+        m_region = {};
+        boost::interprocess::shared_memory_object::remove(m_name.c_str());
+    }
+
+    std::uint64_t RoomDirectory::AllocateRoomId()
+    {
+        return m_header->nextRoomId.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    bool RoomDirectory::Register(std::uint64_t roomId, RoomOwner owner)
+    {
+        const std::size_t home = slotIndex(roomId);
+        std::size_t index = home;
+        for (std::size_t probe = 0; probe < m_capacity; ++probe, index = (index + 1) % m_capacity)
+        {
+            Slot& slot = m_slots[index];
+            std::uint64_t current = slot.roomId.load(std::memory_order_acquire);
+            if (current == roomId)
+            {
+                slot.owner.store(packOwner(owner), std::memory_order_release);
+                return true;
+            }
+            if ((current == EmptySlot || current == DeletedSlot)
+                && slot.roomId.compare_exchange_strong(current, roomId))
+            {
+                // Пройденный слот могли освободить до пустого (freeSlot), пока мы шли дальше, -
+                // тогда Lookup остановится на нём и нас не найдёт: встаём заново
+                for (std::size_t passed = home; passed != index; passed = (passed + 1) % m_capacity)
+                {
+                    if (m_slots[passed].roomId.load() == EmptySlot)
+                    {
+                        freeSlot(index);
+                        return Register(roomId, owner);
+                    }
+                }
+                slot.owner.store(packOwner(owner), std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::optional<RoomOwner> RoomDirectory::Lookup(std::uint64_t roomId)
+    {
+        std::size_t index = slotIndex(roomId);
+        for (std::size_t probe = 0; probe < m_capacity; ++probe, index = (index + 1) % m_capacity)
+        {
+            Slot& slot = m_slots[index];
+            std::uint64_t current = slot.roomId.load(std::memory_order_acquire);
+            if (current == EmptySlot)
+            {
+                break;
+            }
+            if (current == roomId)
+            {
+                std::uint64_t owner = slot.owner.load(std::memory_order_acquire);
+                if (owner == 0)
+                {
+                    // Владелец ещё регистрирует комнату
+                    break;
+                }
+                const RoomOwner unpacked = unpackOwner(owner);
+                if (!IsAlive(unpacked.pid))
+                {
+                    // Процесс упал, не убрав свои комнаты: перенаправлять некуда
+                    releaseSlot(index, owner);
+                    ClaimOpenRoom(roomId);
+                    break;
+                }
+                return unpacked;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void RoomDirectory::Unregister(std::uint64_t roomId)
+    {
+        std::size_t index = slotIndex(roomId);
+        for (std::size_t probe = 0; probe < m_capacity; ++probe, index = (index + 1) % m_capacity)
+        {
+            Slot& slot = m_slots[index];
+            std::uint64_t current = slot.roomId.load(std::memory_order_acquire);
+            if (current == EmptySlot)
+            {
+                return;
+            }
+            if (current == roomId)
+            {
+                slot.owner.store(0, std::memory_order_release);
+                freeSlot(index);
+                return;
+            }
+        }
+    }
+
+    std::size_t RoomDirectory::RemoveDeadOwners()
+    {
+        const std::uint32_t self = CurrentProcessId();
+        std::size_t removed = 0;
+        for (std::size_t index = 0; index < m_capacity; ++index)
+        {
+            Slot& slot = m_slots[index];
+            const std::uint64_t current = slot.roomId.load(std::memory_order_acquire);
+            const std::uint64_t owner = slot.owner.load(std::memory_order_acquire);
+            if (current == EmptySlot || current == DeletedSlot || owner == 0)
+            {
+                continue;
+            }
+            const std::uint32_t pid = unpackOwner(owner).pid;
+            if (pid == self || !IsAlive(pid))
+            {
+                releaseSlot(index, owner);
+                ClaimOpenRoom(current);
+                ++removed;
+            }
+        }
+        // Ожидающая комната, которой в каталоге уже нет
+        if (const std::uint64_t open = m_header->openRoomId.load(std::memory_order_acquire); open != 0 && !Lookup(open))
+        {
+            ClaimOpenRoom(open);
+        }
+        return removed;
+    }
+
+    bool RoomDirectory::PublishOpenRoom(std::uint64_t roomId)
+    {
+        std::uint64_t expected = 0;
+        return m_header->openRoomId.compare_exchange_strong(expected, roomId, std::memory_order_acq_rel);
+    }
+
+    bool RoomDirectory::ClaimOpenRoom(std::uint64_t roomId)
+    {
+        return m_header->openRoomId.compare_exchange_strong(roomId, 0, std::memory_order_acq_rel);
+    }
+
+    std::optional<PendingRoom> RoomDirectory::TakeOpenRoom()
+    {
+        for (;;)
+        {
+            const std::uint64_t roomId = m_header->openRoomId.load(std::memory_order_acquire);
+            if (roomId == 0)
+            {
+                return std::nullopt;
+            }
+            // Комната мёртвого процесса снимается в Lookup, тогда берём следующую
+            const auto owner = Lookup(roomId);
+            if (ClaimOpenRoom(roomId) && owner)
+            {
+                return PendingRoom{ roomId, *owner };
+            }
+        }
+    }
+
+    std::uint32_t RoomDirectory::CurrentProcessId()
+    {
+#ifdef _WIN32
+        return static_cast<std::uint32_t>(_getpid());
+#else
+        return static_cast<std::uint32_t>(getpid());
+#endif
+    }
+
+    bool RoomDirectory::IsAlive(std::uint32_t pid)
+    {
+#ifdef _WIN32
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!process)
+        {
+            return GetLastError() == ERROR_ACCESS_DENIED;
+        }
+        DWORD code = 0;
+        const bool running = GetExitCodeProcess(process, &code) && code == STILL_ACTIVE;
+        CloseHandle(process);
+        return running;
+#else
+        // EPERM - процесс есть, но чужой: pid занят, считаем владельца живым
+        return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+    }
+
+    void RoomDirectory::releaseSlot(std::size_t index, std::uint64_t owner)
+    {
+        if (m_slots[index].owner.compare_exchange_strong(owner, 0, std::memory_order_acq_rel))
+        {
+            freeSlot(index);
+        }
+    }
+
+    void RoomDirectory::freeSlot(std::size_t index)
+    {
+        // Надгробие нужно, только если за слотом цепочка продолжается. Если следующий слот пуст,
+        // слот становится пустым, а за ним - и надгробия перед ним: иначе id комнат растут, пустых
+        // слотов не остаётся, и каждый промах Lookup обходит всю таблицу.
+        // Следующий слот проверяется и до, и после: Register, занявший его в промежутке, либо
+        // увидит наш пустой слот и встанет заново, либо мы увидим его и вернём надгробие
+        m_slots[index].roomId.store(DeletedSlot);
+        for (std::size_t probe = 0; probe < m_capacity; ++probe)
+        {
+            Slot& next = m_slots[(index + 1) % m_capacity];
+            std::uint64_t deleted = DeletedSlot;
+            if (next.roomId.load() != EmptySlot || !m_slots[index].roomId.compare_exchange_strong(deleted, EmptySlot))
+            {
+                return;
+            }
+            if (next.roomId.load() != EmptySlot)
+            {
+                std::uint64_t empty = EmptySlot;
+                m_slots[index].roomId.compare_exchange_strong(empty, DeletedSlot);
+                return;
+            }
+            index = (index + m_capacity - 1) % m_capacity;
+            if (m_slots[index].roomId.load() != DeletedSlot)
+            {
+                return;
+            }
+        }
+    }
+
+    std::size_t RoomDirectory::slotIndex(std::uint64_t roomId) const
+    {
+        // Перемешивание битов (splitmix64), чтобы последовательные id не слипались в кластеры
+        std::uint64_t x = roomId + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return static_cast<std::size_t>(x % m_capacity);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace SeaBattle
+{
+    // Процесс-владелец комнаты: по этому адресу принимаются подключения к ней
+    struct RoomOwner
+    {
+        std::uint32_t pid = 0;
+        std::uint16_t port = 0;
+    };
+
+    // Комната, ожидающая второго игрока, и её владелец
+    struct PendingRoom
+    {
+        std::uint64_t roomId = 0;
+        RoomOwner owner;
+    };
+
+    // Каталог комнат в разделяемой памяти, общий для всех процессов сервера на одном хосте.
+    // Хранит соответствие id комнаты -> процесс-владелец и выдаёт уникальные id комнат. Записи
+    // упавших процессов не отдаются: владелец проверяется на живость и его записи убираются.
+    // Ещё в каталоге одна ожидающая соперника комната - общая очередь подбора для всех процессов.
+    // Сегмент удаляет последний завершившийся процесс; после падения всех процессов он остаётся
+    // (/dev/shm/<name> на Linux) и подхватывается следующим запуском.
+    // Таблица с открытой адресацией на атомиках, без блокировок: нулевая память - пустой каталог,
+    // поэтому первый процесс не должен её инициализировать.
+    class RoomDirectory
+    {
+    public:
+        RoomDirectory(const std::string& name, std::size_t capacity);
+        ~RoomDirectory();
+
+        RoomDirectory(const RoomDirectory&) = delete;
+        RoomDirectory& operator=(const RoomDirectory&) = delete;
+
+        std::uint64_t AllocateRoomId();
+        bool Register(std::uint64_t roomId, RoomOwner owner);
+        std::optional<RoomOwner> Lookup(std::uint64_t roomId);
+        void Unregister(std::uint64_t roomId);
+        // Убирает записи процессов, которых уже нет (и прежнего процесса с нашим pid); при старте
+        std::size_t RemoveDeadOwners();
+
+        // Ожидающая комната: Publish - если сейчас никакая не ожидает; место в ней достаётся
+        // тому, кто снимет её первым (Claim - свою по id, Take - любую живую)
+        bool PublishOpenRoom(std::uint64_t roomId);
+        bool ClaimOpenRoom(std::uint64_t roomId);
+        std::optional<PendingRoom> TakeOpenRoom();
+
+        static std::uint32_t CurrentProcessId();
+        static bool IsAlive(std::uint32_t pid);
+
+    private:
+        // Сколько процессов отмечается в каталоге (для удаления сегмента последним из них)
+        static constexpr std::size_t MaxProcesses = 64;
+
+        struct Header
+        {
+            std::atomic<std::uint64_t> nextRoomId;
+            std::atomic<std::uint64_t> openRoomId; // 0 - никто не ожидает
+            std::atomic<std::uint32_t> processes[MaxProcesses]; // pid подключённых процессов, 0 - свободно
+        };
+
+        struct Slot
+        {
+            std::atomic<std::uint64_t> roomId;
+            std::atomic<std::uint64_t> owner;
+        };
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+            "room directory requires lock-free 64-bit atomics to be shared between processes");
+
+        static constexpr std::uint64_t EmptySlot = 0;
+        static constexpr std::uint64_t DeletedSlot = ~std::uint64_t{ 0 };
+
+        std::size_t slotIndex(std::uint64_t roomId) const;
+        // Освобождает слот, если в нём всё ещё запись owner
+        void releaseSlot(std::size_t index, std::uint64_t owner);
+        // Слот без записи: надгробие или, если на нём цепочка кончается, пустой
+        void freeSlot(std::size_t index);
+
+        std::string m_name;
+        boost::interprocess::shared_memory_object m_memory;
+        boost::interprocess::mapped_region m_region;
+        Header* m_header = nullptr;
+        Slot* m_slots = nullptr;
+        std::size_t m_capacity = 0;
+        std::atomic<std::uint32_t>* m_attached = nullptr; // наше место в Header::processes
+    };
+}
@@ -0,0 +1,426 @@
+#include "ServerConfig.h"
+
+#include <nlohmann/json.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace SeaBattle
+{
+    namespace
+    {
+        // Потолок сроков в секундах: с запасом до переполнения часов, считающих в наносекундах
+        constexpr long long MaxSeconds = 10LL * 365 * 24 * 3600;
+
+        template <typename T, typename V>
+        T checkRange(std::string_view name, V value, T min, T max, std::string_view text)
+        {
+            if (std::cmp_less(value, min) || std::cmp_greater(value, max))
+            {
+                throw std::invalid_argument(std::string(name) + " must be from " + std::to_string(min) + " to "
+                    + std::to_string(max) + ", got '" + std::string(text) + "'");
+            }
+            return static_cast<T>(value);
+        }
+
+        // Целое из командной строки: вся строка - число в [min, max]. Без stoul, который
+        // молча заворачивает "-1" в 4294967295
+        template <typename T>
+        T parseNumber(std::string_view name, std::string_view value, T min, T max = std::numeric_limits<T>::max())
+        {
+            const char* end = value.data() + value.size();
+            if (!value.empty() && value.front() == '-')
+            {
+                std::int64_t number = 0;
+                auto [ptr, ec] = std::from_chars(value.data(), end, number);
+                if (ec == std::errc() && ptr == end)
+                {
+                    return checkRange(name, number, min, max, value);
+                }
+            }
+            else
+            {
+                std::uint64_t number = 0;
+                auto [ptr, ec] = std::from_chars(value.data(), end, number);
+                if (ec == std::errc() && ptr == end)
+                {
+                    return checkRange(name, number, min, max, value);
+                }
+            }
+            throw std::invalid_argument(std::string(name) + " expects an integer from " + std::to_string(min) + " to "
+                + std::to_string(max) + ", got '" + std::string(value) + "'");
+        }
+
+        // То же для ключа JSON-файла; нет ключа - current
+        template <typename T>
+        T jsonNumber(const nlohmann::json& json, const char* key, T current, T min, T max = std::numeric_limits<T>::max())
+        {
+            if (!json.contains(key))
+            {
+                return current;
+            }
+            const auto& value = json[key];
+            if (value.is_number_unsigned())
+            {
+                return checkRange(key, value.get<std::uint64_t>(), min, max, value.dump());
+            }
+            if (value.is_number_integer())
+            {
+                return checkRange(key, value.get<std::int64_t>(), min, max, value.dump());
+            }
+            throw std::invalid_argument(std::string(key) + " must be an integer, got " + value.dump());
+        }
+
+        ListenEndpoint parseEndpoint(const std::string& value)
+        {
+            // address:port, для IPv6 - [address]:port
+            auto colon = value.rfind(':');
+            if (colon == std::string::npos || colon == 0 || colon + 1 == value.size())
+            {
+                throw std::invalid_argument("listen endpoint must be address:port, got '" + value + "'");
+            }
+            std::string address = value.substr(0, colon);
+            if (address.size() > 2 && address.front() == '[' && address.back() == ']')
+            {
+                address = address.substr(1, address.size() - 2);
+            }
+            const auto port = parseNumber<unsigned short>("listen port in '" + value + "'", value.substr(colon + 1), 0);
+            return { address, port };
+        }
+
+        // Имена вариантов через separator - из того же списка, по которому их разбирает ParseGameMode
+        std::string modeNames(std::string_view separator)
+        {
+            std::string names;
+            for (GameMode mode : GameModes)
+            {
+                if (!names.empty())
+                {
+                    names += separator;
+                }
+                names += ToString(mode);
+            }
+            return names;
+        }
+
+        GameMode parseMode(const std::string& value)
+        {
+            auto mode = ParseGameMode(value);
+            if (!mode)
+            {
+                throw std::invalid_argument("unknown game mode '" + value + "', expected one of " + modeNames(", "));
+            }
+            return *mode;
+        }
+
+        bool parseSwitch(std::string_view value)
+        {
+            if (value == "on" || value == "true" || value == "1")
+            {
+                return true;
+            }
+            if (value == "off" || value == "false" || value == "0")
+            {
+                return false;
+            }
+            throw std::invalid_argument("expected on/off, got '" + std::string(value) + "'");
+        }
+    }
+
+    void ServerConfig::LoadFile(const std::string& path)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            throw std::invalid_argument("cannot open config file '" + path + "'");
+        }
+
+        nlohmann::json json;
+        try
+        {
+            json = nlohmann::json::parse(in);
+        }
+        catch (const nlohmann::json::exception& ex)
+        {
+            throw std::invalid_argument("config file '" + path + "': " + ex.what());
+        }
+
+        try
+        {
+            if (json.contains("mode"))
+            {
+                mode = parseMode(json["mode"].get<std::string>());
+            }
+            if (json.contains("listen"))
+            {
+                listen.clear();
+                for (const auto& endpoint : json["listen"])
+                {
+                    listen.push_back(parseEndpoint(endpoint.get<std::string>()));
+                }
+            }
+            if (json.contains("adminListen"))
+            {
+                adminListen = parseEndpoint(json["adminListen"].get<std::string>());
+            }
+            threads = jsonNumber(json, "threads", threads, 1u);
+            backlog = jsonNumber(json, "backlog", backlog, 0);
+            tcpNoDelay = json.value("tcpNoDelay", tcpNoDelay);
+            sendBufferSize = jsonNumber(json, "sendBufferSize", sendBufferSize, 0);
+            receiveBufferSize = jsonNumber(json, "receiveBufferSize", receiveBufferSize, 0);
+            maxMessageSize = jsonNumber<std::size_t>(json, "maxMessageSize", maxMessageSize, 1024);
+            handshakeTimeout = std::chrono::seconds(jsonNumber<long long>(json, "handshakeTimeoutSec", handshakeTimeout.count(), 1, MaxSeconds));
+            idleTimeout = std::chrono::seconds(jsonNumber<long long>(json, "idleTimeoutSec", idleTimeout.count(), 1, MaxSeconds));
+            fleetPoolSize = jsonNumber<std::size_t>(json, "fleetPoolSize", fleetPoolSize, 0);
+            traceFile = json.value("traceFile", traceFile);
+            botThreads = jsonNumber(json, "botThreads", botThreads, 0u);
+            botCpuShare = json.value("botCpuShare", botCpuShare);
+            botMoveDeadline = std::chrono::milliseconds(jsonNumber<long long>(json, "botMoveDeadlineMs", botMoveDeadline.count(), 0, MaxSeconds * 1000));
+            turnTimeout = std::chrono::seconds(jsonNumber<long long>(json, "turnTimeoutSec", turnTimeout.count(), 0, MaxSeconds));
+            gameTimeout = std::chrono::seconds(jsonNumber<long long>(json, "gameTimeoutSec", gameTimeout.count(), 0, MaxSeconds));
+            roomMemoryLimit = jsonNumber<std::size_t>(json, "roomMemoryMb", roomMemoryLimit >> 20, 0, std::numeric_limits<std::size_t>::max() >> 20) << 20;
+            roomTtl = std::chrono::seconds(jsonNumber<long long>(json, "roomTtlSec", roomTtl.count(), 0, MaxSeconds));
+            archiveFile = json.value("archiveFile", archiveFile);
+            analyticsInterval = std::chrono::seconds(jsonNumber<long long>(json, "analyticsIntervalSec", analyticsInterval.count(), 0, MaxSeconds));
+            openingBook = json.value("openingBook", openingBook);
+            unixSocket = json.value("unixSocket", unixSocket);
+        }
+        catch (const nlohmann::json::exception& ex)
+        {
+            throw std::invalid_argument("config file '" + path + "': " + ex.what());
+        }
+        catch (const std::invalid_argument& ex)
+        {
+            throw std::invalid_argument("config file '" + path + "': " + ex.what());
+        }
+    }
+
+    void ServerConfig::ParseCommandLine(int argc, char* argv[])
+    {
+        bool listenFromCommandLine = false;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("missing value for '" + std::string(arg) + "'");
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--config")
+            {
+                LoadFile(value);
+            }
+            else if (arg == "--mode")
+            {
+                mode = parseMode(value);
+            }
+            else if (arg == "--listen")
+            {
+                // Первый --listen заменяет адреса по умолчанию, следующие добавляются
+                if (!listenFromCommandLine)
+                {
+                    listen.clear();
+                    listenFromCommandLine = true;
+                }
+                listen.push_back(parseEndpoint(value));
+            }
+            else if (arg == "--threads")
+            {
+                threads = parseNumber(arg, value, 1u);
+            }
+            else if (arg == "--backlog")
+            {
+                backlog = parseNumber(arg, value, 0);
+            }
+            else if (arg == "--tcp-nodelay")
+            {
+                tcpNoDelay = parseSwitch(value);
+            }
+            else if (arg == "--send-buffer")
+            {
+                sendBufferSize = parseNumber(arg, value, 0);
+            }
+            else if (arg == "--recv-buffer")
+            {
+                receiveBufferSize = parseNumber(arg, value, 0);
+            }
+            else if (arg == "--max-message")
+            {
+                maxMessageSize = parseNumber<std::size_t>(arg, value, 1024);
+            }
+            else if (arg == "--handshake-timeout")
+            {
+                handshakeTimeout = std::chrono::seconds(parseNumber(arg, value, 1LL, MaxSeconds));
+            }
+            else if (arg == "--idle-timeout")
+            {
+                idleTimeout = std::chrono::seconds(parseNumber(arg, value, 1LL, MaxSeconds));
+            }
+            else if (arg == "--fleet-pool")
+            {
+                fleetPoolSize = parseNumber<std::size_t>(arg, value, 0);
+            }
+            else if (arg == "--trace")
+            {
+                traceFile = value;
+            }
+            else if (arg == "--bot-threads")
+            {
+                botThreads = parseNumber(arg, value, 0u);
+            }
+            else if (arg == "--bot-cpu")
+            {
+                botCpuShare = std::stod(value);
+            }
+            else if (arg == "--bot-deadline")
+            {
+                botMoveDeadline = std::chrono::milliseconds(parseNumber(arg, value, 0LL, MaxSeconds * 1000));
+            }
+            else if (arg == "--turn-timeout")
+            {
+                turnTimeout = std::chrono::seconds(parseNumber(arg, value, 0LL, MaxSeconds));
+            }
+            else if (arg == "--game-timeout")
+            {
+                gameTimeout = std::chrono::seconds(parseNumber(arg, value, 0LL, MaxSeconds));
+            }
+            else if (arg == "--room-memory")
+            {
+                roomMemoryLimit = parseNumber<std::size_t>(arg, value, 0, std::numeric_limits<std::size_t>::max() >> 20) << 20;
+            }
+            else if (arg == "--room-ttl")
+            {
+                roomTtl = std::chrono::seconds(parseNumber(arg, value, 0LL, MaxSeconds));
+            }
+            else if (arg == "--archive")
+            {
+                archiveFile = value;
+            }
+            else if (arg == "--analytics-interval")
+            {
+                analyticsInterval = std::chrono::seconds(parseNumber(arg, value, 0LL, MaxSeconds));
+            }
+            else if (arg == "--opening-book")
+            {
+                openingBook = value;
+            }
+            else if (arg == "--unix-socket")
+            {
+                unixSocket = value;
+            }
+            else if (arg == "--admin-listen")
+            {
+                adminListen = parseEndpoint(value);
+            }
+            else
+            {
+                throw std::invalid_argument("unknown option '" + std::string(arg) + "'");
+            }
+        }
+    }
+
+    void ServerConfig::Validate() const
+    {
+        if (listen.empty())
+        {
+            throw std::invalid_argument("at least one listen endpoint is required");
+        }
+        if (threads == 0)
+        {
+            throw std::invalid_argument("threads must be positive");
+        }
+        if (backlog < 0 || sendBufferSize < 0 || receiveBufferSize < 0)
+        {
+            throw std::invalid_argument("backlog and socket buffer sizes must not be negative");
+        }
+        if (maxMessageSize < 1024)
+        {
+            throw std::invalid_argument("maxMessageSize must be at least 1024 bytes");
+        }
+        if (handshakeTimeout.count() <= 0 || idleTimeout.count() <= 0)
+        {
+            throw std::invalid_argument("timeouts must be positive");
+        }
+        if (botThreads > 0 && (!(botCpuShare > 0.0) || botMoveDeadline.count() <= 0))
+        {
+            throw std::invalid_argument("bot cpu share and move deadline must be positive");
+        }
+        if (turnTimeout.count() < 0 || gameTimeout.count() < 0)
+        {
+            throw std::invalid_argument("turn and game timeouts must not be negative");
+        }
+        if (roomTtl.count() < 0)
+        {
+            throw std::invalid_argument("room ttl must not be negative");
+        }
+        if (analyticsInterval.count() < 0)
+        {
+            throw std::invalid_argument("analytics interval must not be negative");
+        }
+        if (!openingBook.empty() && mode != GameMode::Classic)
+        {
+            throw std::invalid_argument("opening book is built for classic mode only");
+        }
+    }
+
+    void ServerConfig::Print(std::ostream& out) const
+    {
+        out << "[server] config: mode=" << ToString(mode) << " threads=" << threads
+            << " backlog=" << (backlog == 0 ? std::string("max") : std::to_string(backlog)) << "\n";
+        for (const auto& endpoint : listen)
+        {
+            out << "[server] config: listen " << endpoint.address << ":" << endpoint.port << "\n";
+        }
+        if (!unixSocket.empty())
+        {
+            out << "[server] config: listen unix:" << unixSocket << "\n";
+        }
+        if (adminListen)
+        {
+            out << "[server] config: admin " << adminListen->address << ":" << adminListen->port << "\n";
+        }
+        out << "[server] config: tcpNoDelay=" << (tcpNoDelay ? "on" : "off")
+            << " sendBuffer=" << (sendBufferSize == 0 ? std::string("system") : std::to_string(sendBufferSize))
+            << " recvBuffer=" << (receiveBufferSize == 0 ? std::string("system") : std::to_string(receiveBufferSize))
+            << "\n";
+        out << "[server] config: maxMessage=" << maxMessageSize
+            << " handshakeTimeout=" << handshakeTimeout.count() << "s"
+            << " idleTimeout=" << idleTimeout.count() << "s"
+            << " fleetPool=" << fleetPoolSize
+            << " trace=" << (traceFile.empty() ? std::string("off") : traceFile) << "\n";
+        out << "[server] config: roomMemory=" << (roomMemoryLimit == 0 ? std::string("unlimited") : std::to_string(roomMemoryLimit >> 20) + "MiB")
+            << " roomTtl=" << (roomTtl.count() == 0 ? std::string("off") : std::to_string(roomTtl.count()) + "s")
+            << " archive=" << (archiveFile.empty() ? std::string("off") : archiveFile) << "\n";
+        out << "[server] config: bots=" << (botThreads == 0 || mode != GameMode::Classic ? std::string("off") : std::to_string(botThreads) + " threads")
+            << " botCpu=" << botCpuShare << " botDeadline=" << botMoveDeadline.count() << "ms"
+            << " openingBook=" << (openingBook.empty() ? std::string("off") : openingBook)
+            << " turnTimeout=" << (turnTimeout.count() == 0 ? std::string("off") : std::to_string(turnTimeout.count()) + "s")
+            << " gameTimeout=" << (gameTimeout.count() == 0 ? std::string("off") : std::to_string(gameTimeout.count()) + "s")
+            << " analytics=" << (analyticsInterval.count() == 0 ? std::string("off") : std::to_string(analyticsInterval.count()) + "s") << std::endl;
+    }
+
+    void ServerConfig::PrintUsage(std::ostream& out)
+    {
+        out << "usage: server [--config FILE] [--mode " << modeNames("|") << "]\n"
+               "              [--listen ADDRESS:PORT]... [--unix-socket PATH] [--threads N] [--backlog N]\n"
+               "              [--tcp-nodelay on|off] [--send-buffer BYTES] [--recv-buffer BYTES]\n"
+               "              [--max-message BYTES] [--handshake-timeout SEC] [--idle-timeout SEC]\n"
+               "              [--fleet-pool N] [--trace FILE] [--bot-threads N] [--bot-cpu SHARE]\n"
+               "              [--bot-deadline MS] [--opening-book FILE] [--analytics-interval SEC]\n"
+               "              [--turn-timeout SEC] [--game-timeout SEC] [--room-memory MB] [--room-ttl SEC]\n"
+               "              [--archive FILE] [--admin-listen ADDRESS:PORT]\n"
+               "config file: JSON object with keys mode, listen (array of \"address:port\"), unixSocket,\n"
+               "             threads, backlog, tcpNoDelay, sendBufferSize, receiveBufferSize, maxMessageSize,\n"
+               "             handshakeTimeoutSec, idleTimeoutSec, fleetPoolSize, traceFile,\n"
+               "             botThreads, botCpuShare, botMoveDeadlineMs, openingBook, analyticsIntervalSec,\n"
+               "             turnTimeoutSec, gameTimeoutSec, roomMemoryMb, roomTtlSec, archiveFile,\n"
+               "             adminListen (\"address:port\")" << std::endl;
+    }
+}
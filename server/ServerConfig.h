@@ -0,0 +1,91 @@
+#pragma once
+
+#include "GameModel.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SeaBattle
+{
+    struct ListenEndpoint
+    {
+        std::string address;
+        unsigned short port = 0;
+    };
+
+    // Настройки сервера. По умолчанию: один поток, 127.0.0.7:1365, рекомендованные Beast таймауты
+    // с keep-alive пингами. Включены и возможности, которых раньше не было: поток ботов, часы
+    // партии (60 с на ход, 15 мин на партию) и вытеснение простаивающих комнат (через 5 мин,
+    // потолок 512 МиБ) - каждая выключается нулём своего параметра.
+    struct ServerConfig
+    {
+        GameMode mode = GameMode::Classic;
+
+        std::vector<ListenEndpoint> listen{ { "127.0.0.7", 1365 } };
+        unsigned threads = 1;
+        int backlog = 0;  // 0 - системный максимум (SOMAXCONN)
+        // Если задан - ещё и unix-сокет по этому пути для клиента на той же машине
+        // (киоски): без TCP и loopback, протокол тот же. Путь - одного процесса: второй
+        // процесс на том же порту должен получить свой
+        std::string unixSocket;
+
+        // Сообщения протокола маленькие (десятки байт): без TCP_NODELAY алгоритм Нейгла
+        // задерживает ответ до подтверждения предыдущего сегмента
+        bool tcpNoDelay = true;
+        int sendBufferSize = 0;     // 0 - не менять системное значение
+        int receiveBufferSize = 0;
+
+        std::size_t maxMessageSize = 64 * 1024;
+        std::chrono::seconds handshakeTimeout{ 30 };
+        std::chrono::seconds idleTimeout{ 300 };
+
+        // Запас готовых расстановок флота (FleetPool); 0 - расставлять при начале партии.
+        // Всплеск из N одновременных партий без промахов требует запаса 2N
+        std::size_t fleetPoolSize = 4096;
+
+        // Если задан - отрезки обработки запросов пишутся в этот файл (Chrome trace-event) при остановке
+        std::string traceFile;
+
+        // Боты в сервере (подключение к "/bot" - партия с ботом сразу, только classic): потоки
+        // с низким приоритетом, доля одного ядра на всех ботов и срок на ход; 0 потоков - ботов нет
+        unsigned botThreads = 1;
+        double botCpuShare = 0.25;
+        std::chrono::milliseconds botMoveDeadline{ 200 };
+
+        // Часы партии: срок на ход (каждый выстрел или залп) и запас времени игрока на всю партию;
+        // истёк любой - игрок проигрывает и отключается. 0 - без ограничения, оба 0 - часов нет
+        std::chrono::seconds turnTimeout{ 60 };
+        std::chrono::seconds gameTimeout{ 900 };
+
+        // Простаивающие комнаты (партия кончилась или все игроки ушли посреди партии) архивируются
+        // и вытесняются: через roomTtl без запросов, а сверх roomMemoryLimit байт на все комнаты -
+        // давно простаивающие первыми; если вытеснять нечего, новые комнаты не создаются.
+        // 0 - без ограничения. Архив (строка JSON на партию) пишется, только если задан archiveFile
+        std::size_t roomMemoryLimit = 512u << 20;
+        std::chrono::seconds roomTtl{ 300 };
+        std::string archiveFile;
+
+        // Период снимков аналитики партий для GET /admin/analytics; 0 - не публиковать
+        std::chrono::seconds analyticsInterval{ 5 };
+        // Адрес админки (GET /admin/analytics и /admin/rooms, без авторизации): отдельный порт,
+        // на игровых адресах её нет. По умолчанию выключена
+        std::optional<ListenEndpoint> adminListen;
+
+        // Книга дебютов ботов (tools/openingbook), отображается в память при старте; только classic
+        std::string openingBook;
+
+        // Загружает JSON-файл настроек поверх текущих значений
+        void LoadFile(const std::string& path);
+        // Разбирает аргументы командной строки; --config применяется в том месте, где встретился
+        void ParseCommandLine(int argc, char* argv[]);
+        // Бросает std::invalid_argument, если настройки противоречивы
+        void Validate() const;
+        void Print(std::ostream& out) const;
+
+        static void PrintUsage(std::ostream& out);
+    };
+}
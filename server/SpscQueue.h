@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace SeaBattle
+{
+    // Кольцо фиксированной ёмкости без блокировок для одного писателя и одного читателя.
+    // Писатель меняет только хвост, читатель - только голову; каждый держит копию чужого
+    // индекса и перечитывает его, лишь когда кольцо кажется полным (пустым).
+    // Ёмкость округляется вверх до степени двойки; T копируется целиком.
+    template <typename T>
+    class SpscQueue
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SpscQueue stores values by copy");
+
+    public:
+        using ValueType = T;
+
+        explicit SpscQueue(std::size_t capacity)
+        {
+            std::size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            m_mask = size - 1;
+            m_values.reset(new T[size]);
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Только писатель; false - кольцо заполнено
+        bool TryPush(const T& value)
+        {
+            const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedHead > m_mask)
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead > m_mask)
+                {
+                    return false;
+                }
+            }
+            m_values[tail & m_mask] = value;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Только читатель; false - кольцо пусто
+        bool TryPop(T& value)
+        {
+            const std::size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_cachedTail)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head == m_cachedTail)
+                {
+                    return false;
+                }
+            }
+            value = m_values[head & m_mask];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Приблизительное число элементов: при одновременных операциях может отставать
+        std::size_t SizeApprox() const
+        {
+            std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            std::size_t head = m_head.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        std::size_t Capacity() const { return m_mask + 1; }
+
+    private:
+        static constexpr std::size_t CacheLine = 64;
+
+        std::unique_ptr<T[]> m_values;
+        std::size_t m_mask = 0;
+        // Поля читателя (голова и копия хвоста) и писателя (хвост и копия головы) - на разных линиях кэша
+        alignas(CacheLine) std::atomic<std::size_t> m_head{ 0 };
+        std::size_t m_cachedTail = 0;
+        alignas(CacheLine) std::atomic<std::size_t> m_tail{ 0 };
+        std::size_t m_cachedHead = 0;
+    };
+}
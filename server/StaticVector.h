@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace SeaBattle
+{
+    // Вектор фиксированной ёмкости с хранением внутри объекта.
+    // Не выделяет память в куче и остаётся тривиально копируемым, если таким является T,
+    // поэтому модели игры можно копировать одним memcpy.
+    template <typename T, std::size_t N>
+    class StaticVector
+    {
+    public:
+        using value_type = T;
+        using size_type = std::conditional_t<(N < 256), std::uint8_t, std::size_t>;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        constexpr StaticVector() = default;
+
+        void push_back(const T& value)
+        {
+            assert(m_size < N);
+            m_data[m_size++] = value;
+        }
+
+        void pop_back()
+        {
+            assert(m_size > 0);
+            --m_size;
+        }
+
+        void clear() { m_size = 0; }
+
+        constexpr std::size_t size() const { return m_size; }
+        constexpr bool empty() const { return m_size == 0; }
+        static constexpr std::size_t capacity() { return N; }
+
+        T& operator[](std::size_t index) { return m_data[index]; }
+        const T& operator[](std::size_t index) const { return m_data[index]; }
+
+        T& back() { return m_data[m_size - 1]; }
+        const T& back() const { return m_data[m_size - 1]; }
+
+        T* data() { return m_data.data(); }
+        const T* data() const { return m_data.data(); }
+
+        iterator begin() { return m_data.data(); }
+        iterator end() { return m_data.data() + m_size; }
+        const_iterator begin() const { return m_data.data(); }
+        const_iterator end() const { return m_data.data() + m_size; }
+
+    private:
+        std::array<T, N> m_data{};
+        size_type m_size = 0;
+    };
+}
@@ -0,0 +1,415 @@
+#include "Strategy.h"
+
+#include "Endgame.h"
+
+#include <algorithm>
+
+namespace SeaBattle
+{
+    namespace
+    {
+        constexpr int Rows = ShotBoard::ROWS;
+        constexpr int Cols = ShotBoard::COLS;
+        constexpr int Cells = Rows * Cols;
+
+        using CellMask = std::array<bool, Cells>;
+
+        Position toPosition(int cell)
+        {
+            return { static_cast<std::int8_t>(cell / Cols), static_cast<std::int8_t>(cell % Cols) };
+        }
+
+        // Клетки, где корабля быть не может: вокруг потопленных кораблей и по
+        // диагонали от подбитых палуб (корабли прямые и не касаются друг друга)
+        CellMask blockedCells(const ShotBoard& board)
+        {
+            CellMask blocked{};
+            for (int row = 0; row < Rows; ++row)
+            {
+                for (int col = 0; col < Cols; ++col)
+                {
+                    CellState state = board.at(row, col);
+                    if (state != CellState::Destroyed && state != CellState::Hit)
+                    {
+                        continue;
+                    }
+                    for (int dr = -1; dr <= 1; ++dr)
+                    {
+                        for (int dc = -1; dc <= 1; ++dc)
+                        {
+                            bool diagonal = dr != 0 && dc != 0;
+                            if (state == CellState::Hit && !diagonal)
+                            {
+                                continue;
+                            }
+                            if (GameField::isValidCoordinate(row + dr, col + dc))
+                            {
+                                blocked[(row + dr) * Cols + col + dc] = true;
+                            }
+                        }
+                    }
+                }
+            }
+            return blocked;
+        }
+
+        bool isCandidate(const ShotBoard& board, const CellMask& blocked, int row, int col)
+        {
+            return GameField::isValidCoordinate(row, col) && !board.isShot(row, col) && !blocked[row * Cols + col];
+        }
+
+        // Равновероятный выбор из подходящих клеток; если таких нет - любая нестреляная
+        template <typename Pred>
+        Position pickRandom(const ShotBoard& board, std::mt19937& gen, Pred&& pred)
+        {
+            std::array<int, Cells> candidates{};
+            int count = 0;
+            for (int cell = 0; cell < Cells; ++cell)
+            {
+                if (pred(cell))
+                {
+                    candidates[count++] = cell;
+                }
+            }
+            if (count == 0)
+            {
+                for (int cell = 0; cell < Cells; ++cell)
+                {
+                    if (board.cells[cell] == CellState::Empty)
+                    {
+                        candidates[count++] = cell;
+                    }
+                }
+            }
+            std::uniform_int_distribution<> dist(0, std::max(count - 1, 0));
+            return toPosition(candidates[dist(gen)]);
+        }
+
+        // Добивание подбитого корабля: продолжаем линию попаданий, а при одиночном
+        // попадании пробуем четыре соседние клетки
+        bool pickTarget(const ShotBoard& board, const CellMask& blocked, std::mt19937& gen, Position& shot)
+        {
+            std::array<int, Cells> candidates{};
+            int count = 0;
+            auto add = [&](int row, int col)
+            {
+                if (isCandidate(board, blocked, row, col))
+                {
+                    candidates[count++] = row * Cols + col;
+                }
+            };
+
+            for (int row = 0; row < Rows; ++row)
+            {
+                for (int col = 0; col < Cols; ++col)
+                {
+                    if (board.at(row, col) != CellState::Hit)
+                    {
+                        continue;
+                    }
+                    bool vertical = (row > 0 && board.at(row - 1, col) == CellState::Hit)
+                        || (row + 1 < Rows && board.at(row + 1, col) == CellState::Hit);
+                    bool horizontal = (col > 0 && board.at(row, col - 1) == CellState::Hit)
+                        || (col + 1 < Cols && board.at(row, col + 1) == CellState::Hit);
+                    if (!horizontal)
+                    {
+                        add(row - 1, col);
+                        add(row + 1, col);
+                    }
+                    if (!vertical)
+                    {
+                        add(row, col - 1);
+                        add(row, col + 1);
+                    }
+                }
+            }
+
+            if (count == 0)
+            {
+                return false;
+            }
+            std::uniform_int_distribution<> dist(0, count - 1);
+            shot = toPosition(candidates[dist(gen)]);
+            return true;
+        }
+
+        class RandomStrategy : public IShotStrategy
+        {
+        public:
+            std::string_view Name() const override { return "random"; }
+
+            Position NextShot(const ShotBoard& board, std::mt19937& gen) override
+            {
+                return pickRandom(board, gen, [&](int cell) { return board.cells[cell] == CellState::Empty; });
+            }
+        };
+
+        class HuntStrategy : public IShotStrategy
+        {
+        public:
+            std::string_view Name() const override { return "hunt"; }
+
+            Position NextShot(const ShotBoard& board, std::mt19937& gen) override
+            {
+                CellMask blocked = blockedCells(board);
+                Position shot;
+                if (pickTarget(board, blocked, gen, shot))
+                {
+                    return shot;
+                }
+                return pickRandom(board, gen, [&](int cell)
+                {
+                    return isCandidate(board, blocked, cell / Cols, cell % Cols);
+                });
+            }
+        };
+
+        // Как hunt, но в поиске стреляет только по "чёрным" клеткам шахматки:
+        // любой корабль длиннее одной клетки обязательно их занимает
+        class ParityStrategy : public IShotStrategy
+        {
+        public:
+            std::string_view Name() const override { return "parity"; }
+
+            Position NextShot(const ShotBoard& board, std::mt19937& gen) override
+            {
+                CellMask blocked = blockedCells(board);
+                Position shot;
+                if (pickTarget(board, blocked, gen, shot))
+                {
+                    return shot;
+                }
+                bool parityLeft = false;
+                for (int cell = 0; cell < Cells && !parityLeft; ++cell)
+                {
+                    int row = cell / Cols;
+                    int col = cell % Cols;
+                    parityLeft = (row + col) % 2 == 0 && isCandidate(board, blocked, row, col);
+                }
+                return pickRandom(board, gen, [&](int cell)
+                {
+                    int row = cell / Cols;
+                    int col = cell % Cols;
+                    return (!parityLeft || (row + col) % 2 == 0) && isCandidate(board, blocked, row, col);
+                });
+            }
+        };
+
+        // Плотность вероятности: для каждого оставшегося корабля перебираются все
+        // допустимые положения, и стреляем в клетку, которую они покрывают чаще всего.
+        // Положения, проходящие через подбитые палубы, весят намного больше.
+        class DensityStrategy : public IShotStrategy
+        {
+        public:
+            std::string_view Name() const override { return "density"; }
+
+            Position NextShot(const ShotBoard& board, std::mt19937& gen) override
+            {
+                CellMask blocked = blockedCells(board);
+                auto remaining = RemainingShips(board);
+
+                bool targeting = std::any_of(board.cells.begin(), board.cells.end(),
+                    [](CellState state) { return state == CellState::Hit; });
+
+                std::array<int, Cells> weight{};
+                for (int size : remaining)
+                {
+                    for (int vertical = 0; vertical < 2; ++vertical)
+                    {
+                        int maxRow = vertical ? Rows - size : Rows - 1;
+                        int maxCol = vertical ? Cols - 1 : Cols - size;
+                        for (int row = 0; row <= maxRow; ++row)
+                        {
+                            for (int col = 0; col <= maxCol; ++col)
+                            {
+                                addPlacement(board, blocked, targeting, weight, row, col, size, vertical != 0);
+                            }
+                        }
+                    }
+                }
+
+                int best = -1;
+                int bestWeight = 0;
+                int ties = 0;
+                for (int cell = 0; cell < Cells; ++cell)
+                {
+                    if (board.cells[cell] != CellState::Empty || weight[cell] < bestWeight || weight[cell] == 0)
+                    {
+                        continue;
+                    }
+                    if (weight[cell] > bestWeight)
+                    {
+                        best = cell;
+                        bestWeight = weight[cell];
+                        ties = 1;
+                    }
+                    else if (std::uniform_int_distribution<>(0, ties++)(gen) == 0)
+                    {
+                        // Равновесные клетки выбираем равновероятно (reservoir sampling)
+                        best = cell;
+                    }
+                }
+
+                if (best < 0)
+                {
+                    return pickRandom(board, gen, [&](int cell) { return board.cells[cell] == CellState::Empty; });
+                }
+                return toPosition(best);
+            }
+
+        private:
+            static void addPlacement(const ShotBoard& board, const CellMask& blocked, bool targeting,
+                std::array<int, Cells>& weight, int row, int col, int size, bool vertical)
+            {
+                int hits = 0;
+                for (int i = 0; i < size; ++i)
+                {
+                    int r = vertical ? row + i : row;
+                    int c = vertical ? col : col + i;
+                    CellState state = board.at(r, c);
+                    if (state == CellState::Hit)
+                    {
+                        ++hits;
+                    }
+                    else if (state != CellState::Empty || blocked[r * Cols + c])
+                    {
+                        return;
+                    }
+                }
+                if (targeting && hits == 0)
+                {
+                    return;
+                }
+                int value = hits == 0 ? 1 : 1 + 100 * hits;
+                for (int i = 0; i < size; ++i)
+                {
+                    int r = vertical ? row + i : row;
+                    int c = vertical ? col : col + i;
+                    weight[r * Cols + c] += value;
+                }
+            }
+        };
+
+        // Одна таблица на процесс: партии разных потоков часто приходят к одним и тем же позициям
+        TranspositionTable& sharedEndgameTable()
+        {
+            static TranspositionTable table(16 << 20);
+            return table;
+        }
+
+        // Как density, но когда раскладок оставшихся кораблей мало, выстрел выбирает точный
+        // перебор. Оценки перебора не зависят от содержимого таблицы, поэтому партия с тем же
+        // зерном повторяется; исключение - позиции на пределе узлов, где тёплая таблица
+        // позволяет досчитать то, что с холодной ушло бы эвристике.
+        class EndgameStrategy : public DensityStrategy
+        {
+        public:
+            EndgameStrategy()
+                : m_solver(sharedEndgameTable())
+            {
+            }
+
+            std::string_view Name() const override { return "endgame"; }
+
+            Position NextShot(const ShotBoard& board, std::mt19937& gen) override
+            {
+                if (auto shot = m_solver.Solve(board))
+                {
+                    return *shot;
+                }
+                return DensityStrategy::NextShot(board, gen);
+            }
+
+        private:
+            EndgameSolver m_solver;
+        };
+    }
+
+    ShotBoard ShotBoard::FromEnemyField(const GameField& field)
+    {
+        ShotBoard board;
+        for (int row = 0; row < ROWS; ++row)
+        {
+            for (int col = 0; col < COLS; ++col)
+            {
+                CellState state = field.getCellState(row, col);
+                board.cells[row * COLS + col] = state == CellState::Ship ? CellState::Empty : state;
+            }
+        }
+        return board;
+    }
+
+    // Размеры ещё не потопленных кораблей: из флота вычитаются связные группы потопленных клеток
+    StaticVector<int, ClassicRules::FleetSize> RemainingShips(const ShotBoard& board)
+    {
+        std::array<int, MaxShipSize + 1> left{};
+        for (ShipType type : ClassicRules::Fleet)
+        {
+            ++left[static_cast<int>(type)];
+        }
+
+        CellMask visited{};
+        for (int cell = 0; cell < Cells; ++cell)
+        {
+            if (visited[cell] || board.cells[cell] != CellState::Destroyed)
+            {
+                continue;
+            }
+            int size = 0;
+            int row = cell / Cols;
+            int col = cell % Cols;
+            bool vertical = row + 1 < Rows && board.at(row + 1, col) == CellState::Destroyed;
+            while (GameField::isValidCoordinate(row, col) && board.at(row, col) == CellState::Destroyed)
+            {
+                visited[row * Cols + col] = true;
+                ++size;
+                vertical ? ++row : ++col;
+            }
+            if (size <= MaxShipSize && left[size] > 0)
+            {
+                --left[size];
+            }
+        }
+
+        StaticVector<int, ClassicRules::FleetSize> sizes;
+        for (int size = MaxShipSize; size > 0; --size)
+        {
+            for (int i = 0; i < left[size]; ++i)
+            {
+                sizes.push_back(size);
+            }
+        }
+        return sizes;
+    }
+
+    std::unique_ptr<IShotStrategy> MakeStrategy(std::string_view name)
+    {
+        if (name == "random")
+        {
+            return std::make_unique<RandomStrategy>();
+        }
+        if (name == "hunt")
+        {
+            return std::make_unique<HuntStrategy>();
+        }
+        if (name == "parity")
+        {
+            return std::make_unique<ParityStrategy>();
+        }
+        if (name == "density")
+        {
+            return std::make_unique<DensityStrategy>();
+        }
+        if (name == "endgame")
+        {
+            return std::make_unique<EndgameStrategy>();
+        }
+        return nullptr;
+    }
+
+    const std::vector<std::string_view>& StrategyNames()
+    {
+        static const std::vector<std::string_view> names{ "random", "hunt", "parity", "density", "endgame" };
+        return names;
+    }
+}
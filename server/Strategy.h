@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GameModel.h"
+
+#include <array>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace SeaBattle
+{
+    // Поле противника глазами стреляющего: клетки с кораблями, в которые ещё
+    // не стреляли, видны как пустые. Стратегия не может подсмотреть расстановку.
+    struct ShotBoard
+    {
+        static constexpr int ROWS = GameField::ROWS;
+        static constexpr int COLS = GameField::COLS;
+
+        std::array<CellState, ClassicRules::Cells> cells{};
+
+        static ShotBoard FromEnemyField(const GameField& field);
+
+        CellState at(int row, int col) const { return cells[row * COLS + col]; }
+        bool isShot(int row, int col) const { return at(row, col) != CellState::Empty; }
+    };
+
+    // Стратегия стрельбы. Вся случайность берётся из переданного генератора,
+    // поэтому партия с одинаковым зерном повторяется выстрел в выстрел.
+    class IShotStrategy
+    {
+    public:
+        virtual ~IShotStrategy() = default;
+
+        virtual std::string_view Name() const = 0;
+        virtual Position NextShot(const ShotBoard& board, std::mt19937& gen) = 0;
+    };
+
+    // Размеры ещё не потопленных кораблей флота, от больших к меньшим
+    StaticVector<int, ClassicRules::FleetSize> RemainingShips(const ShotBoard& board);
+
+    // Доступные стратегии: "random", "hunt", "parity", "density", "endgame"
+    std::unique_ptr<IShotStrategy> MakeStrategy(std::string_view name);
+    const std::vector<std::string_view>& StrategyNames();
+}
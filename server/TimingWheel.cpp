@@ -0,0 +1,126 @@
+#include "TimingWheel.h"
+
+#include <algorithm>
+
+namespace SeaBattle
+{
+    namespace
+    {
+        // Раскладка ячейки подгружает узлы на несколько шагов вперёд; без встроенной функции - как есть
+        void prefetch(const void* address)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address);
+#else
+            (void)address;
+#endif
+        }
+    }
+
+    TimingWheel::TimingWheel(std::uint64_t now)
+        : m_now(now)
+    {
+    }
+
+    TimingWheel::Handle TimingWheel::Arm(std::uint64_t delay, std::uint64_t data)
+    {
+        const std::uint32_t index = acquire();
+        Node& node = m_nodes[index];
+        node.expires = m_now + std::clamp<std::uint64_t>(delay, 1, MaxDelay);
+        node.data = data;
+        node.armed = true;
+        insert(index);
+        ++m_size;
+        return (static_cast<Handle>(node.generation) << 32) | (index + 1);
+    }
+
+    bool TimingWheel::Cancel(Handle handle)
+    {
+        const auto index = static_cast<std::uint32_t>(handle) - 1;
+        if (handle == 0 || index >= m_nodes.size())
+        {
+            return false;
+        }
+        const Node& node = m_nodes[index];
+        if (!node.armed || node.generation != static_cast<std::uint32_t>(handle >> 32))
+        {
+            return false;
+        }
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    std::uint32_t TimingWheel::acquire()
+    {
+        if (m_free == None)
+        {
+            m_nodes.emplace_back();
+            return static_cast<std::uint32_t>(m_nodes.size() - 1);
+        }
+        const std::uint32_t index = m_free;
+        m_free = m_nodes[index].position;
+        return index;
+    }
+
+    void TimingWheel::release(std::uint32_t index)
+    {
+        Node& node = m_nodes[index];
+        node.armed = false;
+        ++node.generation;
+        node.position = m_free;
+        m_free = index;
+        --m_size;
+    }
+
+    // Уровень - по тому, сколько осталось до срока; ячейка - по самому сроку. Узел уровня L
+    // разложится вниз, когда текущий тик дойдёт до начала его ячейки
+    void TimingWheel::insert(std::uint32_t index)
+    {
+        Node& node = m_nodes[index];
+        const std::uint64_t delta = node.expires - m_now;
+        int level = 0;
+        while (level < Levels - 1 && delta >= (std::uint64_t{ 1 } << (SlotBits * (level + 1))))
+        {
+            ++level;
+        }
+        const std::size_t slot = slotIndex(level, node.expires);
+        node.slot = static_cast<std::uint16_t>(slot);
+        node.position = static_cast<std::uint32_t>(m_slots[slot].size());
+        m_slots[slot].push_back(index);
+    }
+
+    void TimingWheel::unlink(std::uint32_t index)
+    {
+        const Node& node = m_nodes[index];
+        auto& slot = m_slots[node.slot];
+        const std::uint32_t last = slot.back();
+        slot[node.position] = last;
+        m_nodes[last].position = node.position;
+        slot.pop_back();
+    }
+
+    // Тик на границе ячейки уровня L: её узлы до срока ближе Slots^L и переезжают ниже
+    void TimingWheel::cascade()
+    {
+        for (int level = 1; level < Levels; ++level)
+        {
+            if ((m_now & ((std::uint64_t{ 1 } << (SlotBits * level)) - 1)) != 0)
+            {
+                break;
+            }
+            // Ячейка забирается целиком: узлы уходят в другие ячейки, её массив остаётся пустым
+            m_cascading.swap(m_slots[slotIndex(level, m_now)]);
+            constexpr std::size_t Prefetch = 8;
+            for (std::size_t i = 0; i < m_cascading.size(); ++i)
+            {
+                if (i + Prefetch < m_cascading.size())
+                {
+                    prefetch(&m_nodes[m_cascading[i + Prefetch]]);
+                }
+                insert(m_cascading[i]);
+            }
+            m_cascading.clear();
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SeaBattle
+{
+    // Иерархическое колесо таймеров: Levels уровней по Slots ячеек, ячейка уровня L покрывает
+    // Slots^L тиков. Таймер - узел в общем массиве, ячейка - массив номеров узлов, узел помнит
+    // своё место в нём: постановка - добавление в конец, отмена - перенос последнего на место
+    // отменённого, обе O(1). Тик разбирает одну ячейку нижнего уровня; раз в Slots тиков ячейка
+    // следующего уровня раскладывается по нижним. Номера узлов лежат подряд, поэтому при
+    // раскладке узлы подгружаются заранее - списком пришлось бы идти по узлу за раз.
+    // Срок дальше MaxDelay тиков урезается до MaxDelay.
+    // Не потокобезопасно: у колеса один владелец.
+    class TimingWheel
+    {
+    public:
+        // 0 - нет таймера. В старших битах поколение узла: ручка сработавшего или отменённого
+        // таймера не отменит таймер, занявший его узел позже
+        using Handle = std::uint64_t;
+
+        static constexpr int SlotBits = 6;
+        static constexpr int Slots = 1 << SlotBits;
+        static constexpr int Levels = 4;
+        static constexpr std::uint64_t MaxDelay = (std::uint64_t{ 1 } << (SlotBits * Levels)) - 1;
+
+        explicit TimingWheel(std::uint64_t now = 0);
+
+        // Таймер сработает на тике Now() + delay, но не раньше следующего; data вернётся в Advance
+        Handle Arm(std::uint64_t delay, std::uint64_t data);
+        // false - таймер уже сработал или отменён
+        bool Cancel(Handle handle);
+
+        // Продвигает колесо до тика now и для каждого истёкшего таймера вызывает fire(data).
+        // Из fire можно ставить и отменять таймеры. Возвращает число сработавших
+        template <typename Fn>
+        std::size_t Advance(std::uint64_t now, Fn&& fire)
+        {
+            std::size_t fired = 0;
+            while (m_now < now)
+            {
+                if (m_size == 0)
+                {
+                    m_now = now;
+                    break;
+                }
+                ++m_now;
+                cascade();
+                // Узел снимается до вызова fire: fire может отменить соседа по ячейке
+                auto& slot = m_slots[slotIndex(0, m_now)];
+                while (!slot.empty())
+                {
+                    const std::uint32_t index = slot.back();
+                    slot.pop_back();
+                    const std::uint64_t data = m_nodes[index].data;
+                    release(index);
+                    ++fired;
+                    fire(data);
+                }
+            }
+            return fired;
+        }
+
+        std::uint64_t Now() const { return m_now; }
+        std::size_t Size() const { return m_size; }
+        void Reserve(std::size_t timers) { m_nodes.reserve(timers); }
+
+    private:
+        static constexpr std::uint32_t None = ~std::uint32_t{ 0 };
+
+        struct Node
+        {
+            std::uint64_t expires = 0;
+            std::uint64_t data = 0;
+            std::uint32_t position = 0;    // место в ячейке; у свободного узла - следующий свободный
+            std::uint32_t generation = 0;
+            std::uint16_t slot = 0;
+            bool armed = false;
+        };
+
+        static std::size_t slotIndex(int level, std::uint64_t tick)
+        {
+            return static_cast<std::size_t>(level) * Slots + ((tick >> (SlotBits * level)) & (Slots - 1));
+        }
+
+        std::uint32_t acquire();
+        void release(std::uint32_t index);
+        void insert(std::uint32_t index);
+        void unlink(std::uint32_t index);
+        void cascade();
+
+        std::vector<Node> m_nodes;
+        std::array<std::vector<std::uint32_t>, static_cast<std::size_t>(Levels) * Slots> m_slots;
+        std::vector<std::uint32_t> m_cascading;  // ячейка, которая раскладывается
+        std::uint32_t m_free = None;
+        std::uint64_t m_now = 0;
+        std::size_t m_size = 0;
+    };
+}
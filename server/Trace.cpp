@@ -0,0 +1,174 @@
+#include "Trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace SeaBattle::Trace
+{
+    namespace
+    {
+        struct Event
+        {
+            const char* name;
+            const char* category;
+            std::uint64_t traceId;
+            std::uint64_t startNs;
+            std::uint64_t endNs;
+        };
+
+        // Буфер одного потока. Пишет только владелец: слот заполняется, затем публикуется
+        // увеличением count, поэтому выгрузка из другого потока читает только готовые события.
+        // Переполненный буфер не перезаписывается - новые события отбрасываются.
+        struct ThreadBuffer
+        {
+            static constexpr std::size_t Capacity = 1 << 16;
+
+            std::uint32_t tid = 0;
+            std::unique_ptr<Event[]> events{ new Event[Capacity] };
+            std::atomic<std::size_t> count{ 0 };
+            std::atomic<std::uint64_t> dropped{ 0 };
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            std::string processName = "seabattle";
+        };
+
+        Registry& registry()
+        {
+            static Registry instance;
+            return instance;
+        }
+
+        ThreadBuffer& threadBuffer()
+        {
+            // Буферы живут до конца процесса: события завершившихся потоков тоже попадают в выгрузку
+            thread_local ThreadBuffer* buffer = []()
+            {
+                auto& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+                reg.buffers.back()->tid = static_cast<std::uint32_t>(reg.buffers.size());
+                return reg.buffers.back().get();
+            }();
+            return *buffer;
+        }
+
+        std::uint32_t processId()
+        {
+#ifdef _WIN32
+            return static_cast<std::uint32_t>(_getpid());
+#else
+            return static_cast<std::uint32_t>(getpid());
+#endif
+        }
+
+        void writeEscaped(std::ostream& out, const std::string& text)
+        {
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out << '\\';
+                }
+                out << c;
+            }
+        }
+    }
+
+    namespace Detail
+    {
+        void Record(const char* name, const char* category, std::uint64_t traceId,
+            std::uint64_t startNs, std::uint64_t endNs)
+        {
+            ThreadBuffer& buffer = threadBuffer();
+            std::size_t index = buffer.count.load(std::memory_order_relaxed);
+            if (index >= ThreadBuffer::Capacity)
+            {
+                buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            buffer.events[index] = { name, category, traceId, startNs, endNs };
+            buffer.count.store(index + 1, std::memory_order_release);
+        }
+    }
+
+    void Enable(std::string processName)
+    {
+        {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.processName = std::move(processName);
+        }
+        Detail::g_enabled.store(true, std::memory_order_relaxed);
+    }
+
+    std::uint64_t NowNs()
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+
+    std::uint64_t NewTraceId()
+    {
+        static const std::uint64_t prefix = []()
+        {
+            std::random_device rd;
+            return (static_cast<std::uint64_t>(rd()) << 32) & 0x7FFFFFFF00000000ull;
+        }();
+        static std::atomic<std::uint32_t> counter{ 0 };
+        return prefix | (counter.fetch_add(1, std::memory_order_relaxed) + 1);
+    }
+
+    bool WriteChromeTrace(const std::string& path)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        const std::uint32_t pid = processId();
+
+        // Время в trace-event - микросекунды; дробная часть сохраняет наносекунды.
+        // id трассы пишется строкой: 64-битные числа не помещаются в double просмотрщиков.
+        out << std::fixed << std::setprecision(3);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":0,\"args\":{\"name\":\"";
+        writeEscaped(out, reg.processName);
+        out << "\"}}";
+
+        std::uint64_t dropped = 0;
+        for (const auto& buffer : reg.buffers)
+        {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+            std::size_t count = buffer->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const Event& e = buffer->events[i];
+                out << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\""
+                    << ",\"ts\":" << static_cast<double>(e.startNs) / 1000.0
+                    << ",\"dur\":" << static_cast<double>(e.endNs - e.startNs) / 1000.0
+                    << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                    << ",\"args\":{\"trace\":\"" << e.traceId << "\"}}";
+            }
+        }
+        out << "\n],\"otherData\":{\"dropped\":" << dropped << "}}\n";
+        return static_cast<bool>(out);
+    }
+}
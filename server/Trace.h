@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Трассировка задержек выстрела: клиент и сервер записывают отрезки (spans) в буферы
+// своих потоков и выгружают их в формате Chrome trace-event (chrome://tracing, Perfetto).
+// Пока трассировка выключена, Span стоит одну проверку атомарного флага.
+namespace SeaBattle::Trace
+{
+    // Категории, по которым утилита tracemerge сопоставляет клиентский и серверный отрезки
+    // одного выстрела и оценивает разницу часов двух процессов
+    inline constexpr const char* RoundTripCategory = "rtt";     // клиент: от отправки до ответа
+    inline constexpr const char* HandlerCategory = "handler";   // сервер: обработка запроса
+    inline constexpr const char* DefaultCategory = "seabattle";
+
+    namespace Detail
+    {
+        inline std::atomic<bool> g_enabled{ false };
+        void Record(const char* name, const char* category, std::uint64_t traceId,
+            std::uint64_t startNs, std::uint64_t endNs);
+    }
+
+    // processName попадает в метаданные выгрузки (например, "client" или "server")
+    void Enable(std::string processName);
+    inline bool Enabled() { return Detail::g_enabled.load(std::memory_order_relaxed); }
+
+    // Монотонное время в наносекундах
+    std::uint64_t NowNs();
+
+    // Уникальный в пределах процесса id с случайной старшей частью, чтобы id разных клиентов не совпадали
+    std::uint64_t NewTraceId();
+
+    // Записывает все накопленные отрезки; false при ошибке записи
+    bool WriteChromeTrace(const std::string& path);
+
+    class Span
+    {
+    public:
+        explicit Span(const char* name, std::uint64_t traceId = 0, const char* category = DefaultCategory)
+            : m_name(name)
+            , m_category(category)
+            , m_traceId(traceId)
+            , m_startNs(Enabled() ? NowNs() : 0)
+        {
+        }
+
+        ~Span() { end(); }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        void setTraceId(std::uint64_t traceId) { m_traceId = traceId; }
+
+        // Завершает отрезок раньше конца области видимости
+        void end()
+        {
+            if (m_startNs != 0)
+            {
+                Detail::Record(m_name, m_category, m_traceId, m_startNs, NowNs());
+                m_startNs = 0;
+            }
+        }
+
+    private:
+        const char* m_name;
+        const char* m_category;
+        std::uint64_t m_traceId;
+        std::uint64_t m_startNs;
+    };
+}
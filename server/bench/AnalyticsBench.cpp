@@ -0,0 +1,145 @@
+#include "Analytics.h"
+#include "Bench.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Время процессора текущего потока, нс: на машине с меньшим числом ядер, чем потоков,
+    // настенное время потока включало бы работу остальных
+    double threadCpuNs()
+    {
+#ifdef __linux__
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+#else
+        return std::chrono::duration<double, std::nano>(Bench::Clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Выстрелы заранее: генератор не должен попасть в измерение
+    struct Shot
+    {
+        int row;
+        int col;
+        int turn;
+        bool hit;
+    };
+
+    std::vector<Shot> MakeShots(std::size_t count, std::uint32_t seed)
+    {
+        std::mt19937 gen{ seed };
+        std::uniform_int_distribution<int> cell(0, 9);
+        std::uniform_int_distribution<int> turn(0, 120);
+        std::vector<Shot> shots(count);
+        for (auto& shot : shots)
+        {
+            shot = { cell(gen), cell(gen), turn(gen), (gen() & 3) == 0 };
+        }
+        return shots;
+    }
+
+    // Для сравнения: общие для всех потоков атомарные счётчики
+    struct SharedCounters
+    {
+        std::array<std::atomic<std::uint64_t>, Analytics::MaxCells> cellShots{};
+        std::array<std::atomic<std::uint64_t>, Analytics::MaxCells> cellHits{};
+        std::array<std::atomic<std::uint64_t>, Analytics::MaxTurns> turnShots{};
+        std::array<std::atomic<std::uint64_t>, Analytics::MaxTurns> turnHits{};
+
+        void Record(const Shot& shot)
+        {
+            const auto cell = static_cast<std::size_t>(shot.row * Analytics::MaxCols + shot.col);
+            cellShots[cell].fetch_add(1, std::memory_order_relaxed);
+            turnShots[static_cast<std::size_t>(shot.turn)].fetch_add(1, std::memory_order_relaxed);
+            if (shot.hit)
+            {
+                cellHits[cell].fetch_add(1, std::memory_order_relaxed);
+                turnHits[static_cast<std::size_t>(shot.turn)].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // threads потоков одновременно записывают свои выстрелы; среднее процессорное время выстрела, нс
+    template <typename RecordFn>
+    double RunThreads(unsigned threads, std::size_t shotsPerThread, RecordFn record)
+    {
+        std::vector<std::vector<Shot>> shots;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            shots.push_back(MakeShots(shotsPerThread, t + 1));
+        }
+        std::vector<double> perShot(threads);
+        std::atomic<bool> go{ false };
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]()
+            {
+                while (!go.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                const double start = threadCpuNs();
+                for (const auto& shot : shots[t])
+                {
+                    record(shot);
+                }
+                perShot[t] = (threadCpuNs() - start) / static_cast<double>(shotsPerThread);
+            });
+        }
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        double total = 0.0;
+        for (double value : perShot)
+        {
+            total += value;
+        }
+        return total / threads;
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // analytics [threads] [shots per thread]: стоимость записи выстрела в счётчики потока
+    // против общих атомарных счётчиков, время снимка
+    int RunAnalyticsBench(int argc, char* argv[])
+    {
+        const unsigned threads = argc > 0 ? static_cast<unsigned>(std::stoul(argv[0])) : std::max(2u, std::thread::hardware_concurrency());
+        const std::size_t shotsPerThread = argc > 1 ? std::stoull(argv[1]) : 5000000;
+        Report("threads", threads, "");
+
+        auto recordLocal = [](const Shot& shot) { Analytics::RecordShot(shot.row, shot.col, shot.turn, shot.hit); };
+        Report("per-thread counters, 1 thread", RunThreads(1, shotsPerThread, recordLocal), "ns/shot");
+        Report("per-thread counters, all threads", RunThreads(threads, shotsPerThread, recordLocal), "ns/shot");
+
+        auto shared = std::make_unique<SharedCounters>();
+        auto recordShared = [&shared](const Shot& shot) { shared->Record(shot); };
+        Report("shared atomics, 1 thread", RunThreads(1, shotsPerThread, recordShared), "ns/shot");
+        Report("shared atomics, all threads", RunThreads(threads, shotsPerThread, recordShared), "ns/shot");
+
+        Analytics::Snapshot snapshot;
+        const double snapshotNs = MeasureNs(100, [&](int) { snapshot = Analytics::TakeSnapshot(); });
+        Report("snapshot", snapshotNs / 1000.0, "us");
+        Report("snapshot threads", static_cast<double>(snapshot.threads), "");
+        Report("snapshot shots", static_cast<double>(snapshot.shots), "");
+        Consume(snapshot.hits);
+        return 0;
+    }
+}
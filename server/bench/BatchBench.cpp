@@ -0,0 +1,169 @@
+#include "Bench.h"
+#include "GameBatch.h"
+#include "GameModel.h"
+
+#include <array>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    template <typename R>
+    ShotOutcome OutcomeOf(const BasicGameModel<R>& model, int player, int row, int col, bool hit)
+    {
+        if (!hit)
+        {
+            return ShotOutcome::Miss;
+        }
+        if (model.GetGameState() == GameState::GameOver)
+        {
+            return ShotOutcome::GameOver;
+        }
+        return model.GetEnemyField(player).getCellState(row, col) == CellState::Destroyed ? ShotOutcome::Sunk : ShotOutcome::Hit;
+    }
+
+    // games партий со случайными выстрелами (у каждого игрока своя перестановка клеток).
+    // Сначала скалярная модель доигрывает их и записывает выстрелы каждого шага; затем те же
+    // выстрелы проходят через скалярную модель и через пачку, исходы сравниваются пошагово.
+    template <typename R>
+    std::uint64_t RunForRules(std::string_view name, int games)
+    {
+        const auto count = static_cast<std::size_t>(games);
+        std::mt19937 gen(4242);
+
+        std::vector<BasicGameModel<R>> starts(count);
+        for (auto& model : starts)
+        {
+            model.StartGame(gen);
+        }
+
+        // Ход партии: steps[s][g] - клетка выстрела шага s; outcomes[s][g] - исход по скалярной модели
+        std::vector<std::vector<std::uint8_t>> steps;
+        std::vector<std::vector<ShotOutcome>> expected;
+        {
+            std::array<int, R::Cells> order{};
+            std::iota(order.begin(), order.end(), 0);
+            std::vector<std::array<std::array<int, R::Cells>, 2>> orders(count, { order, order });
+            std::vector<std::array<int, 2>> next(count, { 0, 0 });
+            for (auto& perPlayer : orders)
+            {
+                std::shuffle(perPlayer[0].begin(), perPlayer[0].end(), gen);
+                std::shuffle(perPlayer[1].begin(), perPlayer[1].end(), gen);
+            }
+
+            std::vector<BasicGameModel<R>> models = starts;
+            bool anyPlaying = true;
+            while (anyPlaying)
+            {
+                anyPlaying = false;
+                std::vector<std::uint8_t> cells(count, 0);
+                std::vector<ShotOutcome> outcomes(count, ShotOutcome::Ignored);
+                for (std::size_t g = 0; g < count; ++g)
+                {
+                    auto& model = models[g];
+                    if (model.GetGameState() != GameState::Playing)
+                    {
+                        continue;
+                    }
+                    const int player = model.GetCurrentPlayer();
+                    const int cell = orders[g][player][next[g][player]++];
+                    cells[g] = static_cast<std::uint8_t>(cell);
+                    bool hit = model.ProcessShot(player, cell / R::Cols, cell % R::Cols);
+                    outcomes[g] = OutcomeOf(model, player, cell / R::Cols, cell % R::Cols, hit);
+                    anyPlaying = anyPlaying || model.GetGameState() == GameState::Playing;
+                }
+                steps.push_back(std::move(cells));
+                expected.push_back(std::move(outcomes));
+            }
+        }
+
+        std::uint64_t shots = 0;
+        for (const auto& outcomes : expected)
+        {
+            for (ShotOutcome outcome : outcomes)
+            {
+                shots += outcome != ShotOutcome::Ignored ? 1 : 0;
+            }
+        }
+
+        // Скалярная модель: партия за партией на каждом шаге
+        std::vector<BasicGameModel<R>> models = starts;
+        auto scalarStart = Bench::Clock::now();
+        for (const auto& cells : steps)
+        {
+            for (std::size_t g = 0; g < count; ++g)
+            {
+                auto& model = models[g];
+                if (model.GetGameState() == GameState::Playing)
+                {
+                    Bench::Consume(model.ProcessShot(model.GetCurrentPlayer(), cells[g] / R::Cols, cells[g] % R::Cols) ? 1 : 0);
+                }
+            }
+        }
+        double scalarNs = std::chrono::duration<double, std::nano>(Bench::Clock::now() - scalarStart).count();
+
+        // Пачка: один Step на шаг
+        BasicGameBatch<R> batch(count);
+        for (std::size_t g = 0; g < count; ++g)
+        {
+            batch.Load(g, starts[g]);
+        }
+        std::vector<ShotOutcome> outcomes(count);
+        std::uint64_t mismatches = 0;
+        double batchNs = 0.0;
+        for (std::size_t s = 0; s < steps.size(); ++s)
+        {
+            auto stepStart = Bench::Clock::now();
+            batch.Step(steps[s], outcomes);
+            batchNs += std::chrono::duration<double, std::nano>(Bench::Clock::now() - stepStart).count();
+            for (std::size_t g = 0; g < count; ++g)
+            {
+                mismatches += outcomes[g] != expected[s][g] ? 1 : 0;
+            }
+        }
+
+        // Итоговые поля и победители обеих реализаций
+        for (std::size_t g = 0; g < count; ++g)
+        {
+            mismatches += batch.Winner(g) != models[g].GetWinner() || batch.State(g) != models[g].GetGameState() ? 1 : 0;
+            for (int owner = 0; owner < 2; ++owner)
+            {
+                for (int cell = 0; cell < R::Cells; ++cell)
+                {
+                    const int row = cell / R::Cols;
+                    const int col = cell % R::Cols;
+                    mismatches += batch.Cell(g, owner, row, col) != models[g].GetPlayerField(owner).getCellState(row, col) ? 1 : 0;
+                }
+            }
+        }
+
+        const std::string prefix(name);
+        Bench::Report(prefix + " steps", static_cast<double>(steps.size()), "");
+        Bench::Report(prefix + " scalar", static_cast<double>(shots) / scalarNs * 1e3, "M game-steps/s");
+        Bench::Report(prefix + " batch", static_cast<double>(shots) / batchNs * 1e3, "M game-steps/s");
+        // Пачка делает шаг и в уже оконченных партиях - считаем и её собственную пропускную способность
+        Bench::Report(prefix + " batch slots", static_cast<double>(steps.size() * count) / batchNs * 1e3, "M slot-steps/s");
+        Bench::Report(prefix + " mismatches", static_cast<double>(mismatches), "");
+        return mismatches;
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // batch [games]: пропускная способность пачки в структуре массивов против GameModel
+    // на одинаковых партиях и проверка, что исходы совпадают
+    int RunBatchBench(int argc, char* argv[])
+    {
+        const int games = argc > 0 ? std::stoi(argv[0]) : 4096;
+        Report("games", games, "");
+        std::uint64_t mismatches = RunForRules<ClassicRules>("classic", games);
+        mismatches += RunForRules<BlitzRules>("blitz", games);
+        mismatches += RunForRules<LargeRules>("large", games);
+        mismatches += RunForRules<TouchingRules>("touching", games);
+        return mismatches == 0 ? 0 : 1;
+    }
+}
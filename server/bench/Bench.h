@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SeaBattle::Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Не даёт компилятору выбросить результат измеряемого кода
+    inline volatile std::uint64_t g_sink = 0;
+
+    inline void Consume(std::uint64_t value)
+    {
+        g_sink = g_sink + value;
+    }
+
+    // Выполняет fn(i) iterations раз и возвращает среднее время одной итерации в наносекундах
+    template <typename Fn>
+    double MeasureNs(int iterations, Fn&& fn)
+    {
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            fn(i);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return elapsed / iterations;
+    }
+
+    // Перестанавливает values (nth_element)
+    inline double Percentile(std::vector<double>& values, double fraction)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        auto index = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+        return values[index];
+    }
+
+    inline void Report(std::string_view name, double value, std::string_view unit)
+    {
+        std::cout << "[bench] " << name << ": " << value << " " << unit << std::endl;
+    }
+
+    // Точки входа бенчмарков; argc/argv - аргументы после имени бенчмарка
+    int RunRulesBench(int argc, char* argv[]);
+    int RunSnapshotBench(int argc, char* argv[]);
+    int RunScalingBench(int argc, char* argv[]);
+    int RunLatencyBench(int argc, char* argv[]);
+    int RunFleetPoolBench(int argc, char* argv[]);
+    int RunPlacementBench(int argc, char* argv[]);
+    int RunReplayBench(int argc, char* argv[]);
+    int RunBatchBench(int argc, char* argv[]);
+    int RunEndgameBench(int argc, char* argv[]);
+    int RunOpeningBookBench(int argc, char* argv[]);
+    int RunBotBench(int argc, char* argv[]);
+    int RunAnalyticsBench(int argc, char* argv[]);
+    int RunTransportBench(int argc, char* argv[]);
+    int RunMuxBench(int argc, char* argv[]);
+    int RunClockBench(int argc, char* argv[]);
+    int RunRoomsBench(int argc, char* argv[]);
+}
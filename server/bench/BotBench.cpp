@@ -0,0 +1,156 @@
+#include "Bench.h"
+#include "BotExecutor.h"
+#include "FleetPool.h"
+#include "GameModel.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Ходы людей: каждые interval обработка выстрела (ProcessShot) в потоке обычного приоритета.
+    // Задержка - от назначенного момента до конца обработки: сюда попадает и ожидание процессора
+    std::vector<double> RunHumans(std::chrono::milliseconds duration, std::chrono::microseconds interval)
+    {
+        std::vector<double> latencies;
+        std::mt19937 gen{ 11 };
+        GameModel model;
+        model.StartGame(gen);
+        std::uniform_int_distribution<int> cell(0, ClassicRules::Cells - 1);
+        const auto start = Bench::Clock::now();
+        for (auto next = start + interval; next < start + duration; next += interval)
+        {
+            std::this_thread::sleep_until(next);
+            if (model.GetGameState() == GameState::GameOver)
+            {
+                model.StartGame(gen);
+            }
+            const int player = model.GetCurrentPlayer();
+            int shot = cell(gen);
+            while (!model.IsValidShot(player, shot / ClassicRules::Cols, shot % ClassicRules::Cols))
+            {
+                shot = (shot + 1) % ClassicRules::Cells;
+            }
+            Bench::Consume(model.ProcessShot(player, shot / ClassicRules::Cols, shot % ClassicRules::Cols) ? 1 : 0);
+            latencies.push_back(std::chrono::duration<double, std::micro>(Bench::Clock::now() - next).count());
+        }
+        return latencies;
+    }
+
+    void ReportHumans(const std::string& name, std::vector<double> latencies)
+    {
+        Bench::Report(name + " human shot p50", Bench::Percentile(latencies, 0.50), "us");
+        Bench::Report(name + " human shot p99", Bench::Percentile(latencies, 0.99), "us");
+        Bench::Report(name + " human shot max", Bench::Percentile(latencies, 1.0), "us");
+    }
+
+    // Партия бота против неподвижного флота: по готовности хода стреляет и просит следующий.
+    // У партии всегда не больше одного хода в очереди, поэтому поля не делятся между потоками
+    struct BotGame
+    {
+        GameField field;
+        std::mt19937 gen;
+        std::uint64_t seed = 0;
+    };
+
+    class BotLoad
+    {
+    public:
+        BotLoad(BotExecutor& executor, int games)
+            : m_executor(executor)
+            , m_games(static_cast<std::size_t>(games))
+        {
+            for (std::size_t i = 0; i < m_games.size(); ++i)
+            {
+                m_games[i].gen.seed(static_cast<std::uint32_t>(i + 1));
+                m_games[i].field = FleetPool::MakeFleet<ClassicRules>(m_games[i].gen);
+                m_games[i].seed = i << 32;
+            }
+        }
+
+        void Start()
+        {
+            for (auto& game : m_games)
+            {
+                submit(game);
+            }
+        }
+
+        void Stop() { m_stopping.store(true); }
+        std::uint64_t Finished() const { return m_finished.load(); }
+
+    private:
+        void submit(BotGame& game)
+        {
+            m_executor.Submit(ShotBoard::FromEnemyField(game.field), game.seed++, [this, &game](Position shot)
+            {
+                game.field.shoot(shot.row, shot.col);
+                if (game.field.allShipsDestroyed())
+                {
+                    m_finished.fetch_add(1);
+                    game.field = FleetPool::MakeFleet<ClassicRules>(game.gen);
+                }
+                if (!m_stopping.load())
+                {
+                    submit(game);
+                }
+            });
+        }
+
+        BotExecutor& m_executor;
+        std::vector<BotGame> m_games;
+        std::atomic<bool> m_stopping{ false };
+        std::atomic<std::uint64_t> m_finished{ 0 };
+    };
+}
+
+namespace SeaBattle::Bench
+{
+    // bots [games] [cpu share] [deadline ms] [seconds]: games ботов думают одновременно, пока
+    // поток "людей" обрабатывает выстрел каждые 500 мкс; задержки людей сравниваются с прогоном без ботов
+    int RunBotBench(int argc, char* argv[])
+    {
+        const int games = argc > 0 ? std::stoi(argv[0]) : 64;
+        BotExecutorConfig config;
+        config.cpuShare = argc > 1 ? std::stod(argv[1]) : config.cpuShare;
+        config.moveDeadline = std::chrono::milliseconds(argc > 2 ? std::stoi(argv[2]) : static_cast<int>(config.moveDeadline.count()));
+        const auto duration = std::chrono::milliseconds(argc > 3 ? std::stoi(argv[3]) * 1000 : 3000);
+        const auto interval = std::chrono::microseconds(500);
+        Report("bot games", games, "");
+        Report("cpu share", config.cpuShare, "");
+
+        ReportHumans("idle", RunHumans(duration, interval));
+
+        BotExecutor executor(config);
+        executor.Start();
+        auto load = std::make_unique<BotLoad>(executor, games);
+        load->Start();
+        const auto start = Clock::now();
+        ReportHumans("with bots", RunHumans(duration, interval));
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        load->Stop();
+        executor.Stop();
+
+        const auto stats = executor.Stats();
+        Report("bot moves", static_cast<double>(stats.moves), "");
+        Report("bot moves/s", static_cast<double>(stats.moves) / seconds, "");
+        Report("bot games finished", static_cast<double>(load->Finished()), "");
+        Report("bot cpu", 100.0 * stats.cpuSeconds / seconds, "% of one core");
+        Report("bot throttled", static_cast<double>(stats.throttled), "moves");
+        Report("bot move p50", stats.latencyP50, "us");
+        Report("bot move p99", stats.latencyP99, "us");
+        Report("bot move max", stats.latencyMax, "us");
+        Report("bot deadline misses", static_cast<double>(stats.deadlineMisses), "moves");
+        for (std::size_t tier = 0; tier < stats.movesByTier.size(); ++tier)
+        {
+            Report(std::string("bot moves ") + std::string(BotExecutor::TierNames()[tier]), static_cast<double>(stats.movesByTier[tier]), "");
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,166 @@
+#include "Bench.h"
+#include "TimingWheel.h"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Тик колеса в сервере - 100 мс: срок на ход 60 с - 600 тиков, запас на партию 15 мин - 9000
+    constexpr std::uint64_t TurnTicks = 600;
+    constexpr std::uint64_t GameTicks = 9000;
+
+    // Сроки заранее: генератор не должен попасть в измерение
+    std::vector<std::uint64_t> MakeDelays(std::size_t count, std::uint32_t seed)
+    {
+        std::mt19937 gen{ seed };
+        std::uniform_int_distribution<std::uint64_t> turn(1, TurnTicks);
+        std::uniform_int_distribution<std::uint64_t> game(1, GameTicks);
+        std::vector<std::uint64_t> delays(count);
+        for (auto& delay : delays)
+        {
+            // Чаще срок хода, иногда - остаток запаса на партию
+            delay = (gen() & 3) == 0 ? game(gen) : turn(gen);
+        }
+        return delays;
+    }
+
+    double OpsPerSecond(std::size_t ops, Bench::Clock::time_point start)
+    {
+        return static_cast<double>(ops) / std::chrono::duration<double>(Bench::Clock::now() - start).count();
+    }
+
+    void RunWheel(std::size_t clocks, std::uint64_t ticks)
+    {
+        const auto delays = MakeDelays(clocks, 1);
+        TimingWheel wheel;
+        wheel.Reserve(clocks);
+        std::vector<TimingWheel::Handle> handles(clocks);
+
+        auto start = Bench::Clock::now();
+        for (std::size_t i = 0; i < clocks; ++i)
+        {
+            handles[i] = wheel.Arm(delays[i], i);
+        }
+        Bench::Report("wheel arm", OpsPerSecond(clocks, start) / 1e6, "M ops/s");
+
+        // Ход в комнате: отмена часов походившего и постановка часов соперника
+        std::mt19937 gen{ 2 };
+        std::vector<std::size_t> order(clocks);
+        for (auto& index : order)
+        {
+            index = gen() % clocks;
+        }
+        start = Bench::Clock::now();
+        for (std::size_t i = 0; i < clocks; ++i)
+        {
+            const std::size_t clock = order[i];
+            wheel.Cancel(handles[clock]);
+            handles[clock] = wheel.Arm(delays[clocks - 1 - i], clock);
+        }
+        Bench::Report("wheel cancel + arm", OpsPerSecond(clocks, start) / 1e6, "M ops/s");
+        Bench::Report("wheel active clocks", static_cast<double>(wheel.Size()), "");
+
+        // Тики с clocks активными часами; сработавшие сразу переставляются, как у партии,
+        // где ход перешёл к сопернику, - число часов не убывает
+        std::vector<double> tickNs;
+        tickNs.reserve(static_cast<std::size_t>(ticks));
+        std::size_t fired = 0;
+        std::size_t next = 0;
+        for (std::uint64_t tick = 1; tick <= ticks; ++tick)
+        {
+            const auto tickStart = Bench::Clock::now();
+            fired += wheel.Advance(tick, [&](std::uint64_t clock)
+                {
+                    handles[clock] = wheel.Arm(delays[next++ % clocks], clock);
+                });
+            tickNs.push_back(std::chrono::duration<double, std::nano>(Bench::Clock::now() - tickStart).count());
+        }
+        double total = 0.0;
+        for (double ns : tickNs)
+        {
+            total += ns;
+        }
+        Bench::Report("wheel ticks", static_cast<double>(ticks), "");
+        Bench::Report("wheel fired per tick", static_cast<double>(fired) / static_cast<double>(ticks), "");
+        Bench::Report("wheel tick mean", total / static_cast<double>(ticks) / 1000.0, "us");
+        Bench::Report("wheel tick p99", Bench::Percentile(tickNs, 0.99) / 1000.0, "us");
+        Bench::Report("wheel tick max", Bench::Percentile(tickNs, 1.0) / 1000.0, "us");
+        // Доля одного ядра на тики при тике 100 мс
+        Bench::Report("wheel tick cpu at 100 ms tick", total / static_cast<double>(ticks) / 1e8 * 100.0, "%");
+
+        start = Bench::Clock::now();
+        for (std::size_t i = 0; i < clocks; ++i)
+        {
+            wheel.Cancel(handles[i]);
+        }
+        Bench::Report("wheel cancel", OpsPerSecond(clocks, start) / 1e6, "M ops/s");
+    }
+
+    // Для сравнения: steady_timer на каждые часы. Перестановка отменяет ожидание, и его
+    // обработчик с operation_aborted проходит через очередь io_context
+    void RunSteadyTimers(std::size_t clocks)
+    {
+        const auto delays = MakeDelays(clocks, 1);
+        boost::asio::io_context ioc;
+        std::vector<std::unique_ptr<boost::asio::steady_timer>> timers;
+        timers.reserve(clocks);
+        std::size_t completions = 0;
+        auto onWait = [&completions](const boost::system::error_code&) { ++completions; };
+
+        auto start = Bench::Clock::now();
+        for (std::size_t i = 0; i < clocks; ++i)
+        {
+            timers.push_back(std::make_unique<boost::asio::steady_timer>(ioc, std::chrono::milliseconds(100 * delays[i])));
+            timers.back()->async_wait(onWait);
+        }
+        Bench::Report("steady_timer arm", OpsPerSecond(clocks, start) / 1e6, "M ops/s");
+
+        std::mt19937 gen{ 2 };
+        start = Bench::Clock::now();
+        for (std::size_t i = 0; i < clocks; ++i)
+        {
+            auto& timer = *timers[gen() % clocks];
+            timer.expires_after(std::chrono::milliseconds(100 * delays[clocks - 1 - i]));
+            timer.async_wait(onWait);
+            if ((i & 1023) == 0)
+            {
+                ioc.poll();
+            }
+        }
+        ioc.poll();
+        Bench::Report("steady_timer cancel + arm", OpsPerSecond(clocks, start) / 1e6, "M ops/s");
+
+        start = Bench::Clock::now();
+        for (auto& timer : timers)
+        {
+            timer->cancel();
+        }
+        ioc.poll();
+        Bench::Report("steady_timer cancel", OpsPerSecond(clocks, start) / 1e6, "M ops/s");
+        Bench::Consume(completions);
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // clocks [clocks] [ticks]: часы партий в иерархическом колесе - постановка, отмена и стоимость
+    // тика при clocks активных часах; для сравнения - steady_timer на каждые часы
+    int RunClockBench(int argc, char* argv[])
+    {
+        const std::size_t clocks = argc > 0 ? std::stoull(argv[0]) : 1000000;
+        const std::uint64_t ticks = argc > 1 ? std::stoull(argv[1]) : 2 * GameTicks;
+        Report("clocks", static_cast<double>(clocks), "");
+
+        RunWheel(clocks, ticks);
+        RunSteadyTimers(clocks);
+        return 0;
+    }
+}
@@ -0,0 +1,175 @@
+#include "Bench.h"
+#include "Endgame.h"
+#include "GameModel.h"
+#include "Strategy.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Конец партии density: позиции, начиная с хода, когда у противника осталось не больше двух кораблей
+    struct Endgame
+    {
+        std::vector<GameField> fields;
+    };
+
+    Endgame PlayToEndgame(IShotStrategy& bot, std::mt19937& gen)
+    {
+        GameModel model;
+        model.StartGame(gen);
+        GameField field = model.GetPlayerField(1);
+        Endgame endgame;
+        while (!field.allShipsDestroyed())
+        {
+            const ShotBoard board = ShotBoard::FromEnemyField(field);
+            if (RemainingShips(board).size() <= 2)
+            {
+                endgame.fields.push_back(field);
+            }
+            const Position shot = bot.NextShot(board, gen);
+            field.shoot(shot.row, shot.col);
+        }
+        return endgame;
+    }
+
+    // Промахов до конца партии, если дальше стреляет bot
+    int MissesToFinish(GameField field, IShotStrategy& bot, std::mt19937& gen)
+    {
+        int misses = 0;
+        while (!field.allShipsDestroyed())
+        {
+            const Position shot = bot.NextShot(ShotBoard::FromEnemyField(field), gen);
+            misses += field.shoot(shot.row, shot.col) ? 0 : 1;
+        }
+        return misses;
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // endgame [games] [threads] [table MB] [playouts]: точный решатель на концовках партий density.
+    // Потоки решают свои партии с общей таблицей транспозиций; затем из первой решённой позиции
+    // каждой партии доигрываются density и endgame, сравнивается число промахов
+    int RunEndgameBench(int argc, char* argv[])
+    {
+        const int games = argc > 0 ? std::stoi(argv[0]) : 300;
+        const int threadCount = argc > 1 ? std::stoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        const std::size_t tableMb = argc > 2 ? static_cast<std::size_t>(std::stoul(argv[2])) : 16;
+        const int playouts = argc > 3 ? std::stoi(argv[3]) : 8;
+        Report("games", games, "");
+        Report("threads", threadCount, "");
+
+        std::mt19937 gen{ 2024 };
+        auto density = MakeStrategy("density");
+        std::vector<Endgame> endgames;
+        std::size_t positions = 0;
+        for (int i = 0; i < games; ++i)
+        {
+            endgames.push_back(PlayToEndgame(*density, gen));
+            positions += endgames.back().fields.size();
+        }
+        Report("positions", static_cast<double>(positions), "");
+
+        TranspositionTable table(tableMb << 20);
+        Report("table", static_cast<double>(table.Capacity()), "entries");
+
+        const EndgameLimits limits;
+        std::vector<EndgameStats> stats(static_cast<std::size_t>(threadCount));
+        std::vector<std::vector<double>> times(static_cast<std::size_t>(threadCount));
+        // Первая позиция каждой партии, которую решатель взял
+        std::vector<int> firstSolved(endgames.size(), -1);
+        std::atomic<std::size_t> nextGame{ 0 };
+
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                EndgameSolver solver(table, limits);
+                for (std::size_t g = nextGame++; g < endgames.size(); g = nextGame++)
+                {
+                    const auto& fields = endgames[g].fields;
+                    for (std::size_t p = 0; p < fields.size(); ++p)
+                    {
+                        auto solveStart = Clock::now();
+                        auto shot = solver.Solve(ShotBoard::FromEnemyField(fields[p]));
+                        if (shot)
+                        {
+                            times[static_cast<std::size_t>(t)].push_back(std::chrono::duration<double, std::micro>(Clock::now() - solveStart).count());
+                            if (firstSolved[g] < 0)
+                            {
+                                firstSolved[g] = static_cast<int>(p);
+                            }
+                        }
+                    }
+                }
+                stats[static_cast<std::size_t>(t)] = solver.Stats();
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        const double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+        EndgameStats total;
+        std::vector<double> solveTimes;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            const auto& s = stats[static_cast<std::size_t>(t)];
+            total.solves += s.solves;
+            total.declined += s.declined;
+            total.aborted += s.aborted;
+            total.layouts += s.layouts;
+            total.nodes += s.nodes;
+            total.probes += s.probes;
+            total.hits += s.hits;
+            total.seconds += s.seconds;
+            solveTimes.insert(solveTimes.end(), times[static_cast<std::size_t>(t)].begin(), times[static_cast<std::size_t>(t)].end());
+        }
+
+        Report("solved", static_cast<double>(total.solves), "positions");
+        Report("declined", static_cast<double>(total.declined), "positions");
+        Report("aborted", static_cast<double>(total.aborted), "positions");
+        Report("layouts per solve", total.solves ? static_cast<double>(total.layouts) / static_cast<double>(total.solves) : 0.0, "");
+        Report("nodes", static_cast<double>(total.nodes), "");
+        Report("nodes/s", static_cast<double>(total.nodes) / wall, "");
+        Report("table probes", static_cast<double>(total.probes), "");
+        Report("table hit rate", total.probes ? 100.0 * static_cast<double>(total.hits) / static_cast<double>(total.probes) : 0.0, "%");
+        Report("solve p50", Percentile(solveTimes, 0.50), "us");
+        Report("solve p99", Percentile(solveTimes, 0.99), "us");
+        Report("solve max", Percentile(solveTimes, 1.0), "us");
+
+        // Доигрывание из первой решённой позиции: у обеих стратегий одинаковые зёрна
+        auto endgame = MakeStrategy("endgame");
+        double densityMisses = 0.0;
+        double endgameMisses = 0.0;
+        int finished = 0;
+        for (std::size_t g = 0; g < endgames.size(); ++g)
+        {
+            if (firstSolved[g] < 0)
+            {
+                continue;
+            }
+            const GameField& field = endgames[g].fields[static_cast<std::size_t>(firstSolved[g])];
+            for (int k = 0; k < playouts; ++k)
+            {
+                std::mt19937 densityGen(static_cast<std::uint32_t>(g * 7919 + static_cast<std::size_t>(k)));
+                std::mt19937 endgameGen = densityGen;
+                densityMisses += MissesToFinish(field, *density, densityGen);
+                endgameMisses += MissesToFinish(field, *endgame, endgameGen);
+                ++finished;
+            }
+        }
+        Report("misses to finish density", finished ? densityMisses / finished : 0.0, "");
+        Report("misses to finish endgame", finished ? endgameMisses / finished : 0.0, "");
+        return 0;
+    }
+}
@@ -0,0 +1,117 @@
+#include "Bench.h"
+#include "FleetPool.h"
+#include "GameModel.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Всплеск: matches партий начинаются одновременно в threads потоках.
+    // startGame(model) - способ начать партию; возвращает задержки начала каждой партии в нс.
+    template <typename StartFn>
+    std::vector<double> RunBurst(int matches, unsigned threads, StartFn startGame)
+    {
+        std::vector<double> latencies(static_cast<std::size_t>(matches));
+        std::atomic<unsigned> ready{ 0 };
+        std::atomic<bool> go{ false };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]()
+            {
+                auto model = std::make_unique<GameModel>();
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                for (int match = static_cast<int>(t); match < matches; match += static_cast<int>(threads))
+                {
+                    auto start = Bench::Clock::now();
+                    startGame(*model);
+                    latencies[static_cast<std::size_t>(match)] =
+                        std::chrono::duration<double, std::nano>(Bench::Clock::now() - start).count();
+                    Bench::Consume(static_cast<std::uint64_t>(model->GetCurrentPlayer()));
+                }
+            });
+        }
+
+        while (ready.load() < threads)
+        {
+            std::this_thread::yield();
+        }
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        return latencies;
+    }
+
+    void ReportBurst(const std::string& name, std::vector<double> latencies)
+    {
+        Bench::Report(name + " start p50", Bench::Percentile(latencies, 0.50), "ns");
+        Bench::Report(name + " start p99", Bench::Percentile(latencies, 0.99), "ns");
+        Bench::Report(name + " start max", Bench::Percentile(latencies, 1.0), "ns");
+    }
+
+    void ReportPool(const std::string& name, const FleetPool& pool)
+    {
+        auto stats = pool.Stats();
+        Bench::Report(name + " misses", static_cast<double>(stats.misses), "layouts");
+        Bench::Report(name + " depth after burst", static_cast<double>(stats.depth), "layouts");
+        Bench::Report(name + " refill rate", stats.refillRate, "layouts/s");
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // fleetpool [matches] [threads]: задержка начала партии при всплеске подключений -
+    // расстановка на месте против выдачи из пула
+    int RunFleetPoolBench(int argc, char* argv[])
+    {
+        const int matches = argc > 0 ? std::stoi(argv[0]) : 10000;
+        const unsigned threads = argc > 1 ? static_cast<unsigned>(std::stoul(argv[1]))
+                                          : std::max(4u, std::thread::hardware_concurrency());
+        Report("matches", matches, "");
+        Report("threads", threads, "");
+
+        // Прежнее поведение: обе расстановки в момент подключения второго игрока
+        ReportBurst("inline", RunBurst(matches, threads, [](GameModel& model)
+        {
+            thread_local std::mt19937 gen{ std::random_device{}() };
+            model.StartGame(gen);
+        }));
+
+        // Пул по умолчанию (4096): фоновый поток заполнил его заранее и дополняет во время всплеска
+        {
+            FleetPool pool(GameMode::Classic, 4096);
+            pool.Fill();
+            pool.Start();
+            ReportBurst("pool 4096", RunBurst(matches, threads, [&pool](GameModel& model)
+            {
+                model.StartGame(pool.Take<ClassicRules>(), pool.Take<ClassicRules>());
+            }));
+            ReportPool("pool 4096", pool);
+        }
+
+        // Пул с запасом на весь всплеск: начало партии - только два извлечения из очереди
+        {
+            FleetPool pool(GameMode::Classic, static_cast<std::size_t>(matches) * 2);
+            pool.Fill();
+            ReportBurst("pool full", RunBurst(matches, threads, [&pool](GameModel& model)
+            {
+                model.StartGame(pool.Take<ClassicRules>(), pool.Take<ClassicRules>());
+            }));
+            ReportPool("pool full", pool);
+        }
+        return 0;
+    }
+}
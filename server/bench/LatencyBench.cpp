@@ -0,0 +1,134 @@
+#include "Bench.h"
+#include "LoadClient.h"
+#include "ServerProcess.h"
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    constexpr const char* Host = "127.0.0.7";
+    constexpr unsigned short Port = 1366;  // не мешаем серверу, запущенному на основном порту
+
+    // Одна партия хозяина и гостя; задержки выстрелов обоих игроков добавляются в latencies
+    bool PlayOneGame(unsigned seed, std::vector<double>& latencies)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        std::promise<std::uint64_t> roomPromise;
+        auto roomFuture = roomPromise.get_future();
+        std::vector<double> guestLatencies;
+
+        std::thread guest([&]()
+        {
+            std::uint64_t roomId = roomFuture.get();
+            if (roomId == 0)
+            {
+                return;
+            }
+            boost::asio::io_context ioc;
+            std::mt19937 gen(seed + 1);
+            Bench::LoadClient client(ioc);
+            try
+            {
+                if (client.Connect(Host, Port, "/room/" + std::to_string(roomId)))
+                {
+                    client.PlayGame(gen, deadline);
+                    guestLatencies = client.shotLatencies();
+                }
+            }
+            catch (const std::exception&)
+            {
+            }
+            client.Close();
+        });
+
+        boost::asio::io_context ioc;
+        std::mt19937 gen(seed);
+        Bench::LoadClient host(ioc);
+        bool played = false;
+        try
+        {
+            if (host.Connect(Host, Port, "/room/new"))
+            {
+                roomPromise.set_value(host.room());
+                played = host.PlayGame(gen, deadline);
+            }
+        }
+        catch (const std::exception&)
+        {
+        }
+        if (!played)
+        {
+            try
+            {
+                roomPromise.set_value(0);
+            }
+            catch (const std::future_error&)
+            {
+            }
+        }
+        host.Close();
+        guest.join();
+
+        latencies.insert(latencies.end(), host.shotLatencies().begin(), host.shotLatencies().end());
+        latencies.insert(latencies.end(), guestLatencies.begin(), guestLatencies.end());
+        return played;
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // Задержка shot -> shot_result при включённом и выключенном TCP_NODELAY на сервере.
+    // Клиент всегда шлёт без задержки, так что разница - только в ответах сервера.
+    int RunLatencyBench(int argc, char* argv[])
+    {
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+        if (argc < 1)
+        {
+            std::cerr << "[bench] usage: server_bench latency <path-to-server> [games]" << std::endl;
+            return 1;
+        }
+        const std::string serverPath = argv[0];
+        const int games = argc > 1 ? std::stoi(argv[1]) : 5;
+
+        for (const char* nodelay : { "on", "off" })
+        {
+            pid_t server = SpawnServer(serverPath,
+                { "--listen", std::string(Host) + ":" + std::to_string(Port), "--tcp-nodelay", nodelay });
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+            std::vector<double> latencies;
+            int played = 0;
+            for (int game = 0; game < games; ++game)
+            {
+                played += PlayOneGame(1365u + static_cast<unsigned>(game), latencies) ? 1 : 0;
+            }
+            StopServer(server);
+
+            double mean = 0.0;
+            for (double value : latencies)
+            {
+                mean += value;
+            }
+            mean = latencies.empty() ? 0.0 : mean / static_cast<double>(latencies.size());
+
+            std::string name = std::string("TCP_NODELAY ") + nodelay;
+            Report(name + " shots", static_cast<double>(latencies.size()), "(" + std::to_string(played) + " games)");
+            Report(name + " shot_result mean", mean / 1000.0, "us");
+            Report(name + " shot_result p50", Percentile(latencies, 0.50) / 1000.0, "us");
+            Report(name + " shot_result p99", Percentile(latencies, 0.99) / 1000.0, "us");
+        }
+        return 0;
+#else
+        (void)argc;
+        (void)argv;
+        std::cerr << "[bench] latency benchmark requires posix_spawn" << std::endl;
+        return 0;
+#endif
+    }
+}
@@ -0,0 +1,176 @@
+#include "LoadClient.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace SeaBattle::Bench
+{
+    namespace
+    {
+        // Разбор Location вида ws://host:port/target
+        bool parseLocation(const std::string& location, std::string& host, unsigned short& port, std::string& target)
+        {
+            constexpr std::string_view scheme = "ws://";
+            if (location.compare(0, scheme.size(), scheme) != 0)
+            {
+                return false;
+            }
+            auto hostStart = scheme.size();
+            auto pathStart = location.find('/', hostStart);
+            auto colon = location.rfind(':', pathStart);
+            if (pathStart == std::string::npos || colon == std::string::npos || colon < hostStart)
+            {
+                return false;
+            }
+            host = location.substr(hostStart, colon - hostStart);
+            port = static_cast<unsigned short>(std::stoi(location.substr(colon + 1, pathStart - colon - 1)));
+            target = location.substr(pathStart);
+            return true;
+        }
+    }
+
+    LoadClient::LoadClient(boost::asio::io_context& ioc)
+        : m_ioc(ioc)
+    {
+    }
+
+    bool LoadClient::Connect(const std::string& host, unsigned short port, const std::string& target)
+    {
+        std::string currentHost = host;
+        unsigned short currentPort = port;
+        std::string currentTarget = target;
+        m_redirects = 0;
+
+        for (int attempt = 0; attempt < 3; ++attempt)
+        {
+            m_ws.emplace(m_ioc);
+            boost::system::error_code ec;
+            boost::asio::ip::tcp::endpoint endpoint{ boost::asio::ip::make_address(currentHost), currentPort };
+            m_ws->next_layer().connect(endpoint, ec);
+            if (ec)
+            {
+                return false;
+            }
+            m_ws->next_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+
+            // Асинхронное рукопожатие заполняет ответ и при отказе в апгрейде - нужен Location
+            boost::beast::websocket::response_type response;
+            m_ws->async_handshake(response, currentHost, currentTarget,
+                [&ec](boost::system::error_code result) { ec = result; });
+            m_ioc.restart();
+            m_ioc.run();
+            if (ec == boost::beast::websocket::error::upgrade_declined
+                && response.result() == boost::beast::http::status::temporary_redirect)
+            {
+                std::string location{ response[boost::beast::http::field::location] };
+                if (!parseLocation(location, currentHost, currentPort, currentTarget))
+                {
+                    return false;
+                }
+                ++m_redirects;
+                continue;
+            }
+            if (ec)
+            {
+                return false;
+            }
+
+            auto hello = Receive();
+            m_player = hello.value("player", -1);
+            m_room = hello.value("room", std::uint64_t{ 0 });
+            m_winner = -1;
+            return hello.value("type", "") == "hello";
+        }
+        return false;
+    }
+
+    void LoadClient::Close()
+    {
+        if (m_ws && m_ws->is_open())
+        {
+            boost::system::error_code ec;
+            m_ws->close(boost::beast::websocket::close_code::normal, ec);
+        }
+        m_ws.reset();
+    }
+
+    void LoadClient::Send(const nlohmann::json& message)
+    {
+        m_ws->write(boost::asio::buffer(message.dump()));
+    }
+
+    nlohmann::json LoadClient::Receive()
+    {
+        boost::beast::flat_buffer buffer;
+        m_ws->read(buffer);
+        return nlohmann::json::parse(boost::beast::buffers_to_string(buffer.data()), nullptr, false);
+    }
+
+    bool LoadClient::PlayGame(std::mt19937& gen, std::chrono::steady_clock::time_point deadline)
+    {
+        int currentPlayer = 0;
+        int gameState = 0;
+        int rows = 0;
+        int cols = 0;
+        m_shotLatencies.clear();
+
+        // Ждём второго игрока тем же опросом состояния, что и настоящий клиент
+        while (gameState != 1)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            Send({ {"type", "state"} });
+            auto state = Receive();
+            gameState = state.value("gameState", 0);
+            currentPlayer = state.value("currentPlayer", 0);
+            rows = state.value("rows", 10);
+            cols = state.value("cols", 10);
+            if (gameState != 1)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        std::vector<int> order(static_cast<std::size_t>(rows * cols));
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), gen);
+        std::size_t next = 0;
+
+        while (gameState == 1 && next < order.size())
+        {
+            nlohmann::json message;
+            if (currentPlayer == m_player)
+            {
+                int cell = order[next++];
+                auto sent = std::chrono::steady_clock::now();
+                Send({ {"type", "shot"}, {"row", cell / cols}, {"col", cell % cols} });
+                do
+                {
+                    message = Receive();
+                } while (message.value("type", "") != "shot_result");
+                m_shotLatencies.push_back(
+                    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - sent).count());
+            }
+            else
+            {
+                message = Receive();
+                if (message.value("type", "") != "opponent_shot")
+                {
+                    continue;
+                }
+            }
+            currentPlayer = message.value("currentPlayer", currentPlayer);
+            gameState = message.value("gameState", gameState);
+            m_winner = message.value("winner", m_winner);
+        }
+        return true;
+    }
+}
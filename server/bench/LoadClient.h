@@ -0,0 +1,54 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace SeaBattle::Bench
+{
+    // Синхронный клиент протокола игры для нагрузочных бенчмарков.
+    // Умеет проходить перенаправление на процесс-владелец комнаты.
+    class LoadClient
+    {
+    public:
+        explicit LoadClient(boost::asio::io_context& ioc);
+
+        // Подключается и читает hello; false, если подключение или рукопожатие не удалось
+        bool Connect(const std::string& host, unsigned short port, const std::string& target);
+        void Close();
+
+        void Send(const nlohmann::json& message);
+        nlohmann::json Receive();
+
+        // Ждёт начала партии и играет её до конца, стреляя в случайные клетки.
+        // Возвращает false, если соперник не появился до deadline.
+        bool PlayGame(std::mt19937& gen, std::chrono::steady_clock::time_point deadline);
+
+        int player() const { return m_player; }
+        std::uint64_t room() const { return m_room; }
+        int redirects() const { return m_redirects; }
+        bool won() const { return m_winner == m_player; }
+        // Время от отправки shot до получения shot_result в последней партии, нс
+        const std::vector<double>& shotLatencies() const { return m_shotLatencies; }
+
+    private:
+        using Stream = boost::beast::websocket::stream<boost::asio::ip::tcp::socket>;
+
+        boost::asio::io_context& m_ioc;
+        std::optional<Stream> m_ws;
+        int m_player = -1;
+        std::uint64_t m_room = 0;
+        int m_redirects = 0;
+        int m_winner = -1;
+        std::vector<double> m_shotLatencies;
+    };
+}
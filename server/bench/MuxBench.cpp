@@ -0,0 +1,210 @@
+#include "Bench.h"
+#include "LoadClient.h"
+#include "MuxClient.h"
+#include "ServerProcess.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using namespace SeaBattle;
+
+    constexpr const char* Host = "127.0.0.7";
+    constexpr unsigned short Port = 1367;  // не мешаем серверу, запущенному на основном порту
+
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+    struct ProcessUsage
+    {
+        double fds = 0.0;
+        double rssKb = 0.0;
+    };
+
+    ProcessUsage Usage(const std::string& pid)
+    {
+        ProcessUsage usage;
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it("/proc/" + pid + "/fd", ec), end; !ec && it != end; it.increment(ec))
+        {
+            usage.fds += 1.0;
+        }
+        std::ifstream status("/proc/" + pid + "/status");
+        for (std::string line; std::getline(status, line);)
+        {
+            if (line.rfind("VmRSS:", 0) == 0)
+            {
+                usage.rssKb = std::stod(line.substr(6));
+            }
+        }
+        return usage;
+    }
+
+    // Каждая партия - два своих соединения, как сейчас у ботов и нагрузочного клиента.
+    // Возвращает число партий, в которых оба игрока ответили на запрос состояния
+    int HoldSeparate(boost::asio::io_context& ioc, int games, std::vector<std::unique_ptr<Bench::LoadClient>>& clients)
+    {
+        for (int game = 0; game < games; ++game)
+        {
+            auto host = std::make_unique<Bench::LoadClient>(ioc);
+            auto guest = std::make_unique<Bench::LoadClient>(ioc);
+            if (!host->Connect(Host, Port, "/room/new") || !guest->Connect(Host, Port, "/room/" + std::to_string(host->room())))
+            {
+                std::cerr << "[bench] connection " << clients.size() << " failed (descriptor limit?)" << std::endl;
+                break;
+            }
+            clients.push_back(std::move(host));
+            clients.push_back(std::move(guest));
+        }
+
+        int live = 0;
+        for (auto& client : clients)
+        {
+            client->Send({ {"type", "state"} });
+            live += client->Receive().value("gameState", 0) == 1 ? 1 : 0;
+        }
+        return live / 2;
+    }
+
+    // Все партии - каналы одного соединения /mux: сначала хозяева всех комнат, потом гости
+    int HoldMultiplexed(Bench::MuxClient& client, int games)
+    {
+        auto hostChannel = [](int game) { return static_cast<std::uint32_t>(2 * game + 1); };
+        for (int game = 0; game < games; ++game)
+        {
+            client.Open(hostChannel(game), "/room/new");
+        }
+        client.Flush();
+        for (int received = 0; received < games;)
+        {
+            std::uint32_t channel = 0;
+            auto hello = client.Receive(channel);
+            if (hello.value("type", "") == "hello")
+            {
+                client.Open(channel + 1, "/room/" + std::to_string(hello.value("room", std::uint64_t{ 0 })));
+                ++received;
+            }
+        }
+        client.Flush();
+        for (int received = 0; received < games;)
+        {
+            std::uint32_t channel = 0;
+            received += client.Receive(channel).value("type", "") == "hello" ? 1 : 0;
+        }
+
+        for (std::uint32_t channel = 1; channel <= static_cast<std::uint32_t>(2 * games); ++channel)
+        {
+            client.Send(channel, { {"type", "state"} });
+        }
+        client.Flush();
+        int live = 0;
+        for (int received = 0; received < 2 * games;)
+        {
+            std::uint32_t channel = 0;
+            auto state = client.Receive(channel);
+            if (state.value("type", "") == "state")
+            {
+                live += state.value("gameState", 0) == 1 ? 1 : 0;
+                ++received;
+            }
+        }
+        return live / 2;
+    }
+
+    void ReportUsage(const std::string& name, int games, const ProcessUsage& before, const ProcessUsage& after)
+    {
+        const double scale = games > 0 ? 10000.0 / games : 0.0;
+        Bench::Report(name + " fds per 10k games", (after.fds - before.fds) * scale, "");
+        Bench::Report(name + " memory per 10k games", (after.rssKb - before.rssKb) * scale / 1024.0, "MiB");
+    }
+#endif
+}
+
+namespace SeaBattle::Bench
+{
+    // mux <path-to-server> [games]: дескрипторы и память сервера и клиента на удерживаемые партии -
+    // соединение на игрока против каналов одного соединения /mux
+    int RunMuxBench(int argc, char* argv[])
+    {
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+        if (argc < 1)
+        {
+            std::cerr << "[bench] usage: server_bench mux <path-to-server> [games]" << std::endl;
+            return 1;
+        }
+        const std::string serverPath = argv[0];
+        const int games = argc > 1 ? std::stoi(argv[1]) : 10000;
+        Report("games", games, "");
+
+        // Соединение на игрока - два дескриптора на партию в каждом процессе; сервер наследует лимит
+        rlimit limit{};
+        getrlimit(RLIMIT_NOFILE, &limit);
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+
+        const std::vector<std::string> args = { "--listen", std::string(Host) + ":" + std::to_string(Port),
+            "--bot-threads", "0", "--analytics-interval", "0" };
+        const std::string self = std::to_string(getpid());
+
+        for (bool multiplexed : { true, false })
+        {
+            const std::string name = multiplexed ? "mux" : "separate";
+            const pid_t server = SpawnServer(serverPath, args);
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            const std::string pid = std::to_string(server);
+            const auto serverBefore = Usage(pid);
+            const auto clientBefore = Usage(self);
+
+            boost::asio::io_context ioc;
+            std::vector<std::unique_ptr<LoadClient>> clients;
+            MuxClient mux(ioc);
+            const auto start = Clock::now();
+            int live = 0;
+            try
+            {
+                if (multiplexed)
+                {
+                    live = mux.Connect(Host, Port) ? HoldMultiplexed(mux, games) : 0;
+                }
+                else
+                {
+                    live = HoldSeparate(ioc, games, clients);
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                std::cerr << "[bench] " << name << ": " << ex.what() << std::endl;
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            const auto serverAfter = Usage(pid);
+            const auto clientAfter = Usage(self);
+            Report(name + " live games", live, "");
+            Report(name + " setup", seconds, "s");
+            ReportUsage(name + " server", live, serverBefore, serverAfter);
+            ReportUsage(name + " client", live, clientBefore, clientAfter);
+
+            mux.Close();
+            for (auto& client : clients)
+            {
+                client->Close();
+            }
+            StopServer(server);
+        }
+        return 0;
+#else
+        (void)argc;
+        (void)argv;
+        std::cerr << "[bench] mux benchmark requires posix_spawn and /proc" << std::endl;
+        return 0;
+#endif
+    }
+}
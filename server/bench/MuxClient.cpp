@@ -0,0 +1,87 @@
+#include "MuxClient.h"
+
+#include <boost/beast/core.hpp>
+
+namespace SeaBattle::Bench
+{
+    MuxClient::MuxClient(boost::asio::io_context& ioc)
+        : m_ioc(ioc)
+    {
+    }
+
+    bool MuxClient::Connect(const std::string& host, unsigned short port)
+    {
+        m_ws.emplace(m_ioc);
+        boost::system::error_code ec;
+        boost::asio::ip::tcp::endpoint endpoint{ boost::asio::ip::make_address(host), port };
+        m_ws->next_layer().connect(endpoint, ec);
+        if (ec)
+        {
+            return false;
+        }
+        m_ws->next_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+        m_ws->handshake(host, "/mux", ec);
+        return !ec;
+    }
+
+    void MuxClient::Close()
+    {
+        if (m_ws && m_ws->is_open())
+        {
+            boost::system::error_code ec;
+            m_ws->close(boost::beast::websocket::close_code::normal, ec);
+        }
+        m_ws.reset();
+        m_outbox.clear();
+        m_ready.clear();
+    }
+
+    void MuxClient::Open(std::uint32_t channel, const std::string& target)
+    {
+        Send(channel, { {"type", "open"}, {"target", target} });
+    }
+
+    void MuxClient::Send(std::uint32_t channel, nlohmann::json message)
+    {
+        message["ch"] = channel;
+        auto& queue = m_outbox[channel];
+        if (queue.empty())
+        {
+            m_ready.push_back(channel);
+        }
+        queue.push_back(message.dump());
+    }
+
+    void MuxClient::Flush()
+    {
+        while (!m_ready.empty())
+        {
+            const std::uint32_t channel = m_ready.front();
+            m_ready.pop_front();
+            auto& queue = m_outbox[channel];
+            m_ws->write(boost::asio::buffer(queue.front()));
+            queue.pop_front();
+            if (queue.empty())
+            {
+                m_outbox.erase(channel);
+            }
+            else
+            {
+                m_ready.push_back(channel);
+            }
+        }
+    }
+
+    nlohmann::json MuxClient::Receive(std::uint32_t& channel)
+    {
+        boost::beast::flat_buffer buffer;
+        m_ws->read(buffer);
+        auto message = nlohmann::json::parse(boost::beast::buffers_to_string(buffer.data()), nullptr, false);
+        channel = message.is_object() ? message.value("ch", 0u) : 0u;
+        if (message.is_object())
+        {
+            message.erase("ch");
+        }
+        return message;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace SeaBattle::Bench
+{
+    // Синхронный клиент мультиплексированного соединения (/mux): много партий в одном WebSocket.
+    // Исходящие сообщения копятся в очередях каналов, Flush отправляет их по кругу - по одному
+    // сообщению от канала за проход, как это делает сервер.
+    class MuxClient
+    {
+    public:
+        explicit MuxClient(boost::asio::io_context& ioc);
+
+        bool Connect(const std::string& host, unsigned short port);
+        void Close();
+
+        // Каналы нумеруются с 1; open занимает место по target ("/room/new", "/room/<id>", "/", "/bot")
+        void Open(std::uint32_t channel, const std::string& target);
+        void Send(std::uint32_t channel, nlohmann::json message);
+        void Flush();
+
+        // Следующее сообщение сервера (без поля "ch"); channel - его канал
+        nlohmann::json Receive(std::uint32_t& channel);
+
+    private:
+        using Stream = boost::beast::websocket::stream<boost::asio::ip::tcp::socket>;
+
+        boost::asio::io_context& m_ioc;
+        std::optional<Stream> m_ws;
+        std::unordered_map<std::uint32_t, std::deque<std::string>> m_outbox;
+        std::deque<std::uint32_t> m_ready;  // каналы с непустой очередью в порядке обхода
+    };
+}
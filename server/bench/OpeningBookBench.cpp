@@ -0,0 +1,127 @@
+#include "Bench.h"
+#include "GameModel.h"
+#include "OpeningBook.h"
+#include "Strategy.h"
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Позиции партии, сыгранной стратегией bot, и число выстрелов до победы
+    struct Played
+    {
+        std::vector<ShotBoard> boards;
+        int shots = 0;
+    };
+
+    Played Play(IShotStrategy& bot, std::mt19937& gen)
+    {
+        GameModel model;
+        model.StartGame(gen);
+        GameField field = model.GetPlayerField(1);
+        Played played;
+        while (!field.allShipsDestroyed())
+        {
+            played.boards.push_back(ShotBoard::FromEnemyField(field));
+            const Position shot = bot.NextShot(played.boards.back(), gen);
+            field.shoot(shot.row, shot.col);
+            ++played.shots;
+        }
+        return played;
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // book [samples] [games]: сборка книги дебютов, стоимость отображения файла при старте,
+    // задержка поиска по сравнению с расчётом density, выигрыш в выстрелах на партию
+    int RunOpeningBookBench(int argc, char* argv[])
+    {
+        OpeningBookOptions options;
+        options.samples = argc > 0 ? std::stoi(argv[0]) : options.samples;
+        const int games = argc > 1 ? std::stoi(argv[1]) : 500;
+        const std::string path = (std::filesystem::temp_directory_path() / "seabattle_bench.book").string();
+
+        auto start = Clock::now();
+        OpeningBook::Write(path, OpeningBook::Build(options), options);
+        Report("build", std::chrono::duration<double, std::milli>(Clock::now() - start).count(), "ms");
+
+        // Старт сервера: открыть и отобразить файл, затем первый поиск (подгрузка страниц)
+        constexpr int opens = 200;
+        std::vector<double> openTimes;
+        std::vector<double> firstLookupTimes;
+        for (int i = 0; i < opens; ++i)
+        {
+            auto openStart = Clock::now();
+            OpeningBook book(path);
+            auto opened = Clock::now();
+            Consume(book.Lookup(ShotBoard{}).has_value() ? 1 : 0);
+            openTimes.push_back(std::chrono::duration<double, std::micro>(opened - openStart).count());
+            firstLookupTimes.push_back(std::chrono::duration<double, std::micro>(Clock::now() - opened).count());
+        }
+        Report("open p50", Percentile(openTimes, 0.50), "us");
+        Report("open p99", Percentile(openTimes, 0.99), "us");
+        Report("first lookup p50", Percentile(firstLookupTimes, 0.50), "us");
+
+        auto book = std::make_shared<const OpeningBook>(path);
+        Report("positions", static_cast<double>(book->Size()), "");
+        Report("file", static_cast<double>(book->Bytes()), "bytes");
+
+        // Партии с книгой и без на одинаковых зёрнах
+        auto density = MakeStrategy("density");
+        BookStrategy withBook(book, MakeStrategy("density"));
+        std::vector<ShotBoard> inBook;
+        std::vector<ShotBoard> outOfBook;
+        double densityShots = 0.0;
+        double bookShots = 0.0;
+        for (int g = 0; g < games; ++g)
+        {
+            std::mt19937 densityGen(static_cast<std::uint32_t>(g) * 7919u + 1u);
+            std::mt19937 bookGen = densityGen;
+            densityShots += Play(*density, densityGen).shots;
+            Played played = Play(withBook, bookGen);
+            bookShots += played.shots;
+            for (const auto& board : played.boards)
+            {
+                (book->Lookup(board) ? inBook : outOfBook).push_back(board);
+            }
+        }
+        Report("book moves per game", static_cast<double>(inBook.size()) / games, "");
+        Report("shots per game density", densityShots / games, "");
+        Report("shots per game book+density", bookShots / games, "");
+
+        // Поиск быстрее таймера: меряем проходами по всем позициям
+        const int rounds = 20;
+        const double hitNs = MeasureNs(rounds, [&](int) {
+            for (const auto& board : inBook)
+            {
+                Consume(static_cast<std::uint64_t>(book->Lookup(board)->row));
+            }
+        }) / static_cast<double>(inBook.size());
+        const double missNs = MeasureNs(rounds, [&](int) {
+            for (const auto& board : outOfBook)
+            {
+                Consume(book->Lookup(board).has_value() ? 1 : 0);
+            }
+        }) / static_cast<double>(outOfBook.size());
+        std::mt19937 gen{ 7 };
+        const double densityNs = MeasureNs(1, [&](int) {
+            for (const auto& board : inBook)
+            {
+                Consume(static_cast<std::uint64_t>(density->NextShot(board, gen).row));
+            }
+        }) / static_cast<double>(inBook.size());
+        Report("lookup hit", hitNs, "ns");
+        Report("lookup miss", missNs, "ns");
+        Report("density NextShot on book positions", densityNs, "ns");
+
+        std::filesystem::remove(path);
+        return 0;
+    }
+}
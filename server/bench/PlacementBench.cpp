@@ -0,0 +1,110 @@
+#include "Bench.h"
+#include "FleetPool.h"
+#include "FleetValidator.h"
+#include "GameModel.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    template <typename R>
+    using Layout = std::array<ShipPlacement, R::FleetSize>;
+
+    // Набор расстановок, как от ботов: половина корректные, в остальных один корабль сдвинут
+    // в случайное место (обычно он касается или пересекает соседа)
+    template <typename R>
+    std::vector<Layout<R>> MakeLayouts(int count, std::mt19937& gen)
+    {
+        std::uniform_int_distribution<int> rowDist(0, R::Rows - 1);
+        std::uniform_int_distribution<int> colDist(0, R::Cols - 1);
+        std::uniform_int_distribution<int> shipDist(0, R::FleetSize - 1);
+
+        std::vector<Layout<R>> layouts(static_cast<std::size_t>(count));
+        for (int i = 0; i < count; ++i)
+        {
+            auto field = FleetPool::MakeFleet<R>(gen);
+            auto& layout = layouts[static_cast<std::size_t>(i)];
+            for (int s = 0; s < R::FleetSize; ++s)
+            {
+                const Ship& ship = field.getShips()[static_cast<std::size_t>(s)];
+                layout[static_cast<std::size_t>(s)] = { static_cast<int>(ship.type), ship.positions[0].row, ship.positions[0].col, ship.isVertical };
+            }
+            if (i % 2 == 1)
+            {
+                auto& moved = layout[static_cast<std::size_t>(shipDist(gen))];
+                moved.row = rowDist(gen);
+                moved.col = colDist(gen);
+            }
+        }
+        return layouts;
+    }
+
+    // Прежний способ: расставлять корабли на поле по одному через canPlaceShip
+    template <typename R>
+    bool ValidateByPlacing(const Layout<R>& layout)
+    {
+        BasicGameField<R> field;
+        for (const auto& ship : layout)
+        {
+            if (!BasicFleetValidator<R>::Fits(ship))
+            {
+                return false;
+            }
+            if (!field.placeShip(Ship(static_cast<ShipType>(ship.size), ship.row, ship.col, ship.vertical)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename R>
+    void RunForRules(std::string_view name)
+    {
+        std::mt19937 gen(42);
+        constexpr int count = 4096;
+        const auto layouts = MakeLayouts<R>(count, gen);
+
+        // Обе проверки должны соглашаться: иначе сравнение скорости бессмысленно
+        int valid = 0;
+        for (const auto& layout : layouts)
+        {
+            bool byMasks = BasicFleetValidator<R>::Validate(layout) == FleetError::None;
+            if (byMasks != ValidateByPlacing<R>(layout))
+            {
+                std::cerr << "[bench] " << name << ": validators disagree" << std::endl;
+                return;
+            }
+            valid += byMasks ? 1 : 0;
+        }
+        Bench::Report(std::string(name) + " valid layouts", valid * 100.0 / count, "%");
+
+        constexpr int iterations = 2000000;
+        double maskNs = Bench::MeasureNs(iterations, [&](int i)
+        {
+            Bench::Consume(static_cast<std::uint64_t>(BasicFleetValidator<R>::Validate(layouts[static_cast<std::size_t>(i % count)])));
+        });
+        double placeNs = Bench::MeasureNs(iterations, [&](int i)
+        {
+            Bench::Consume(ValidateByPlacing<R>(layouts[static_cast<std::size_t>(i % count)]) ? 1 : 0);
+        });
+        Bench::Report(std::string(name) + " bitmask validation", 1e9 / maskNs, "validations/s");
+        Bench::Report(std::string(name) + " canPlaceShip validation", 1e9 / placeNs, "validations/s");
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    int RunPlacementBench(int, char*[])
+    {
+        RunForRules<ClassicRules>("classic");
+        RunForRules<BlitzRules>("blitz");
+        RunForRules<LargeRules>("large");
+        RunForRules<TouchingRules>("touching");
+        return 0;
+    }
+}
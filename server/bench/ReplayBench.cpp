@@ -0,0 +1,119 @@
+#include "Bench.h"
+#include "GameModel.h"
+#include "Replay.h"
+#include "Strategy.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    struct RecordedGame
+    {
+        GameModel start;
+        std::vector<ReplayShot> shots;
+    };
+
+    // Партия двух ботов от начала до конца: начальная позиция и все выстрелы
+    RecordedGame PlayGame(IShotStrategy& first, IShotStrategy& second, std::mt19937& gen)
+    {
+        RecordedGame game;
+        game.start.StartGame(gen);
+        GameModel model = game.start;
+        IShotStrategy* bots[2] = { &first, &second };
+        while (model.GetGameState() == GameState::Playing)
+        {
+            const int player = model.GetCurrentPlayer();
+            Position shot = bots[player]->NextShot(ShotBoard::FromEnemyField(model.GetEnemyField(player)), gen);
+            model.ProcessShot(player, shot.row, shot.col);
+            game.shots.push_back({ static_cast<std::int8_t>(player), shot.row, shot.col });
+        }
+        return game;
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // replay [games] [seeks per game] [checkpoint interval]: архив партий ботов открывается
+    // подряд, в каждой - переходы к случайным ходам, как при перетаскивании ползунка
+    int RunReplayBench(int argc, char* argv[])
+    {
+        const int games = argc > 0 ? std::stoi(argv[0]) : 2000;
+        const int seeksPerGame = argc > 1 ? std::stoi(argv[1]) : 200;
+        const int interval = argc > 2 ? std::stoi(argv[2]) : Replay::DefaultCheckpointInterval;
+        Report("games", games, "");
+        Report("checkpoint interval", interval, "moves");
+
+        std::mt19937 gen{ 12345 };
+        auto hunt = MakeStrategy("hunt");
+        auto random = MakeStrategy("random");
+        std::vector<RecordedGame> archive;
+        archive.reserve(static_cast<std::size_t>(games));
+        std::size_t totalMoves = 0;
+        for (int i = 0; i < games; ++i)
+        {
+            // Половина партий - длинные (случайный бот стреляет почти по всему полю)
+            archive.push_back(i % 2 == 0 ? PlayGame(*hunt, *hunt, gen) : PlayGame(*random, *hunt, gen));
+            totalMoves += archive.back().shots.size();
+        }
+        Report("moves per game", static_cast<double>(totalMoves) / games, "moves");
+
+        std::vector<double> opens;
+        std::vector<double> seeks;
+        opens.reserve(static_cast<std::size_t>(games));
+        seeks.reserve(static_cast<std::size_t>(games) * static_cast<std::size_t>(seeksPerGame));
+        std::size_t checkpointBytes = 0;
+        for (const auto& game : archive)
+        {
+            auto start = Clock::now();
+            Replay replay(game.start, game.shots, interval);
+            opens.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            checkpointBytes += (static_cast<std::size_t>(replay.MoveCount()) / static_cast<std::size_t>(interval) + 1) * sizeof(GameModel);
+
+            std::uniform_int_distribution<int> moveDist(0, replay.MoveCount());
+            for (int s = 0; s < seeksPerGame; ++s)
+            {
+                const int move = moveDist(gen);
+                auto seekStart = Clock::now();
+                const GameModel& model = replay.Seek(move);
+                seeks.push_back(std::chrono::duration<double, std::nano>(Clock::now() - seekStart).count());
+                Consume(static_cast<std::uint64_t>(model.GetCurrentPlayer()));
+            }
+        }
+
+        Report("checkpoints", static_cast<double>(checkpointBytes) / games, "bytes/game");
+        Report("open p50", Percentile(opens, 0.50), "ns");
+        Report("open p99", Percentile(opens, 0.99), "ns");
+        Report("seek p50", Percentile(seeks, 0.50), "ns");
+        Report("seek p99", Percentile(seeks, 0.99), "ns");
+        Report("seek max", Percentile(seeks, 1.0), "ns");
+
+        // Для сравнения: переход без контрольных точек - розыгрыш с начала партии
+        std::vector<double> fromStart;
+        fromStart.reserve(seeks.size());
+        for (const auto& game : archive)
+        {
+            std::uniform_int_distribution<int> moveDist(0, static_cast<int>(game.shots.size()));
+            for (int s = 0; s < seeksPerGame; ++s)
+            {
+                const int move = moveDist(gen);
+                auto seekStart = Clock::now();
+                GameModel model = game.start;
+                for (int m = 0; m < move; ++m)
+                {
+                    const ReplayShot& shot = game.shots[static_cast<std::size_t>(m)];
+                    model.ProcessShot(shot.player, shot.row, shot.col);
+                }
+                fromStart.push_back(std::chrono::duration<double, std::nano>(Clock::now() - seekStart).count());
+                Consume(static_cast<std::uint64_t>(model.GetCurrentPlayer()));
+            }
+        }
+        Report("replay from start p50", Percentile(fromStart, 0.50), "ns");
+        Report("replay from start p99", Percentile(fromStart, 0.99), "ns");
+        return 0;
+    }
+}
@@ -0,0 +1,174 @@
+#include "Bench.h"
+#include "MuxClient.h"
+#include "ServerProcess.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    constexpr const char* Host = "127.0.0.8";
+    constexpr unsigned short Port = 1368;  // не мешаем серверу, запущенному на основном порту
+    constexpr unsigned short AdminPort = 1369;
+
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+    // Учёт памяти комнат сервера: GET /admin/rooms на адресе админки
+    nlohmann::json FetchRooms(boost::asio::io_context& ioc)
+    {
+        namespace http = boost::beast::http;
+        boost::asio::ip::tcp::socket socket(ioc);
+        boost::asio::ip::tcp::resolver resolver(ioc);
+        boost::asio::connect(socket, resolver.resolve(Host, std::to_string(AdminPort)));
+        http::request<http::empty_body> request{ http::verb::get, "/admin/rooms", 11 };
+        request.set(http::field::host, Host);
+        http::write(socket, request);
+        boost::beast::flat_buffer buffer;
+        http::response<http::string_body> response;
+        http::read(socket, buffer, response);
+        return nlohmann::json::parse(response.body());
+    }
+
+    // Следующее сообщение канала channel с типом type или ошибка в нём; остальное пропускается
+    nlohmann::json WaitFor(Bench::MuxClient& client, std::uint32_t channel, std::string_view type)
+    {
+        for (;;)
+        {
+            std::uint32_t from = 0;
+            auto message = client.Receive(from);
+            const std::string received = message.value("type", "");
+            if (from == channel && (received == type || received == "error"))
+            {
+                return message;
+            }
+        }
+    }
+
+    // Партия в канале host (создаёт комнату) и guest; hostOpenUs - время от open до hello.
+    // false - сервер не дал создать комнату
+    bool StartGame(Bench::MuxClient& client, std::uint32_t host, std::uint32_t guest, std::vector<double>& hostOpenUs)
+    {
+        const auto start = Bench::Clock::now();
+        client.Open(host, "/room/new");
+        client.Flush();
+        const auto hello = WaitFor(client, host, "hello");
+        hostOpenUs.push_back(std::chrono::duration<double, std::micro>(Bench::Clock::now() - start).count());
+        if (hello.value("type", "") != "hello")
+        {
+            return false;
+        }
+        client.Open(guest, "/room/" + std::to_string(hello.value("room", std::uint64_t{ 0 })));
+        client.Flush();
+        return WaitFor(client, guest, "hello").value("type", "") == "hello";
+    }
+
+    void ReportRooms(const std::string& name, const nlohmann::json& rooms)
+    {
+        for (const char* key : { "resident", "idle", "bytesPerRoom", "evicted", "rejected" })
+        {
+            Bench::Report(name + " " + key, rooms.value(key, 0.0), "");
+        }
+        Bench::Report(name + " free list reused", rooms["freeList"].value("reused", 0.0), "");
+        Bench::Report(name + " free list allocated", rooms["freeList"].value("allocated", 0.0), "");
+    }
+
+    void ReportLatency(const std::string& name, std::vector<double>& us)
+    {
+        Bench::Report(name + " p50", Bench::Percentile(us, 0.5), "us");
+        Bench::Report(name + " p99", Bench::Percentile(us, 0.99), "us");
+    }
+#endif
+}
+
+namespace SeaBattle::Bench
+{
+    // rooms <path-to-server> [memory-mb] [games]: сервер с потолком памяти комнат. Сначала games
+    // брошенных партий - комнат резидентно не больше потолка, лишние вытесняются, отказов нет;
+    // потом живые партии до отказа server_full - сколько их помещается под потолок
+    int RunRoomsBench(int argc, char* argv[])
+    {
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+        if (argc < 1)
+        {
+            std::cerr << "[bench] usage: server_bench rooms <path-to-server> [memory-mb] [games]" << std::endl;
+            return 1;
+        }
+        const std::string serverPath = argv[0];
+        const std::string memoryMb = argc > 1 ? argv[1] : "1";
+        const int games = argc > 2 ? std::stoi(argv[2]) : 5000;
+        Report("room memory", std::stod(memoryMb), "MiB");
+
+        // TTL не успевает сработать: вытесняет только потолок
+        const pid_t server = SpawnServer(serverPath, { "--listen", std::string(Host) + ":" + std::to_string(Port),
+            "--bot-threads", "0", "--analytics-interval", "0", "--turn-timeout", "0", "--game-timeout", "0",
+            "--room-memory", memoryMb, "--room-ttl", "3600",
+            "--admin-listen", std::string(Host) + ":" + std::to_string(AdminPort) });
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+        boost::asio::io_context ioc;
+        MuxClient client(ioc);
+        try
+        {
+            if (!client.Connect(Host, Port))
+            {
+                std::cerr << "[bench] rooms: connection failed" << std::endl;
+                StopServer(server);
+                return 1;
+            }
+
+            // Брошенные партии: оба игрока уходят из начатой партии, комната простаивает
+            std::vector<double> churnUs;
+            churnUs.reserve(static_cast<std::size_t>(games));
+            int created = 0;
+            for (int game = 0; game < games; ++game)
+            {
+                if (!StartGame(client, 1, 2, churnUs))
+                {
+                    break;
+                }
+                ++created;
+                for (std::uint32_t channel : { 1u, 2u })
+                {
+                    client.Send(channel, { {"type", "close"} });
+                }
+                client.Flush();
+                WaitFor(client, 1, "closed");
+                WaitFor(client, 2, "closed");
+            }
+            Report("abandoned games", created, "");
+            ReportLatency("room open under eviction", churnUs);
+            ReportRooms("after abandoned", FetchRooms(ioc));
+
+            // Живые партии не вытесняются: новые комнаты получают отказ, когда потолок занят ими
+            // (без потолка - memory-mb 0 - партий столько же, сколько брошенных)
+            std::vector<double> liveUs;
+            int live = 0;
+            for (std::uint32_t host = 3; live < games && StartGame(client, host, host + 1, liveUs); host += 2)
+            {
+                ++live;
+            }
+            Report("live games at ceiling", live, "");
+            ReportLatency("room open while filling", liveUs);
+            ReportRooms("at ceiling", FetchRooms(ioc));
+        }
+        catch (const std::exception& ex)
+        {
+            std::cerr << "[bench] rooms: " << ex.what() << std::endl;
+        }
+        client.Close();
+        StopServer(server);
+        return 0;
+#else
+        (void)argc;
+        (void)argv;
+        std::cerr << "[bench] rooms benchmark requires posix_spawn" << std::endl;
+        return 0;
+#endif
+    }
+}
@@ -0,0 +1,109 @@
+#include "Bench.h"
+#include "GameModel.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Расстановка флота и полная партия со случайными выстрелами для одного варианта правил
+    template <typename R>
+    void RunForRules(std::string_view name)
+    {
+        constexpr int placements = 20000;
+        double placeNs = Bench::MeasureNs(placements, [](int)
+        {
+            BasicGameField<R> field;
+            Bench::Consume(BasicShipPlacer<R>::autoPlaceShips(field) ? 1 : 0);
+        });
+        Bench::Report(std::string(name) + " autoPlaceShips", placeNs, "ns/field");
+
+        std::mt19937 gen(1365);
+        std::array<int, R::Cells> order{};
+        std::iota(order.begin(), order.end(), 0);
+
+        constexpr int games = 5000;
+        std::uint64_t totalShots = 0;
+        double gameNs = Bench::MeasureNs(games, [&](int)
+        {
+            BasicGameModel<R> model;
+            model.StartGame();
+
+            std::array<std::array<int, R::Cells>, 2> shots{ order, order };
+            std::shuffle(shots[0].begin(), shots[0].end(), gen);
+            std::shuffle(shots[1].begin(), shots[1].end(), gen);
+            std::array<int, 2> next{ 0, 0 };
+
+            while (model.GetGameState() == GameState::Playing)
+            {
+                int player = model.GetCurrentPlayer();
+                int cell = shots[player][next[player]++];
+                model.ProcessShot(player, cell / R::Cols, cell % R::Cols);
+                ++totalShots;
+            }
+            Bench::Consume(static_cast<std::uint64_t>(model.GetWinner()));
+        });
+        Bench::Report(std::string(name) + " random game", gameNs / 1000.0, "us/game");
+        Bench::Report(std::string(name) + " ProcessShot",
+            gameNs * games / static_cast<double>(totalShots), "ns/shot (incl. placement)");
+    }
+
+    // Партия залпами: за ход - по выстрелу на уцелевший корабль, один ответ на ход.
+    // Ходов (и пар сообщений протокола) в партии меньше, чем выстрелов
+    void RunSalvo()
+    {
+        using R = SalvoRules;
+        std::mt19937 gen(1365);
+        std::array<int, R::Cells> order{};
+        std::iota(order.begin(), order.end(), 0);
+
+        constexpr int games = 5000;
+        std::uint64_t totalShots = 0;
+        std::uint64_t totalTurns = 0;
+        double gameNs = Bench::MeasureNs(games, [&](int)
+        {
+            BasicGameModel<R> model;
+            model.StartGame();
+
+            std::array<std::array<int, R::Cells>, 2> shots{ order, order };
+            std::shuffle(shots[0].begin(), shots[0].end(), gen);
+            std::shuffle(shots[1].begin(), shots[1].end(), gen);
+            std::array<int, 2> next{ 0, 0 };
+
+            while (model.GetGameState() == GameState::Playing)
+            {
+                int player = model.GetCurrentPlayer();
+                BasicGameModel<R>::ShotMask salvo;
+                for (int i = model.SalvoSize(player); i > 0; --i)
+                {
+                    salvo.set(shots[player][next[player]++]);
+                }
+                Bench::Consume(static_cast<std::uint64_t>(model.ProcessSalvo(player, salvo).count()));
+                totalShots += static_cast<std::uint64_t>(salvo.count());
+                ++totalTurns;
+            }
+            Bench::Consume(static_cast<std::uint64_t>(model.GetWinner()));
+        });
+        Bench::Report("salvo random game", gameNs / 1000.0, "us/game");
+        Bench::Report("salvo ProcessSalvo", gameNs * games / static_cast<double>(totalShots), "ns/shot (incl. placement)");
+        Bench::Report("salvo shots", static_cast<double>(totalShots) / games, "per game");
+        Bench::Report("salvo turns", static_cast<double>(totalTurns) / games, "per game (one result frame each)");
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    int RunRulesBench(int, char*[])
+    {
+        RunForRules<ClassicRules>("classic");
+        RunForRules<BlitzRules>("blitz");
+        RunForRules<LargeRules>("large");
+        RunForRules<TouchingRules>("touching");
+        RunSalvo();
+        return 0;
+    }
+}
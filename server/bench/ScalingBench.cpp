@@ -0,0 +1,154 @@
+#include "Bench.h"
+#include "LoadClient.h"
+#include "ServerProcess.h"
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    constexpr const char* Host = "127.0.0.7";
+    constexpr unsigned short Port = 1365;
+
+    // Пара клиентов играет партии подряд: хозяин создаёт комнату, гость подключается к ней по id.
+    // Гость может попасть в чужой процесс - тогда сервер перенаправляет его к владельцу комнаты.
+    void RunPair(std::chrono::steady_clock::time_point deadline, unsigned seed,
+        std::atomic<std::uint64_t>& games, std::atomic<std::uint64_t>& redirects)
+    {
+        boost::asio::io_context ioc;
+        std::mt19937 gen(seed);
+        const auto gameDeadline = deadline + std::chrono::seconds(10);
+
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            std::promise<std::uint64_t> roomPromise;
+            auto roomFuture = roomPromise.get_future();
+
+            std::thread guest([&, guestSeed = static_cast<unsigned>(gen())]()
+            {
+                std::uint64_t roomId = roomFuture.get();
+                if (roomId == 0)
+                {
+                    return;
+                }
+                boost::asio::io_context guestIoc;
+                std::mt19937 guestGen(guestSeed);
+                Bench::LoadClient client(guestIoc);
+                try
+                {
+                    if (client.Connect(Host, Port, "/room/" + std::to_string(roomId)))
+                    {
+                        redirects += static_cast<std::uint64_t>(client.redirects());
+                        client.PlayGame(guestGen, gameDeadline);
+                    }
+                }
+                catch (const std::exception&)
+                {
+                    // Хозяин ушёл раньше времени - партия просто не засчитывается
+                }
+                client.Close();
+            });
+
+            Bench::LoadClient host(ioc);
+            bool connected = false;
+            try
+            {
+                connected = host.Connect(Host, Port, "/room/new");
+            }
+            catch (const std::exception&)
+            {
+            }
+            if (!connected)
+            {
+                roomPromise.set_value(0);
+                guest.join();
+                break;
+            }
+            roomPromise.set_value(host.room());
+            bool played = false;
+            try
+            {
+                played = host.PlayGame(gen, gameDeadline);
+            }
+            catch (const std::exception&)
+            {
+            }
+            host.Close();
+            guest.join();
+
+            if (played)
+            {
+                ++games;
+            }
+        }
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    int RunScalingBench(int argc, char* argv[])
+    {
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+        if (argc < 1)
+        {
+            std::cerr << "[bench] usage: server_bench scaling <path-to-server> [seconds] [pairs-per-process]" << std::endl;
+            return 1;
+        }
+        const std::string serverPath = argv[0];
+        const int seconds = argc > 1 ? std::stoi(argv[1]) : 5;
+        const int pairsPerProcess = argc > 2 ? std::stoi(argv[2]) : 8;
+
+        double baseline = 0.0;
+        for (int processes : { 1, 2, 4, 8 })
+        {
+            std::vector<pid_t> servers;
+            for (int i = 0; i < processes; ++i)
+            {
+                servers.push_back(SpawnServer(serverPath));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+            std::atomic<std::uint64_t> games{ 0 };
+            std::atomic<std::uint64_t> redirects{ 0 };
+            auto start = Clock::now();
+            auto deadline = start + std::chrono::seconds(seconds);
+
+            std::vector<std::thread> pairs;
+            for (int i = 0; i < processes * pairsPerProcess; ++i)
+            {
+                pairs.emplace_back(RunPair, deadline, 1365u + static_cast<unsigned>(i), std::ref(games), std::ref(redirects));
+            }
+            for (auto& pair : pairs)
+            {
+                pair.join();
+            }
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+            for (pid_t pid : servers)
+            {
+                StopServer(pid);
+            }
+
+            double rate = static_cast<double>(games.load()) / elapsed;
+            if (processes == 1)
+            {
+                baseline = rate;
+            }
+            Report(std::to_string(processes) + " process(es) throughput", rate, "games/s");
+            Report(std::to_string(processes) + " process(es) scaling", baseline > 0 ? rate / baseline : 0.0, "x");
+            Report(std::to_string(processes) + " process(es) redirects", static_cast<double>(redirects.load()), "joins");
+        }
+        return 0;
+#else
+        (void)argc;
+        (void)argv;
+        std::cerr << "[bench] scaling benchmark requires SO_REUSEPORT and posix_spawn" << std::endl;
+        return 0;
+#endif
+    }
+}
@@ -0,0 +1,43 @@
+#include "ServerProcess.h"
+
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+
+namespace SeaBattle::Bench
+{
+    pid_t SpawnServer(const std::string& serverPath, const std::vector<std::string>& args)
+    {
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        // Журнал сервера подробный - не даём ему мерить скорость терминала
+        posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+
+        std::vector<char*> argv{ const_cast<char*>(serverPath.c_str()) };
+        for (const auto& arg : args)
+        {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid = 0;
+        int rc = posix_spawn(&pid, serverPath.c_str(), &actions, nullptr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        return rc == 0 ? pid : -1;
+    }
+
+    void StopServer(pid_t pid)
+    {
+        if (pid > 0)
+        {
+            kill(pid, SIGTERM);
+            waitpid(pid, nullptr, 0);
+        }
+    }
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#define SEABATTLE_BENCH_HAS_SPAWN 1
+#endif
+
+namespace SeaBattle::Bench
+{
+#ifdef SEABATTLE_BENCH_HAS_SPAWN
+    // Запускает процесс сервера с указанными аргументами, вывод отправляется в /dev/null.
+    // Возвращает -1, если запустить не удалось.
+    pid_t SpawnServer(const std::string& serverPath, const std::vector<std::string>& args = {});
+    void StopServer(pid_t pid);
+#endif
+}
@@ -0,0 +1,58 @@
+#include "Bench.h"
+#include "GameModel.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace SeaBattle;
+
+    // Снимок и восстановление партии посреди игры: копирование модели целиком
+    template <typename R>
+    void RunForRules(std::string_view name)
+    {
+        using Model = BasicGameModel<R>;
+
+        Model model;
+        model.StartGame();
+        for (int cell = 0; cell < R::Cells / 2 && model.GetGameState() == GameState::Playing; ++cell)
+        {
+            model.ProcessShot(model.GetCurrentPlayer(), cell / R::Cols, cell % R::Cols);
+        }
+
+        Bench::Report(std::string(name) + " model size", static_cast<double>(sizeof(Model)), "bytes/room");
+
+        // Кольцо снимков, чтобы копирование не сводилось к одному и тому же адресу
+        constexpr int ringSize = 1024;
+        std::vector<Model> ring(ringSize);
+
+        constexpr int iterations = 2000000;
+        double snapshotNs = Bench::MeasureNs(iterations, [&](int i)
+        {
+            std::memcpy(static_cast<void*>(&ring[i % ringSize]), &model, sizeof(Model));
+        });
+        Bench::Report(std::string(name) + " snapshot", snapshotNs, "ns");
+
+        Model restored;
+        double restoreNs = Bench::MeasureNs(iterations, [&](int i)
+        {
+            restored = ring[i % ringSize];
+            Bench::Consume(static_cast<std::uint64_t>(restored.GetCurrentPlayer()));
+        });
+        Bench::Report(std::string(name) + " restore", restoreNs, "ns");
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    int RunSnapshotBench(int, char*[])
+    {
+        RunForRules<ClassicRules>("classic");
+        RunForRules<BlitzRules>("blitz");
+        RunForRules<LargeRules>("large");
+        RunForRules<TouchingRules>("touching");
+        return 0;
+    }
+}
@@ -0,0 +1,163 @@
+#include "Bench.h"
+
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace
+{
+    using namespace SeaBattle;
+    using Socket = boost::asio::generic::stream_protocol::socket;
+    using Stream = boost::beast::websocket::stream<Socket>;
+
+    // Процессорное время всего процесса (клиент и сервер живут в нём оба), с
+    double processCpuSeconds()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        auto seconds = [](const timeval& tv) { return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1e-6; };
+        return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+    }
+
+    // Сторона сервера: на каждый shot - shot_result, как ServePlayer, но без партии.
+    // Разбор и сборка JSON остаются, чтобы сравнение было по всему пути сообщения
+    void ServeEcho(Socket socket)
+    {
+        Stream ws(std::move(socket));
+        ws.accept();
+        ws.text(true);
+        boost::beast::flat_buffer buffer;
+        for (;;)
+        {
+            boost::system::error_code ec;
+            ws.read(buffer, ec);
+            if (ec)
+            {
+                return;
+            }
+            auto request = nlohmann::json::parse(boost::beast::buffers_to_string(buffer.data()));
+            buffer.consume(buffer.size());
+            nlohmann::json response = {
+                { "type", "shot_result" },
+                { "row", request.value("row", 0) },
+                { "col", request.value("col", 0) },
+                { "hit", false },
+                { "player", 1 },
+            };
+            ws.write(boost::asio::buffer(response.dump()), ec);
+            if (ec)
+            {
+                return;
+            }
+        }
+    }
+
+    struct Result
+    {
+        std::vector<double> rtt;    // нс
+        double cpuNs = 0.0;         // процессорного времени на обмен, нс
+    };
+
+    // Подключается к acceptor, делает warmup + rounds обменов shot/shot_result
+    template <typename Acceptor, typename Endpoint>
+    Result Measure(Acceptor& acceptor, const Endpoint& endpoint, int rounds, bool noDelay)
+    {
+        boost::asio::io_context ioc;
+        std::thread server([&acceptor, noDelay]()
+        {
+            Socket socket(acceptor.get_executor());
+            acceptor.accept(socket);
+            if (noDelay)
+            {
+                socket.set_option(boost::asio::ip::tcp::no_delay(true));
+            }
+            ServeEcho(std::move(socket));
+        });
+
+        Stream ws(ioc);
+        ws.next_layer().connect(endpoint);
+        if (noDelay)
+        {
+            ws.next_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+        }
+        ws.handshake("localhost", "/");
+        ws.text(true);
+
+        Result result;
+        result.rtt.reserve(static_cast<std::size_t>(rounds));
+        boost::beast::flat_buffer buffer;
+        auto exchange = [&](int i)
+        {
+            nlohmann::json shot = { { "type", "shot" }, { "row", i % 10 }, { "col", (i / 10) % 10 } };
+            ws.write(boost::asio::buffer(shot.dump()));
+            ws.read(buffer);
+            Bench::Consume(buffer.size());
+            buffer.consume(buffer.size());
+        };
+        for (int i = 0; i < rounds / 10; ++i)
+        {
+            exchange(i);
+        }
+
+        const double cpuStart = processCpuSeconds();
+        for (int i = 0; i < rounds; ++i)
+        {
+            const auto start = Bench::Clock::now();
+            exchange(i);
+            result.rtt.push_back(std::chrono::duration<double, std::nano>(Bench::Clock::now() - start).count());
+        }
+        result.cpuNs = (processCpuSeconds() - cpuStart) * 1e9 / rounds;
+
+        ws.close(boost::beast::websocket::close_code::normal);
+        server.join();
+        return result;
+    }
+
+    void ReportResult(const std::string& name, Result result)
+    {
+        Bench::Report(name + " rtt p50", Bench::Percentile(result.rtt, 0.50) / 1000.0, "us");
+        Bench::Report(name + " rtt p99", Bench::Percentile(result.rtt, 0.99) / 1000.0, "us");
+        Bench::Report(name + " cpu", result.cpuNs / 1000.0, "us/round trip");
+    }
+}
+
+namespace SeaBattle::Bench
+{
+    // transport [rounds]: обмен shot/shot_result через WebSocket и JSON поверх loopback TCP
+    // и unix-сокета; сервер и клиент в одном процессе, процессор считается на обоих
+    int RunTransportBench(int argc, char* argv[])
+    {
+        const int rounds = argc > 0 ? std::stoi(argv[0]) : 20000;
+        Report("rounds", rounds, "");
+
+        boost::asio::io_context ioc;
+        {
+            boost::asio::ip::tcp::acceptor acceptor(ioc, { boost::asio::ip::make_address("127.0.0.1"), 0 });
+            const boost::asio::generic::stream_protocol::endpoint endpoint(acceptor.local_endpoint());
+            ReportResult("loopback tcp", Measure(acceptor, endpoint, rounds, true));
+        }
+        {
+            const auto path = (std::filesystem::temp_directory_path() / ("seabattle-bench-" + std::to_string(getpid()) + ".sock")).string();
+            std::filesystem::remove(path);
+            boost::asio::local::stream_protocol::acceptor acceptor(ioc, boost::asio::local::stream_protocol::endpoint(path));
+            const boost::asio::generic::stream_protocol::endpoint endpoint(acceptor.local_endpoint());
+            ReportResult("unix socket", Measure(acceptor, endpoint, rounds, false));
+            std::filesystem::remove(path);
+        }
+        return 0;
+    }
+}
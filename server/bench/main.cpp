@@ -0,0 +1,65 @@
+#include "Bench.h"
+
+#include <iostream>
+#include <string_view>
+
+namespace
+{
+    struct BenchEntry
+    {
+        std::string_view name;
+        int (*run)(int argc, char* argv[]);
+    };
+
+    constexpr BenchEntry g_benches[] = {
+        {"rules", SeaBattle::Bench::RunRulesBench},
+        {"snapshot", SeaBattle::Bench::RunSnapshotBench},
+        {"scaling", SeaBattle::Bench::RunScalingBench},
+        {"latency", SeaBattle::Bench::RunLatencyBench},
+        {"fleetpool", SeaBattle::Bench::RunFleetPoolBench},
+        {"placement", SeaBattle::Bench::RunPlacementBench},
+        {"replay", SeaBattle::Bench::RunReplayBench},
+        {"batch", SeaBattle::Bench::RunBatchBench},
+        {"endgame", SeaBattle::Bench::RunEndgameBench},
+        {"book", SeaBattle::Bench::RunOpeningBookBench},
+        {"bots", SeaBattle::Bench::RunBotBench},
+        {"analytics", SeaBattle::Bench::RunAnalyticsBench},
+        {"transport", SeaBattle::Bench::RunTransportBench},
+        {"mux", SeaBattle::Bench::RunMuxBench},
+        {"clocks", SeaBattle::Bench::RunClockBench},
+        {"rooms", SeaBattle::Bench::RunRoomsBench},
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    std::string_view requested = argc > 1 ? argv[1] : "all";
+
+    bool found = false;
+    for (const auto& bench : g_benches)
+    {
+        if (requested == "all" || requested == bench.name)
+        {
+            found = true;
+            std::cout << "[bench] === " << bench.name << " ===" << std::endl;
+            int rc = bench.run(argc > 1 ? argc - 2 : 0, argc > 1 ? argv + 2 : argv + 1);
+            if (rc != 0)
+            {
+                return rc;
+            }
+        }
+    }
+
+    if (!found)
+    {
+        std::cerr << "[bench] unknown benchmark '" << requested << "', available:";
+        for (const auto& bench : g_benches)
+        {
+            std::cerr << " " << bench.name;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,65 +1,697 @@
+#include "Analytics.h"
+#include "BotExecutor.h"
+#include "FleetPool.h"
+#include "FreeList.h"
 #include "GameModel.h"
+#include "OpeningBook.h"
+#include "Replay.h"
+#include "RoomArchive.h"
+#include "RoomDirectory.h"
+#include "ServerConfig.h"
+#include "TimingWheel.h"
+#include "Trace.h"
 #include <boost/asio/as_tuple.hpp>
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/asio/thread_pool.hpp>
 #include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
 #include <boost/beast/websocket.hpp>
 
 #include <nlohmann/json.hpp>
 
 #include <iostream>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <variant>
 #include <array>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <limits>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <tuple>
+#include <unordered_map>
 
 namespace
 {
-    using WebSocketStream = boost::beast::websocket::stream<boost::beast::tcp_stream>;
+    // Сокет без привязки к протоколу: одни и те же сессии обслуживают TCP и unix-сокет
+    using SessionSocket = boost::asio::generic::stream_protocol::socket;
+    using WebSocketStream = boost::beast::websocket::stream<boost::beast::basic_stream<boost::asio::generic::stream_protocol>>;
 
-    struct GameServerState
+    struct MuxConnection;
+
+    // Куда идут сообщения игрока: своё WebSocket-соединение или канал общего соединения (/mux)
+    struct PlayerLink
+    {
+        WebSocketStream* ws = nullptr;
+        std::shared_ptr<MuxConnection> mux;
+        std::uint32_t channel = 0;
+
+        explicit operator bool() const { return ws || mux; }
+    };
+
+    // Одна партия двух игроков.
+    // Места (seatTaken, seatsFilled) защищены GameServerState::mutex, всё остальное
+    // трогают только корутины игроков, которые выполняются на strand комнаты.
+    struct Room : std::enable_shared_from_this<Room>
     {
-        SeaBattle::GameModel model;
-        int connectedPlayers = 0;
+        std::uint64_t id = 0;
+        SeaBattle::GameMode mode = SeaBattle::GameMode::Classic;
+        SeaBattle::AnyGameModel model;
+        boost::asio::strand<boost::asio::any_io_executor> strand;
+        std::array<bool, 2> seatTaken = {false, false};
+        bool seatsFilled = false;
         bool gameStarted = false;
+
+        explicit Room(boost::asio::any_io_executor executor)
+            : strand(boost::asio::make_strand(std::move(executor)))
+        {
+        }
         
-        // Хранение указателей на WebSocket-соединения игроков
-        std::array<WebSocketStream*, 2> playerSockets = {nullptr, nullptr};
+        // Соединения игроков
+        std::array<PlayerLink, 2> playerLinks;
         std::mutex socketsMutex;
 
+        // Исходящие сообщения игрока со своим соединением. На WebSocket не может идти две записи сразу,
+        // а игроку пишут и его корутина (ответы), и корутина соперника (уведомления); очередь живёт
+        // на strand комнаты. У канала /mux очередь своя, в MuxConnection
+        std::array<std::deque<std::string>, 2> outbox;
+        std::array<bool, 2> writing = {false, false};
+
         // Player names
         std::array<std::string, 2> playerNames = {"Игрок 1", "Игрок 2"};
+
+        // Место бота (-1 - в комнате два человека); ходы бота считает GameServerState::bots
+        int botSeat = -1;
+        std::uint64_t botMoves = 0;
+
+        // Принятых выстрелов в партии - номер следующего выстрела для аналитики
+        int shotsFired = 0;
+        // Принятые выстрелы по порядку - для архива; ёмкость на всю партию заказана при создании
+        std::vector<SeaBattle::ReplayShot> shots;
+
+        // Учёт памяти и вытеснение (защищены GameServerState::mutex): комната резидентна, пока её
+        // можно найти по id, и тогда её bytes входят в GameServerState::roomBytes. Простаивающая
+        // (finished или брошенная посреди партии) стоит в GameServerState::idleRooms
+        bool resident = true;
+        bool finished = false;
+        bool idle = false;
+        std::list<std::shared_ptr<Room>>::iterator idleEntry;
+        std::chrono::steady_clock::time_point idleSince;
+        std::size_t bytes = 0;
+        // Последний запрос игрока; пишется на strand, читается при вытеснении
+        std::atomic<std::chrono::steady_clock::rep> lastActivity{ 0 };
+
+        // Часы партии (ServerConfig::turnTimeout, gameTimeout): чьё время идёт (-1 - ничьё, в том
+        // числе во время хода бота), с какого момента, запас игроков на партию и таймер в колесе
+        // комнаты (clock_wheel). Трогаются только на strand комнаты
+        struct Clock
+        {
+            int player = -1;
+            std::chrono::steady_clock::time_point turnStart;
+            std::chrono::steady_clock::time_point deadline;
+            std::array<std::chrono::steady_clock::duration, 2> left{};
+            SeaBattle::TimingWheel::Handle timer = 0;
+        } clock;
+
+        int connectedPlayers() const { return static_cast<int>(seatTaken[0]) + static_cast<int>(seatTaken[1]); }
+    };
+
+    // Одно из колёс часов (GameServerState::clockWheels). Колёс столько же, сколько рабочих потоков,
+    // но к потокам они не привязаны: комната выбирает колесо по своему id, часы ставятся и снимаются
+    // со strand комнаты, колесо продвигает своя корутина TickClocks на любом потоке пула - между
+    // ними мьютекс этого колеса, g_state.mutex часы не берут
+    struct ClockWheel
+    {
+        std::mutex mutex;
+        SeaBattle::TimingWheel wheel;
+    };
+
+    // Сколько освобождённых блоков комнат ждёт новых комнат
+    constexpr std::size_t MaxFreeRooms = 4096;
+
+    struct GameServerState
+    {
+        SeaBattle::ServerConfig config;
+
+        // Блок комнаты вместе со счётчиком ссылок берётся из списка свободных блоков; объявлен
+        // раньше всего, где лежат комнаты, - уничтожаемые комнаты возвращают в него блоки
+        SeaBattle::FreeList roomBlocks{ MaxFreeRooms };
+
+        std::mutex mutex; // rooms, openRoom, места в комнатах и учёт памяти: сессии работают в нескольких потоках
+        std::unordered_map<std::uint64_t, std::shared_ptr<Room>> rooms;
+        std::shared_ptr<Room> openRoom; // комната, ожидающая второго игрока
+        bool openRoomShared = false;     // openRoom опубликована в каталоге как ожидающая для всех процессов
+
+        // Простаивающие комнаты в порядке, в котором стали простаивать (первая - самая давняя),
+        // байт на все резидентные комнаты и счётчики вытеснения
+        std::list<std::shared_ptr<Room>> idleRooms;
+        std::size_t roomBytes = 0;
+        std::uint64_t evictedRooms = 0;
+        std::uint64_t rejectedRooms = 0;
+
+        // Архив партий; пусто, если config.archiveFile не задан
+        std::unique_ptr<SeaBattle::RoomArchive> archive;
+
+        // Каталог комнат, общий для всех процессов на этом хосте (SO_REUSEPORT)
+        std::unique_ptr<SeaBattle::RoomDirectory> directory;
+        unsigned short privatePort = 0; // порт, по которому к комнатам этого процесса подключаются напрямую
+        bool unixSocketCreated = false; // файл unix-сокета создан этим процессом - он его и удаляет
+
+        // Готовые расстановки флота: начало партии не расставляет корабли в потоке обработки
+        std::unique_ptr<SeaBattle::FleetPool> fleetPool;
+
+        // Книга дебютов для ботов; пусто, если не задана в настройках
+        std::shared_ptr<const SeaBattle::OpeningBook> openingBook;
+
+        // Ходы ботов; пусто, если ботов нет (выключены или не classic)
+        std::unique_ptr<SeaBattle::BotExecutor> bots;
+
+        // Последний снимок аналитики для /admin/analytics; обновляется раз в config.analyticsInterval
+        std::atomic<std::shared_ptr<const SeaBattle::Analytics::Snapshot>> analytics;
+        // Размер поля режима config.mode для снимка аналитики; задаётся при старте
+        int boardRows = 0;
+        int boardCols = 0;
+
+        // Часы партий: по колесу на каждый рабочий поток пула (колёса не привязаны к потокам -
+        // это деление одного мьютекса на несколько), комната - в колесе по своему id; тик
+        // колеса отсчитывается от clockEpoch. Пусто, если часы выключены
+        std::vector<std::unique_ptr<ClockWheel>> clockWheels;
+        std::chrono::steady_clock::time_point clockEpoch;
     };
 
     GameServerState g_state;
 
+    // Мультиплексированное соединение (/mux): много независимых партий в одном WebSocket, у каждого
+    // сообщения в обе стороны поле "ch" - номер канала, выбранный клиентом. Исходящие сообщения
+    // ждут в очереди своего канала, запись берёт по одному сообщению из непустых очередей по кругу:
+    // канал, которому пишут много, задерживает остальные не больше чем на одно сообщение.
+    // Чтение, запись и очереди - на strand соединения.
+    struct MuxConnection : std::enable_shared_from_this<MuxConnection>
+    {
+        // Запросов одного канала, ещё не обработанных комнатой; сверх этого канал получает channel_busy
+        static constexpr int MaxPendingRequests = 8;
+
+        struct Channel
+        {
+            std::shared_ptr<Room> room;
+            int playerIndex = -1;
+            std::shared_ptr<std::atomic<int>> pending = std::make_shared<std::atomic<int>>(0);
+        };
+
+        WebSocketStream ws;
+        boost::asio::strand<boost::asio::any_io_executor> strand;
+
+        std::unordered_map<std::uint32_t, Channel> channels;
+        std::unordered_map<std::uint32_t, std::deque<std::string>> outbox;
+        std::deque<std::uint32_t> ready;    // каналы с непустой очередью в порядке обхода
+        bool writing = false;
+        bool closed = false;
+
+        MuxConnection(WebSocketStream stream, boost::asio::any_io_executor executor)
+            : ws(std::move(stream))
+            , strand(boost::asio::make_strand(std::move(executor)))
+        {
+        }
+
+        // Вызывается из любого потока; сообщение уходит после уже поставленных в этот канал
+        void Send(std::uint32_t channel, std::string payload);
+
+    private:
+        boost::asio::awaitable<void> writeLoop();
+    };
+
+    // Добавляет номер канала в сообщение: все сообщения протокола - JSON-объекты
+    std::string with_channel(std::uint32_t channel, std::string_view payload)
+    {
+        std::string framed = "{\"ch\":" + std::to_string(channel);
+        if (payload.size() > 2)
+        {
+            framed += ',';
+        }
+        framed.append(payload.substr(1));
+        return framed;
+    }
+
+    void MuxConnection::Send(std::uint32_t channel, std::string payload)
+    {
+        boost::asio::post(strand, [self = shared_from_this(), channel, payload = std::move(payload)]() mutable
+            {
+                if (self->closed)
+                {
+                    return;
+                }
+                auto& queue = self->outbox[channel];
+                if (queue.empty())
+                {
+                    self->ready.push_back(channel);
+                }
+                queue.push_back(with_channel(channel, payload));
+                if (!self->writing)
+                {
+                    self->writing = true;
+                    boost::asio::co_spawn(self->strand, self->writeLoop(), boost::asio::detached);
+                }
+            });
+    }
+
+    boost::asio::awaitable<void> MuxConnection::writeLoop()
+    {
+        auto self = shared_from_this();
+        while (!ready.empty())
+        {
+            const std::uint32_t channel = ready.front();
+            ready.pop_front();
+            auto& queue = outbox[channel];
+            std::string next = std::move(queue.front());
+            queue.pop_front();
+            if (queue.empty())
+            {
+                outbox.erase(channel);
+            }
+            else
+            {
+                ready.push_back(channel);
+            }
+
+            auto [ec, bytes] = co_await ws.async_write(boost::asio::buffer(next), boost::asio::as_tuple(boost::asio::use_awaitable));
+            if (ec)
+            {
+                closed = true;
+                outbox.clear();
+                ready.clear();
+            }
+        }
+        writing = false;
+    }
+
+    void touch(Room& room)
+    {
+        room.lastActivity.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // Байт, которые держит комната: её блок и то, что она держит в куче. Исходящие очереди
+    // не считаются - сообщение лежит в них, только пока пишется
+    std::size_t room_bytes(const Room& room)
+    {
+        std::size_t bytes = sizeof(Room) + room.shots.capacity() * sizeof(SeaBattle::ReplayShot);
+        for (const auto& name : room.playerNames)
+        {
+            bytes += name.capacity() > std::string().capacity() ? name.capacity() + 1 : 0;
+        }
+        return bytes;
+    }
+
+    bool game_over(const Room& room)
+    {
+        return std::visit([](const auto& model) { return model.GetGameState() == SeaBattle::GameState::GameOver; }, room.model);
+    }
+
+    // Вызывается под g_state.mutex
+    void mark_idle(Room& room)
+    {
+        if (!room.resident || room.idle)
+        {
+            return;
+        }
+        room.idle = true;
+        room.idleSince = std::chrono::steady_clock::now();
+        room.idleEntry = g_state.idleRooms.insert(g_state.idleRooms.end(), room.shared_from_this());
+    }
+
+    // Вызывается под g_state.mutex
+    void unmark_idle(Room& room)
+    {
+        if (room.idle)
+        {
+            room.idle = false;
+            g_state.idleRooms.erase(room.idleEntry);
+        }
+    }
+
+    // openRoom больше не ожидает соперника; вызывается под g_state.mutex
+    void close_open_room()
+    {
+        if (g_state.openRoomShared)
+        {
+            g_state.directory->ClaimOpenRoom(g_state.openRoom->id);
+            g_state.openRoomShared = false;
+        }
+        g_state.openRoom.reset();
+    }
+
+    // Комнату больше нельзя найти по id, её память списана; вызывается под g_state.mutex.
+    // false - уже списана
+    bool drop_room(Room& room)
+    {
+        if (!room.resident)
+        {
+            return false;
+        }
+        unmark_idle(room);
+        room.resident = false;
+        if (g_state.openRoom.get() == &room)
+        {
+            close_open_room();
+        }
+        g_state.rooms.erase(room.id);
+        g_state.directory->Unregister(room.id);
+        g_state.roomBytes -= room.bytes;
+        return true;
+    }
+
+    boost::asio::awaitable<void> EvictRoom(std::shared_ptr<Room> room);
+
+    // Вытесняет самую давнюю простаивающую комнату; вызывается под g_state.mutex. Архив и
+    // отключение игроков - на strand комнаты. false - вытеснять нечего
+    bool evict_oldest()
+    {
+        if (g_state.idleRooms.empty())
+        {
+            return false;
+        }
+        auto room = g_state.idleRooms.front();
+        drop_room(*room);
+        ++g_state.evictedRooms;
+        boost::asio::co_spawn(room->strand, EvictRoom(room), boost::asio::detached);
+        return true;
+    }
+
+    // Вызывается под g_state.mutex. Пусто, если новая комната не помещается в roomMemoryLimit
+    // даже после вытеснения всех простаивающих
+    std::shared_ptr<Room> create_room(const boost::asio::any_io_executor& executor)
+    {
+        auto room = std::allocate_shared<Room>(SeaBattle::FreeListAllocator<Room>(g_state.roomBlocks), executor);
+        room->mode = g_state.config.mode;
+        room->model = SeaBattle::MakeGameModel(room->mode);
+        std::visit([&room](const auto& model)
+            {
+                using Rules = typename std::decay_t<decltype(model)>::RulesType;
+                room->shots.reserve(2 * Rules::Rows * Rules::Cols);
+            },
+            room->model);
+        room->bytes = room_bytes(*room);
+        touch(*room);
+
+        const std::size_t limit = g_state.config.roomMemoryLimit;
+        while (limit > 0 && g_state.roomBytes + room->bytes > limit)
+        {
+            if (!evict_oldest())
+            {
+                ++g_state.rejectedRooms;
+                std::cerr << "[server] room memory limit reached: " << g_state.rooms.size() << " rooms, "
+                          << g_state.roomBytes << " bytes" << std::endl;
+                return nullptr;
+            }
+        }
+
+        room->id = g_state.directory->AllocateRoomId();
+        g_state.rooms.emplace(room->id, room);
+        g_state.roomBytes += room->bytes;
+        if (!g_state.directory->Register(room->id, { SeaBattle::RoomDirectory::CurrentProcessId(), g_state.privatePort }))
+        {
+            std::cerr << "[server] room directory is full, room " << room->id << " is local only" << std::endl;
+        }
+        std::cout << "[server] room " << room->id << " created, mode=" << SeaBattle::ToString(room->mode) << std::endl;
+        return room;
+    }
+
+    void archive_room(const Room& room);
+
+    // Игрок ушёл; вызывается на strand комнаты. Когда уходит последний, неначатая партия
+    // забывается, законченная и партия с ботом - архивируются и забываются, а брошенная
+    // посреди игры остаётся простаивать: к ней можно вернуться по /room/<id>, пока её не вытеснят
+    void release_seat(const std::shared_ptr<Room>& room, int playerIndex)
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_state.mutex);
+            room->seatTaken[playerIndex] = false;
+            if (room->botSeat >= 0)
+            {
+                // Бот уходит вместе с человеком
+                room->seatTaken[room->botSeat] = false;
+            }
+            if (room->connectedPlayers() > 0 || !room->resident)
+            {
+                return;
+            }
+            if (room->gameStarted && room->botSeat < 0 && !game_over(*room))
+            {
+                mark_idle(*room);
+                std::cout << "[server] room " << room->id << " abandoned" << std::endl;
+                return;
+            }
+
+            // В комнате никого не осталось - забываем её
+            drop_room(*room);
+            std::cout << "[server] room " << room->id << " closed" << std::endl;
+        }
+        if (room->gameStarted)
+        {
+            archive_room(*room);
+        }
+    }
+
+    // Вызывается под g_state.mutex
+    int take_free_seat(Room& room)
+    {
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            if (!room.seatTaken[seat])
+            {
+                room.seatTaken[seat] = true;
+                return seat;
+            }
+        }
+        return -1;
+    }
+
+    // Цель запроса на подключение: "/" - случайный соперник (место - только после set_name или
+    // join), "/room/new" - отдельная комната, к которой соперник подключается по её id,
+    // "/room/<id>" - подключение к конкретной комнате, "/bot" - партия с ботом сразу (если боты
+    // выключены - как "/")
+    constexpr std::string_view NewRoomTarget = "/room/new";
+    constexpr std::string_view BotTarget = "/bot";
+    // Мультиплексированное соединение: партии открываются каналами внутри него (MuxConnection)
+    constexpr std::string_view MuxTarget = "/mux";
+    // Админка - обычный HTTP GET только на адресе config.adminListen: снимок аналитики в JSON
+    constexpr std::string_view AnalyticsTarget = "/admin/analytics";
+    // То же для учёта памяти комнат: резидентные, простаивающие, байты и вытеснение
+    constexpr std::string_view RoomsTarget = "/admin/rooms";
+
+    std::optional<std::uint64_t> parse_room_target(std::string_view target)
+    {
+        constexpr std::string_view prefix = "/room/";
+        if (target.substr(0, prefix.size()) != prefix)
+        {
+            return std::nullopt;
+        }
+        target.remove_prefix(prefix.size());
+        std::uint64_t roomId = 0;
+        auto [ptr, ec] = std::from_chars(target.data(), target.data() + target.size(), roomId);
+        if (ec != std::errc{} || roomId == 0)
+        {
+            return std::nullopt;
+        }
+        return roomId;
+    }
+
+    // Расстановка из запроса place_fleet: [{"type", "row", "col", "isVertical"}, ...].
+    // false, если кораблей не столько, сколько требуют правила, или запись не объект.
+    bool parse_fleet(const nlohmann::json& ships, std::span<SeaBattle::ShipPlacement> placement)
+    {
+        if (!ships.is_array() || ships.size() != placement.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < placement.size(); ++i)
+        {
+            const auto& ship = ships[i];
+            if (!ship.is_object())
+            {
+                return false;
+            }
+            placement[i] = { ship.value("type", 0), ship.value("row", -1), ship.value("col", -1), ship.value("isVertical", false) };
+        }
+        return true;
+    }
+
+    // Клетки залпа: "mask" - массив 64-битных слов, бит row * cols + col (BasicShotMask::words).
+    // false, если слов не столько, сколько нужно полю
+    template <typename Mask>
+    bool parse_mask(const nlohmann::json& words, Mask& mask)
+    {
+        if (!words.is_array() || words.size() != mask.words.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < mask.words.size(); ++i)
+        {
+            if (!words[i].is_number_unsigned())
+            {
+                return false;
+            }
+            mask.words[i] = words[i].template get<std::uint64_t>();
+        }
+        return true;
+    }
+
+    // Хвост без нулей: партии и номера выстрелов ограничены сверху с запасом
+    template <std::size_t N>
+    nlohmann::json trimmed(const std::array<std::uint64_t, N>& values)
+    {
+        std::size_t size = N;
+        while (size > 0 && values[size - 1] == 0)
+        {
+            --size;
+        }
+        return std::vector<std::uint64_t>(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(size));
+    }
+
+    nlohmann::json analytics_json(const SeaBattle::Analytics::Snapshot& snapshot, int rows, int cols)
+    {
+        using SeaBattle::Analytics::MaxCols;
+        nlohmann::json shots = nlohmann::json::array();
+        nlohmann::json hits = nlohmann::json::array();
+        for (int row = 0; row < rows; ++row)
+        {
+            nlohmann::json shotRow = nlohmann::json::array();
+            nlohmann::json hitRow = nlohmann::json::array();
+            for (int col = 0; col < cols; ++col)
+            {
+                shotRow.push_back(snapshot.cellShots[static_cast<std::size_t>(row * MaxCols + col)]);
+                hitRow.push_back(snapshot.cellHits[static_cast<std::size_t>(row * MaxCols + col)]);
+            }
+            shots.push_back(std::move(shotRow));
+            hits.push_back(std::move(hitRow));
+        }
+        return {
+            {"shots", snapshot.shots},
+            {"hits", snapshot.hits},
+            {"games", snapshot.games},
+            {"threads", snapshot.threads},
+            {"heatmap", {{"shots", std::move(shots)}, {"hits", std::move(hits)}}},
+            {"turns", {{"shots", trimmed(snapshot.turnShots)}, {"hits", trimmed(snapshot.turnHits)}}},
+            {"gameLengths", trimmed(snapshot.gameLengths)},
+        };
+    }
+
+    nlohmann::json rooms_json()
+    {
+        const auto blocks = g_state.roomBlocks.Stats();
+        std::lock_guard<std::mutex> lock(g_state.mutex);
+        const std::size_t resident = g_state.rooms.size();
+        return {
+            {"resident", resident},
+            {"idle", g_state.idleRooms.size()},
+            {"bytes", g_state.roomBytes},
+            {"bytesPerRoom", resident > 0 ? g_state.roomBytes / resident : 0},
+            {"memoryLimit", g_state.config.roomMemoryLimit},
+            {"evicted", g_state.evictedRooms},
+            {"rejected", g_state.rejectedRooms},
+            {"archived", g_state.archive ? g_state.archive->Games() : 0},
+            {"freeList", {
+                {"blockSize", blocks.blockSize},
+                {"free", blocks.free},
+                {"allocated", blocks.allocated},
+                {"reused", blocks.reused},
+            }},
+        };
+    }
+
+    // Снимок аналитики по таймеру: складывание счётчиков потоков не попадает на путь выстрела
+    boost::asio::awaitable<void> PublishAnalytics(std::chrono::seconds interval)
+    {
+        boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+        for (;;)
+        {
+            g_state.analytics.store(std::make_shared<const SeaBattle::Analytics::Snapshot>(SeaBattle::Analytics::TakeSnapshot()));
+            timer.expires_after(interval);
+            co_await timer.async_wait(boost::asio::use_awaitable);
+        }
+    }
+
+    void log_bots()
+    {
+        auto stats = g_state.bots->Stats();
+        std::cout << "[server] bots: moves=" << stats.moves << " queued=" << stats.queued
+                  << " p50=" << static_cast<std::uint64_t>(stats.latencyP50) << "us"
+                  << " p99=" << static_cast<std::uint64_t>(stats.latencyP99) << "us"
+                  << " deadlineMisses=" << stats.deadlineMisses << " throttled=" << stats.throttled
+                  << " cpu=" << stats.cpuSeconds << "s";
+        for (std::size_t tier = 0; tier < stats.movesByTier.size(); ++tier)
+        {
+            std::cout << " " << SeaBattle::BotExecutor::TierNames()[tier] << "=" << stats.movesByTier[tier];
+        }
+        std::cout << std::endl;
+    }
+
+    void log_fleet_pool()
+    {
+        auto stats = g_state.fleetPool->Stats();
+        std::cout << "[server] fleet pool: depth=" << stats.depth << "/" << stats.capacity
+                  << " taken=" << stats.taken << " misses=" << stats.misses
+                  << " generated=" << stats.generated
+                  << " refill=" << static_cast<std::uint64_t>(stats.refillRate) << "/s" << std::endl;
+    }
+
     nlohmann::json make_error(const std::string& msg)
     {
         std::cerr << "[server] error: " << msg << std::endl;
         return { {"type", "error"}, {"message", msg} };
     }
 
-    nlohmann::json make_state(int playerIndex)
+    template <typename Model>
+    nlohmann::json make_state(const Room& room, const Model& model, int playerIndex)
     {
+        using Rules = typename Model::RulesType;
+
         std::cout << "[server] make_state for player " << playerIndex << ": gameState="
-                  << static_cast<int>(g_state.model.GetGameState())
-                  << " currentPlayer=" << g_state.model.GetCurrentPlayer()
-                  << " winner=" << g_state.model.GetWinner() << std::endl;
+                  << static_cast<int>(model.GetGameState())
+                  << " currentPlayer=" << model.GetCurrentPlayer()
+                  << " winner=" << model.GetWinner() << std::endl;
 
         nlohmann::json response = {
             {"type", "state"},
-            {"gameState", static_cast<int>(g_state.model.GetGameState())},
-            {"currentPlayer", g_state.model.GetCurrentPlayer()},
-            {"winner", g_state.model.GetWinner()},
-            {"playerNames", g_state.playerNames},
+            {"gameState", static_cast<int>(model.GetGameState())},
+            {"currentPlayer", model.GetCurrentPlayer()},
+            {"winner", model.GetWinner()},
+            {"playerNames", room.playerNames},
+            {"room", room.id},
+            {"mode", SeaBattle::ToString(room.mode)},
+            {"rows", Rules::Rows},
+            {"cols", Rules::Cols},
         };
+        if constexpr (Rules::Salvo)
+        {
+            // Размер залпа того, чей сейчас ход
+            response["salvo"] = model.SalvoSize(model.GetCurrentPlayer());
+        }
+        if (room.clock.player >= 0)
+        {
+            // Сколько осталось тому, чей сейчас ход, до поражения по времени
+            const auto left = room.clock.deadline - std::chrono::steady_clock::now();
+            response["timeLeftMs"] = std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(left).count());
+        }
 
         // Отправляем корабли игрока, если игра началась
-        if (g_state.gameStarted)
+        if (room.gameStarted)
         {
-            const auto& playerField = g_state.model.GetPlayerField(playerIndex);
+            const auto& playerField = model.GetPlayerField(playerIndex);
             nlohmann::json shipsJson = nlohmann::json::array();
             for (const auto& ship : playerField.getShips())
             {
@@ -70,223 +702,1346 @@ namespace
                 nlohmann::json positionsJson = nlohmann::json::array();
                 for (const auto& pos : ship.positions)
                 {
-                    positionsJson.push_back({{"row", pos.first}, {"col", pos.second}});
+                    positionsJson.push_back({{"row", pos.row}, {"col", pos.col}});
+                }
+                shipJson["positions"] = positionsJson;
+                shipsJson.push_back(shipJson);
+            }
+            response["ships"] = shipsJson;
+        }
+
+        return response;
+    }
+
+    // Отправка сообщения игроку; вызывается на strand комнаты. Если запись этому игроку уже идёт,
+    // сообщение встаёт в очередь и его отправит та запись - порядок сообщений сохраняется.
+    // У канала /mux очередь и запись свои - сообщение передаётся соединению.
+    boost::asio::awaitable<void> sendMessage(Room& room, int playerIndex, std::string payload)
+    {
+        PlayerLink link;
+        {
+            std::lock_guard<std::mutex> lock(room.socketsMutex);
+            link = room.playerLinks[playerIndex];
+        }
+        if (link.mux)
+        {
+            link.mux->Send(link.channel, std::move(payload));
+            co_return;
+        }
+
+        auto& outbox = room.outbox[playerIndex];
+        outbox.push_back(std::move(payload));
+        if (room.writing[playerIndex])
+        {
+            co_return;
+        }
+
+        WebSocketStream* ws = link.ws;
+        if (!ws)
+        {
+            outbox.clear();
+            co_return;
+        }
+
+        room.writing[playerIndex] = true;
+        try
+        {
+            while (!outbox.empty())
+            {
+                std::string next = std::move(outbox.front());
+                outbox.pop_front();
+                co_await ws->async_write(boost::asio::buffer(next), boost::asio::use_awaitable);
+            }
+        }
+        catch (...)
+        {
+            room.writing[playerIndex] = false;
+            outbox.clear();
+            throw;
+        }
+        room.writing[playerIndex] = false;
+    }
+
+    // Отправка уведомления другому игроку о событии
+    boost::asio::awaitable<void> notifyPlayer(Room& room, int playerIndex, const nlohmann::json& message)
+    {
+        bool connected = false;
+        {
+            std::lock_guard<std::mutex> lock(room.socketsMutex);
+            connected = static_cast<bool>(room.playerLinks[playerIndex]);
+        }
+        
+        if (connected)
+        {
+            SeaBattle::Trace::Span span("notifyPlayer", message.value("trace", std::uint64_t{ 0 }));
+            try
+            {
+                auto payload = message.dump();
+                std::cout << "[server] notify player " << playerIndex << ": " << payload << std::endl;
+                co_await sendMessage(room, playerIndex, std::move(payload));
+            }
+            catch (const std::exception& ex)
+            {
+                std::cerr << "[server] failed to notify player " << playerIndex << ": " << ex.what() << std::endl;
+            }
+        }
+    }
+
+    // Уведомление о выстреле соперника
+    template <typename Model>
+    nlohmann::json make_opponent_shot(const Model& model, int row, int col, bool hit)
+    {
+        nlohmann::json notification{
+            {"type", "opponent_shot"},
+            {"row", row},
+            {"col", col},
+            {"hit", hit},
+            {"currentPlayer", model.GetCurrentPlayer()},
+            {"gameState", static_cast<int>(model.GetGameState())},
+        };
+        if (model.GetGameState() == SeaBattle::GameState::GameOver)
+        {
+            notification["winner"] = model.GetWinner();
+        }
+        return notification;
+    }
+
+    // Партия окончена: в аналитику, а комната начинает простаивать - её вытеснят по TTL или
+    // при нехватке памяти; вызывается на strand комнаты
+    void finish_game(Room& room)
+    {
+        SeaBattle::Analytics::RecordGame(room.shotsFired);
+        std::lock_guard<std::mutex> lock(g_state.mutex);
+        room.finished = true;
+        mark_idle(room);
+    }
+
+    // Принятый выстрел в аналитику и в запись партии; вызывается на strand комнаты
+    template <typename Model>
+    void record_shot(Room& room, const Model& model, int playerIndex, int row, int col, bool hit)
+    {
+        SeaBattle::Analytics::RecordShot(row, col, room.shotsFired++, hit);
+        room.shots.push_back({ static_cast<std::int8_t>(playerIndex), static_cast<std::int8_t>(row), static_cast<std::int8_t>(col) });
+        if (model.GetGameState() == SeaBattle::GameState::GameOver)
+        {
+            finish_game(room);
+        }
+    }
+
+    // Принятый залп в аналитику и в запись партии: выстрелы по возрастанию клетки, как будто сделаны подряд
+    template <typename Model>
+    void record_salvo(Room& room, const Model& model, int playerIndex, const typename Model::ShotMask& shots,
+        const typename Model::ShotMask& hits)
+    {
+        using Rules = typename Model::RulesType;
+        shots.forEach([&](int cell)
+            {
+                const int row = cell / Rules::Cols;
+                const int col = cell % Rules::Cols;
+                SeaBattle::Analytics::RecordShot(row, col, room.shotsFired++, hits.test(cell));
+                room.shots.push_back({ static_cast<std::int8_t>(playerIndex), static_cast<std::int8_t>(row), static_cast<std::int8_t>(col) });
+            });
+        if (model.GetGameState() == SeaBattle::GameState::GameOver)
+        {
+            finish_game(room);
+        }
+    }
+
+    // Итог залпа для стрелявшего (salvo_result) и соперника (opponent_salvo) - одно сообщение
+    // на залп вместо сообщения на каждый выстрел
+    template <typename Model>
+    nlohmann::json make_salvo_result(std::string_view type, const Model& model, const typename Model::ShotMask& shots,
+        const typename Model::ShotMask& hits)
+    {
+        nlohmann::json result{
+            {"type", type},
+            {"mask", shots.words},
+            {"hits", hits.words},
+            {"currentPlayer", model.GetCurrentPlayer()},
+            {"gameState", static_cast<int>(model.GetGameState())},
+            {"salvo", model.SalvoSize(model.GetCurrentPlayer())},
+        };
+        if (model.GetGameState() == SeaBattle::GameState::GameOver)
+        {
+            result["winner"] = model.GetWinner();
+        }
+        return result;
+    }
+
+    // Тик колёс часов: точности до десятой доли секунды часам партии хватает
+    constexpr std::chrono::milliseconds ClockTick{ 100 };
+
+    ClockWheel& clock_wheel(const Room& room)
+    {
+        return *g_state.clockWheels[room.id % g_state.clockWheels.size()];
+    }
+
+    // Тик колеса, на котором наступает момент time (с округлением вверх)
+    std::uint64_t clock_tick(std::chrono::steady_clock::time_point time)
+    {
+        const auto sinceEpoch = std::max(time - g_state.clockEpoch, std::chrono::steady_clock::duration::zero());
+        return static_cast<std::uint64_t>((sinceEpoch + ClockTick - std::chrono::nanoseconds(1)) / ClockTick);
+    }
+
+    // Ход сделан (или партия началась, или кончилась): время походившего списывается с его запаса,
+    // часы переходят к тому, чей теперь ход. Вызывается на strand комнаты
+    template <typename Model>
+    void restart_clock(Room& room, const Model& model)
+    {
+        if (g_state.clockWheels.empty())
+        {
+            return;
+        }
+        const auto& config = g_state.config;
+        auto& clock = room.clock;
+        const auto now = std::chrono::steady_clock::now();
+        if (clock.player >= 0)
+        {
+            clock.left[clock.player] -= now - clock.turnStart;
+        }
+        clock.player = model.GetGameState() == SeaBattle::GameState::Playing && model.GetCurrentPlayer() != room.botSeat
+            ? model.GetCurrentPlayer()
+            : -1;
+        clock.turnStart = now;
+
+        auto& clocks = clock_wheel(room);
+        std::lock_guard<std::mutex> lock(clocks.mutex);
+        clocks.wheel.Cancel(clock.timer);
+        clock.timer = 0;
+        if (clock.player < 0)
+        {
+            return;
+        }
+        auto limit = config.turnTimeout.count() > 0
+            ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.turnTimeout)
+            : std::chrono::steady_clock::duration::max() / 2;
+        if (config.gameTimeout.count() > 0)
+        {
+            limit = std::min(limit, clock.left[clock.player]);
+        }
+        clock.deadline = now + limit;
+        const std::uint64_t tick = clock_tick(clock.deadline);
+        clock.timer = clocks.wheel.Arm(tick > clocks.wheel.Now() ? tick - clocks.wheel.Now() : 1, room.id);
+    }
+
+    boost::asio::awaitable<void> BotShot(std::shared_ptr<Room> room, SeaBattle::Position shot);
+
+    // Просит ход бота, если сейчас его очередь; вызывается на strand комнаты.
+    // Поле противника копируется: исполнитель не трогает модель, а готовый ход
+    // возвращается на strand комнаты
+    void schedule_bot_move(Room& room, const SeaBattle::GameModel& model)
+    {
+        if (room.botSeat < 0 || !g_state.bots || model.GetGameState() != SeaBattle::GameState::Playing
+            || model.GetCurrentPlayer() != room.botSeat)
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(room.socketsMutex);
+            if (!room.playerLinks[1 - room.botSeat])
+            {
+                return;
+            }
+        }
+        const auto board = SeaBattle::ShotBoard::FromEnemyField(model.GetPlayerField(1 - room.botSeat));
+        g_state.bots->Submit(board, room.id << 32 | room.botMoves++, [room = room.shared_from_this()](SeaBattle::Position shot)
+            {
+                boost::asio::co_spawn(room->strand, BotShot(room, shot), boost::asio::detached);
+            });
+    }
+
+    boost::asio::awaitable<void> BotShot(std::shared_ptr<Room> room, SeaBattle::Position shot)
+    {
+        auto* model = std::get_if<SeaBattle::GameModel>(&room->model);
+        const int bot = room->botSeat;
+        if (!model || !model->IsValidShot(bot, shot.row, shot.col))
+        {
+            co_return;
+        }
+        const bool hit = model->ProcessShot(bot, shot.row, shot.col);
+        record_shot(*room, *model, bot, shot.row, shot.col, hit);
+        restart_clock(*room, *model);
+        std::cout << "[server] bot shot in room " << room->id << " at (" << static_cast<int>(shot.row) << ","
+                  << static_cast<int>(shot.col) << ") hit=" << hit << std::endl;
+        co_await notifyPlayer(*room, 1 - bot, make_opponent_shot(*model, shot.row, shot.col, hit));
+        schedule_bot_move(*room, *model);
+    }
+
+    // Один запрос игрока; вызывается на strand комнаты. requestSpan - отрезок обработки запроса,
+    // id трассы становится известен здесь
+    template <typename Model>
+    boost::asio::awaitable<void> HandleRequest(
+        Room& room, Model& model, int playerIndex, const nlohmann::json& request, SeaBattle::Trace::Span& requestSpan)
+    {
+        const std::string type = request.value("type", "");
+        std::cout << "[server] request type='" << type << "' from player " << playerIndex << std::endl;
+        touch(room);
+
+        if (type == "shot")
+        {
+            int row = request.value("row", -1);
+            int col = request.value("col", -1);
+            const std::uint64_t traceId = request.value("trace", std::uint64_t{ 0 });
+            requestSpan.setTraceId(traceId);
+
+            // Клиент уже показал клетку как "ожидающую"; accepted=false велит откатить её
+            const bool accepted = model.IsValidShot(playerIndex, row, col);
+            bool hit = false;
+            if (accepted)
+            {
+                SeaBattle::Trace::Span span("ProcessShot", traceId);
+                hit = model.ProcessShot(playerIndex, row, col);
+                record_shot(room, model, playerIndex, row, col, hit);
+                restart_clock(room, model);
+            }
+
+            std::cout << "[server] shot from player " << playerIndex
+                      << " at (" << row << "," << col << ") accepted=" << accepted << " hit=" << hit
+                      << " gameState=" << static_cast<int>(model.GetGameState())
+                      << " currentPlayer=" << model.GetCurrentPlayer()
+                      << std::endl;
+
+            nlohmann::json resp{
+                {"type", "shot_result"},
+                {"accepted", accepted},
+                {"hit", hit},
+                {"row", row},
+                {"col", col},
+                {"currentPlayer", model.GetCurrentPlayer()},
+                {"gameState", static_cast<int>(model.GetGameState())},
+            };
+
+            if (model.GetGameState() == SeaBattle::GameState::GameOver)
+            {
+                resp["winner"] = model.GetWinner();
+                std::cout << "[server] game over, winner=" << model.GetWinner() << std::endl;
+            }
+
+            // Трассируемый выстрел: возвращаем id и метку клиента, добавляем свою
+            const std::uint64_t serverTs = traceId != 0 ? SeaBattle::Trace::NowNs() : 0;
+            if (traceId != 0)
+            {
+                resp["trace"] = traceId;
+                resp["ts"] = request.value("ts", std::uint64_t{ 0 });
+                resp["serverTs"] = serverTs;
+            }
+
+            {
+                SeaBattle::Trace::Span span("write shot_result", traceId);
+                auto payload = resp.dump();
+                co_await sendMessage(room, playerIndex, std::move(payload));
+            }
+            requestSpan.end();
+
+            if (!accepted)
+            {
+                co_return;
+            }
+
+            // Уведомляем другого игрока о выстреле
+            int otherPlayer = 1 - playerIndex;
+            nlohmann::json notification = make_opponent_shot(model, row, col, hit);
+            if (traceId != 0)
+            {
+                notification["trace"] = traceId;
+                notification["serverTs"] = serverTs;
+            }
+            co_await notifyPlayer(room, otherPlayer, notification);
+
+            if constexpr (std::is_same_v<Model, SeaBattle::GameModel>)
+            {
+                schedule_bot_move(room, model);
+            }
+        }
+        else if (type == "salvo")
+        {
+            // Залп целиком: все клетки одной маской, разбор за один проход, один ответ
+            typename Model::ShotMask shots;
+            const bool accepted = parse_mask(request.contains("mask") ? request["mask"] : nlohmann::json{}, shots)
+                && model.IsValidSalvo(playerIndex, shots);
+            typename Model::ShotMask hits;
+            if (accepted)
+            {
+                SeaBattle::Trace::Span span("ProcessSalvo");
+                hits = model.ProcessSalvo(playerIndex, shots);
+                record_salvo(room, model, playerIndex, shots, hits);
+                restart_clock(room, model);
+            }
+
+            std::cout << "[server] salvo from player " << playerIndex << " of " << shots.count()
+                      << " shots accepted=" << accepted << " hits=" << hits.count()
+                      << " gameState=" << static_cast<int>(model.GetGameState())
+                      << " currentPlayer=" << model.GetCurrentPlayer() << std::endl;
+
+            auto result = make_salvo_result("salvo_result", model, shots, hits);
+            result["accepted"] = accepted;
+            co_await sendMessage(room, playerIndex, result.dump());
+            requestSpan.end();
+
+            if (accepted)
+            {
+                co_await notifyPlayer(room, 1 - playerIndex, make_salvo_result("opponent_salvo", model, shots, hits));
+            }
+        }
+        else if (type == "state")
+        {
+            std::cout << "[server] state request from player " << playerIndex << std::endl;
+            auto payload = make_state(room, model, playerIndex).dump();
+            co_await sendMessage(room, playerIndex, std::move(payload));
+        }
+        else if (type == "place_fleet")
+        {
+            // Своя расстановка вместо случайной - пока по полю игрока не стреляли
+            std::array<SeaBattle::ShipPlacement, Model::RulesType::FleetSize> placement;
+            auto error = SeaBattle::FleetError::WrongFleet;
+            if (parse_fleet(request.contains("ships") ? request["ships"] : nlohmann::json{}, placement))
+            {
+                error = model.PlaceFleet(playerIndex, placement);
+            }
+            std::cout << "[server] place_fleet from player " << playerIndex
+                      << ": " << SeaBattle::ToString(error) << std::endl;
+
+            nlohmann::json resp{
+                {"type", "place_fleet_result"},
+                {"accepted", error == SeaBattle::FleetError::None},
+            };
+            if (error != SeaBattle::FleetError::None)
+            {
+                resp["error"] = SeaBattle::ToString(error);
+            }
+            auto payload = resp.dump();
+            co_await sendMessage(room, playerIndex, std::move(payload));
+        }
+        else if (type == "set_name")
+        {
+            std::string name = request.value("name", "");
+            if (!name.empty())
+            {
+                std::lock_guard<std::mutex> lock(g_state.mutex);
+                room.playerNames[playerIndex] = name;
+                if (room.resident)
+                {
+                    const std::size_t bytes = room_bytes(room);
+                    g_state.roomBytes += bytes - room.bytes;
+                    room.bytes = bytes;
+                }
+                std::cout << "[server] player " << playerIndex << " set name to '" << name << "'" << std::endl;
+            }
+        }
+        else if (type == "join")
+        {
+            // Место уже есть: join нужен только в очереди подбора
+        }
+        else
+        {
+            std::cerr << "[server] unknown request type='" << type << "' from player " << playerIndex << std::endl;
+            auto payload = make_error("unknown_type").dump();
+            co_await sendMessage(room, playerIndex, std::move(payload));
+        }
+    }
+
+    template <typename Model>
+    boost::asio::awaitable<void> ServePlayer(Room& room, Model& model, WebSocketStream& ws, int playerIndex)
+    {
+        if constexpr (std::is_same_v<Model, SeaBattle::GameModel>)
+        {
+            // Бот может ходить первым
+            schedule_bot_move(room, model);
+        }
+
+        for (;;)
+        {
+            boost::beast::flat_buffer buffer;
+            auto [ec, bytes] = co_await ws.async_read(
+                buffer,
+                boost::asio::as_tuple(boost::asio::use_awaitable));
+
+            if (ec == boost::beast::websocket::error::closed)
+            {
+                std::cout << "[server] player " << playerIndex << " disconnected" << std::endl;
+                co_return;
+            }
+            if (ec)
+            {
+                std::cerr << "[server] read error for player " << playerIndex
+                          << ": " << ec.message() << std::endl;
+                throw boost::system::system_error{ ec };
+            }
+
+            // Отрезок обработки запроса - от чтения до ответа отправителю; id трассы известен
+            // после разбора сообщения. По этим отрезкам tracemerge выравнивает часы процессов.
+            SeaBattle::Trace::Span requestSpan("ServePlayer.request", 0, SeaBattle::Trace::HandlerCategory);
+
+            std::string msg{ boost::beast::buffers_to_string(buffer.data()) };
+            std::cout << "[server] recv from player " << playerIndex
+                      << " (" << bytes << " bytes): " << msg << std::endl;
+
+            std::optional<nlohmann::json> o;
+            try
+            {
+                o = nlohmann::json::parse(msg);
+            }
+            catch (const std::exception& ex)
+            {
+                std::cerr << "[server] json parse error: " << ex.what() << std::endl;
+            }
+            if (!o)
+            {
+                auto payload = make_error("invalid_json").dump();
+                co_await sendMessage(room, playerIndex, std::move(payload));
+                continue;
+            }
+
+            co_await HandleRequest(room, model, playerIndex, *o, requestSpan);
+        }
+    }
+
+    // Место для подключения с целью target. room пуст, если комнаты в этом процессе нет
+    // (remoteOwner и remoteRoom - если она в другом, full - если новая не помещается в память),
+    // player < 0 - если в комнате нет свободных мест
+    struct SeatAssignment
+    {
+        std::shared_ptr<Room> room;
+        std::optional<SeaBattle::RoomOwner> remoteOwner;
+        std::uint64_t remoteRoom = 0;
+        int player = -1;
+        bool startGame = false;
+        bool full = false;
+    };
+
+    SeatAssignment assign_seat(std::string_view target, const boost::asio::any_io_executor& executor)
+    {
+        SeatAssignment seat;
+        std::lock_guard<std::mutex> lock(g_state.mutex);
+        if (target == NewRoomTarget)
+        {
+            seat.room = create_room(executor);
+            seat.full = !seat.room;
+        }
+        else if (target == BotTarget && g_state.bots)
+        {
+            // Второе место сразу занимает бот - партия начнётся с подключением человека
+            seat.room = create_room(executor);
+            seat.full = !seat.room;
+            if (seat.room)
+            {
+                seat.room->botSeat = 1;
+                seat.room->seatTaken[seat.room->botSeat] = true;
+                seat.room->playerNames[seat.room->botSeat] = "Бот";
+            }
+        }
+        else if (auto roomId = parse_room_target(target))
+        {
+            if (auto it = g_state.rooms.find(*roomId); it != g_state.rooms.end())
+            {
+                seat.room = it->second;
+            }
+            else
+            {
+                seat.remoteOwner = g_state.directory->Lookup(*roomId);
+                seat.remoteRoom = *roomId;
+            }
+        }
+        else
+        {
+            // Очередь подбора общая для процессов на этом порту: ожидающая комната опубликована
+            // в каталоге, и место в ней получает тот, кто первым снимет её оттуда
+            if (g_state.openRoom && g_state.openRoomShared)
+            {
+                g_state.openRoomShared = false;
+                if (!g_state.directory->ClaimOpenRoom(g_state.openRoom->id))
+                {
+                    // Её снял другой процесс: место ждёт перенаправленного им игрока
+                    g_state.openRoom.reset();
+                }
+            }
+            if (g_state.openRoom && g_state.openRoom->connectedPlayers() >= 2)
+            {
+                g_state.openRoom.reset();
+            }
+            if (!g_state.openRoom)
+            {
+                auto pending = g_state.directory->TakeOpenRoom();
+                auto local = pending ? g_state.rooms.find(pending->roomId) : g_state.rooms.end();
+                if (local != g_state.rooms.end())
+                {
+                    seat.room = local->second;
+                }
+                else if (pending)
+                {
+                    seat.remoteOwner = pending->owner;
+                    seat.remoteRoom = pending->roomId;
+                }
+                else
+                {
+                    g_state.openRoom = create_room(executor);
+                    seat.room = g_state.openRoom;
+                    seat.full = !seat.room;
+                }
+            }
+            else
+            {
+                seat.room = g_state.openRoom;
+            }
+        }
+
+        if (seat.room)
+        {
+            seat.player = take_free_seat(*seat.room);
+            if (seat.player >= 0 && !seat.room->finished)
+            {
+                // Вернулись в брошенную партию
+                unmark_idle(*seat.room);
+            }
+            if (seat.player >= 0 && !seat.room->seatsFilled && seat.room->connectedPlayers() == 2)
+            {
+                seat.room->seatsFilled = true;
+                seat.startGame = true;
+                if (g_state.openRoom == seat.room)
+                {
+                    close_open_room();
+                }
+            }
+            if (g_state.openRoom && g_state.openRoom == seat.room && !g_state.openRoomShared)
+            {
+                g_state.openRoomShared = g_state.directory->PublishOpenRoom(seat.room->id);
+            }
+        }
+        return seat;
+    }
+
+    // Второй игрок занял место - расставляем флоты из запаса; вызывается на strand комнаты
+    void start_game(Room& room)
+    {
+        room.clock.left.fill(g_state.config.gameTimeout);
+        std::visit([&room](auto& model)
+            {
+                using Rules = typename std::decay_t<decltype(model)>::RulesType;
+                auto& pool = *g_state.fleetPool;
+                model.StartGame(pool.Take<Rules>(), pool.Take<Rules>());
+                restart_clock(room, model);
+            },
+            room.model);
+        room.gameStarted = true;
+        auto pool = g_state.fleetPool->Stats();
+        std::cout << "[server] game started in room " << room.id
+                  << ", fleet pool depth=" << pool.depth << "/" << pool.capacity << std::endl;
+    }
+
+    void configure_stream(WebSocketStream& ws)
+    {
+        const auto& config = g_state.config;
+        boost::beast::websocket::stream_base::timeout timeouts{};
+        timeouts.handshake_timeout = config.handshakeTimeout;
+        timeouts.idle_timeout = config.idleTimeout;
+        timeouts.keep_alive_pings = true;
+        ws.set_option(timeouts);
+        ws.read_message_max(config.maxMessageSize);
+    }
+
+    // Регистрирует соединение игрока в комнате и отправляет hello; вызывается на strand комнаты.
+    // link - именованный объект вызывающего: временный PlayerLink в аргументе корутины GCC 12
+    // разрушает дважды, и MuxConnection освобождается при живом соединении
+    boost::asio::awaitable<void> join_room(Room& room, int playerIndex, const PlayerLink& link)
+    {
+        {
+            std::lock_guard<std::mutex> lock(room.socketsMutex);
+            room.playerLinks[playerIndex] = link;
+        }
+        touch(room);
+
+        nlohmann::json hello{
+            {"type", "hello"},
+            {"player", playerIndex},
+            {"room", room.id},
+            {"mode", SeaBattle::ToString(room.mode)},
+        };
+        auto payload = hello.dump();
+        co_await sendMessage(room, playerIndex, std::move(payload));
+        std::cout << "[server] player " << playerIndex << " connected to room " << room.id << std::endl;
+    }
+
+    void leave_room(Room& room, int playerIndex)
+    {
+        std::lock_guard<std::mutex> lock(room.socketsMutex);
+        room.playerLinks[playerIndex] = {};
+    }
+
+    boost::asio::awaitable<void> HandlePlayer(
+        std::shared_ptr<Room> room,
+        WebSocketStream ws,
+        boost::beast::http::request<boost::beast::http::string_body> request,
+        int playerIndex,
+        bool startGame,
+        nlohmann::json joinRequest = {})
+    {
+        // Место освобождается при любом выходе, в том числе если рукопожатие не удалось
+        struct SeatGuard {
+            std::shared_ptr<Room> room;
+            int idx;
+            ~SeatGuard() { release_seat(room, idx); }
+        } seatGuard{room, playerIndex};
+
+        if (startGame)
+        {
+            start_game(*room);
+        }
+
+        // Из очереди подбора (DoMatchSession) соединение приходит уже принятым
+        if (!ws.is_open())
+        {
+            configure_stream(ws);
+            co_await ws.async_accept(request, boost::asio::use_awaitable);
+        }
+
+        // Убираем регистрацию при выходе
+        struct ScopeGuard {
+            Room& room;
+            int idx;
+            ~ScopeGuard() { leave_room(room, idx); }
+        } guard{*room, playerIndex};
+
+        const PlayerLink link{ &ws, nullptr, 0 };
+        co_await join_room(*room, playerIndex, link);
+
+        // Имя, с которым игрок встал в очередь подбора
+        if (joinRequest.is_object() && joinRequest.value("type", "") == "set_name")
+        {
+            SeaBattle::Trace::Span requestSpan("ServePlayer.request", 0, SeaBattle::Trace::HandlerCategory);
+            co_await std::visit(
+                [&room, &joinRequest, &requestSpan, playerIndex](auto& model)
+                { return HandleRequest(*room, model, playerIndex, joinRequest, requestSpan); },
+                room->model);
+        }
+
+        // Вариант игры выбран при создании комнаты - дальше работаем с конкретным типом модели
+        co_await std::visit(
+            [&room, &ws, playerIndex](auto& model) { return ServePlayer(*room, model, ws, playerIndex); },
+            room->model);
+    }
+
+    // Адрес, на который пришло подключение. У unix-сокета его нет - тогда основной адрес из настроек:
+    // перенаправление к другому процессу всё равно идёт на его TCP-порт
+    std::string local_address(WebSocketStream& stream)
+    {
+        const auto local = stream.next_layer().socket().local_endpoint();
+        const int family = local.protocol().family();
+        if (family != AF_INET && family != AF_INET6)
+        {
+            return g_state.config.listen.front().address;
+        }
+        boost::asio::ip::tcp::endpoint endpoint;
+        std::memcpy(endpoint.data(), local.data(), local.size());
+        return endpoint.address().to_string();
+    }
+
+    // Ответ на подключение без перехода на WebSocket (перенаправление, ошибка или JSON админки)
+    boost::asio::awaitable<void> RespondHttp(
+        WebSocketStream& stream,
+        const boost::beast::http::request<boost::beast::http::string_body>& request,
+        boost::beast::http::status status,
+        std::string location,
+        std::string json = {})
+    {
+        boost::beast::http::response<boost::beast::http::string_body> response{ status, request.version() };
+        response.set(boost::beast::http::field::server, "SeaBattle");
+        if (!location.empty())
+        {
+            response.set(boost::beast::http::field::location, location);
+        }
+        if (!json.empty())
+        {
+            response.set(boost::beast::http::field::content_type, "application/json");
+            response.body() = std::move(json);
+        }
+        response.keep_alive(false);
+        response.prepare_payload();
+        co_await boost::beast::http::async_write(stream.next_layer(), response, boost::asio::use_awaitable);
+        stream.next_layer().socket().shutdown(boost::asio::socket_base::shutdown_send);
+    }
+
+    // Канал /mux получил место в комнате: начало партии и hello, как у отдельного соединения;
+    // выполняется на strand комнаты
+    boost::asio::awaitable<void> JoinChannel(
+        std::shared_ptr<Room> room, std::shared_ptr<MuxConnection> connection, std::uint32_t channel, int playerIndex, bool startGame)
+    {
+        if (startGame)
+        {
+            start_game(*room);
+        }
+        const PlayerLink link{ nullptr, std::move(connection), channel };
+        co_await join_room(*room, playerIndex, link);
+        if (auto* model = std::get_if<SeaBattle::GameModel>(&room->model))
+        {
+            // Бот может ходить первым
+            schedule_bot_move(*room, *model);
+        }
+    }
+
+    // Запрос канала /mux; выполняется на strand комнаты, pending уменьшается по завершении
+    boost::asio::awaitable<void> ChannelRequest(
+        std::shared_ptr<Room> room, int playerIndex, nlohmann::json request, std::shared_ptr<std::atomic<int>> pending)
+    {
+        struct PendingGuard {
+            std::atomic<int>& pending;
+            ~PendingGuard() { pending.fetch_sub(1, std::memory_order_relaxed); }
+        } guard{ *pending };
+
+        SeaBattle::Trace::Span requestSpan("ServePlayer.request", 0, SeaBattle::Trace::HandlerCategory);
+        co_await std::visit(
+            [&room, &request, &requestSpan, playerIndex](auto& model) { return HandleRequest(*room, model, playerIndex, request, requestSpan); },
+            room->model);
+    }
+
+    // {"ch": N, "type": "open", "target": ...}: место в комнате по той же цели, что у отдельного
+    // соединения. Отказ - error в этом канале, канал остаётся свободным; false - отказ
+    bool open_channel(MuxConnection& connection, std::uint32_t channel, std::string_view target)
+    {
+        if (connection.channels.contains(channel))
+        {
+            connection.Send(channel, make_error("channel_in_use").dump());
+            return false;
+        }
+
+        auto seat = assign_seat(target, connection.strand.get_inner_executor());
+        if (seat.full)
+        {
+            connection.Send(channel, make_error("server_full").dump());
+            return false;
+        }
+        if (!seat.room)
+        {
+            auto error = make_error(seat.remoteOwner ? "room_elsewhere" : "room_not_found");
+            if (seat.remoteOwner)
+            {
+                // Комната в другом процессе - канал открывается в соединении с ним
+                error["location"] = "ws://" + local_address(connection.ws) + ":" + std::to_string(seat.remoteOwner->port)
+                    + "/room/" + std::to_string(seat.remoteRoom);
+            }
+            connection.Send(channel, error.dump());
+            return false;
+        }
+        if (seat.player < 0)
+        {
+            connection.Send(channel, make_error("room_full").dump());
+            return false;
+        }
+
+        connection.channels[channel] = { seat.room, seat.player };
+        boost::asio::co_spawn(
+            seat.room->strand,
+            JoinChannel(seat.room, connection.shared_from_this(), channel, seat.player, seat.startGame),
+            boost::asio::detached);
+        return true;
+    }
+
+    // Канал закрыт клиентом или вместе с соединением: игрок уходит из комнаты. Запросы канала,
+    // уже отправленные в комнату, выполнятся раньше - strand сохраняет порядок
+    void close_channel(MuxConnection& connection, std::uint32_t channel)
+    {
+        auto it = connection.channels.find(channel);
+        if (it == connection.channels.end())
+        {
+            return;
+        }
+        auto room = std::move(it->second.room);
+        const int playerIndex = it->second.playerIndex;
+        connection.channels.erase(it);
+        boost::asio::post(room->strand, [room, playerIndex]()
+            {
+                leave_room(*room, playerIndex);
+                release_seat(room, playerIndex);
+            });
+    }
+
+    // Сервер снимает игрока с партии: своё соединение закрывается, канал /mux закрывается в своём
+    // соединении (если к этому времени он не переоткрыт в другую комнату). Вызывается на strand комнаты
+    boost::asio::awaitable<void> disconnect_player(Room& room, int playerIndex)
+    {
+        PlayerLink link;
+        {
+            std::lock_guard<std::mutex> lock(room.socketsMutex);
+            link = room.playerLinks[playerIndex];
+        }
+        if (link.mux)
+        {
+            boost::asio::post(link.mux->strand, [connection = link.mux, channel = link.channel, room = room.shared_from_this()]()
+                {
+                    auto it = connection->channels.find(channel);
+                    if (it != connection->channels.end() && it->second.room == room)
+                    {
+                        close_channel(*connection, channel);
+                        connection->Send(channel, R"({"type":"closed"})");
+                    }
+                });
+        }
+        else if (link.ws)
+        {
+            // Ожидающее чтение ServePlayer прервётся, и сессия освободит место
+            co_await link.ws->async_close(boost::beast::websocket::close_code::going_away,
+                boost::asio::as_tuple(boost::asio::use_awaitable));
+        }
+    }
+
+    // Сработали часы комнаты; выполняется на strand комнаты. Ход мог случиться после срабатывания
+    // колеса, но до этой корутины - тогда часы уже перезапущены и срок ещё не наступил
+    boost::asio::awaitable<void> ClockExpired(std::shared_ptr<Room> room)
+    {
+        auto& clock = room->clock;
+        if (clock.player < 0 || std::chrono::steady_clock::now() < clock.deadline)
+        {
+            co_return;
+        }
+        const int loser = clock.player;
+        clock.player = -1;
+        clock.timer = 0;
+
+        nlohmann::json message;
+        const bool forfeited = std::visit([loser, &message](auto& model)
+            {
+                if (!model.Forfeit(loser))
+                {
+                    return false;
+                }
+                message = {
+                    {"type", "timeout"},
+                    {"player", loser},
+                    {"currentPlayer", model.GetCurrentPlayer()},
+                    {"gameState", static_cast<int>(model.GetGameState())},
+                    {"winner", model.GetWinner()},
+                };
+                return true;
+            },
+            room->model);
+        if (!forfeited)
+        {
+            co_return;
+        }
+        finish_game(*room);
+        std::cout << "[server] player " << loser << " in room " << room->id << " ran out of time" << std::endl;
+
+        co_await notifyPlayer(*room, loser, message);
+        co_await notifyPlayer(*room, 1 - loser, message);
+        co_await disconnect_player(*room, loser);
+    }
+
+    // Тик одного колеса часов: истёкшие часы уходят на strand своих комнат. Таймер закрытой
+    // комнаты не снимается - он сработает впустую, комнаты уже нет в g_state.rooms
+    boost::asio::awaitable<void> TickClocks(ClockWheel& clocks)
+    {
+        boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+        std::vector<std::uint64_t> expired;
+        auto next = std::chrono::steady_clock::now();
+        for (;;)
+        {
+            next += ClockTick;
+            timer.expires_at(next);
+            co_await timer.async_wait(boost::asio::use_awaitable);
+
+            // Тик, уже наступивший целиком: срок таймера на нём не позже текущего момента
+            const auto elapsed = std::chrono::steady_clock::now() - g_state.clockEpoch;
+            {
+                std::lock_guard<std::mutex> lock(clocks.mutex);
+                clocks.wheel.Advance(static_cast<std::uint64_t>(elapsed / ClockTick),
+                    [&expired](std::uint64_t roomId) { expired.push_back(roomId); });
+            }
+            for (const std::uint64_t roomId : expired)
+            {
+                std::shared_ptr<Room> room;
+                {
+                    std::lock_guard<std::mutex> lock(g_state.mutex);
+                    if (auto it = g_state.rooms.find(roomId); it != g_state.rooms.end())
+                    {
+                        room = it->second;
+                    }
+                }
+                if (room)
+                {
+                    boost::asio::co_spawn(room->strand, ClockExpired(room), boost::asio::detached);
+                }
+            }
+            expired.clear();
+        }
+    }
+
+    // Партия строкой JSON в архив: флоты (тип, нос, ориентация) и выстрелы по порядку - из них
+    // BasicReplay восстановит любую позицию. Вызывается на strand комнаты
+    void archive_room(const Room& room)
+    {
+        if (!g_state.archive)
+        {
+            return;
+        }
+        nlohmann::json record{
+            {"room", room.id},
+            {"mode", SeaBattle::ToString(room.mode)},
+            {"players", room.playerNames},
+        };
+        std::visit([&record](const auto& model)
+            {
+                record["gameState"] = static_cast<int>(model.GetGameState());
+                if (model.GetGameState() == SeaBattle::GameState::GameOver)
+                {
+                    record["winner"] = model.GetWinner();
                 }
-                shipJson["positions"] = positionsJson;
-                shipsJson.push_back(shipJson);
-            }
-            response["ships"] = shipsJson;
+                auto& fleets = record["fleets"];
+                for (int player = 0; player < 2; ++player)
+                {
+                    auto fleet = nlohmann::json::array();
+                    for (const auto& ship : model.GetPlayerField(player).getShips())
+                    {
+                        fleet.push_back({ static_cast<int>(ship.type), ship.positions[0].row, ship.positions[0].col, ship.isVertical });
+                    }
+                    fleets.push_back(std::move(fleet));
+                }
+            },
+            room.model);
+        auto& shots = record["shots"] = nlohmann::json::array();
+        for (const auto& shot : room.shots)
+        {
+            shots.push_back({ shot.player, shot.row, shot.col });
         }
-
-        return response;
+        g_state.archive->Write(record.dump());
     }
 
-    // Отправка уведомления другому игроку о событии
-    boost::asio::awaitable<void> notifyPlayer(int playerIndex, const nlohmann::json& message)
+    // Комната вытеснена (evict_oldest) - её уже не найти по id; выполняется на strand комнаты.
+    // Партия уходит в архив, оставшиеся игроки получают evicted и отключаются
+    boost::asio::awaitable<void> EvictRoom(std::shared_ptr<Room> room)
     {
-        WebSocketStream* ws = nullptr;
+        if (!g_state.clockWheels.empty())
         {
-            std::lock_guard<std::mutex> lock(g_state.socketsMutex);
-            ws = g_state.playerSockets[playerIndex];
+            auto& clocks = clock_wheel(*room);
+            std::lock_guard<std::mutex> lock(clocks.mutex);
+            clocks.wheel.Cancel(room->clock.timer);
+            room->clock.timer = 0;
+            room->clock.player = -1;
         }
-        
-        if (ws)
+        if (room->gameStarted)
         {
-            try
-            {
-                auto payload = message.dump();
-                co_await ws->async_write(boost::asio::buffer(payload), boost::asio::use_awaitable);
-                std::cout << "[server] notified player " << playerIndex << ": " << payload << std::endl;
-            }
-            catch (const std::exception& ex)
+            archive_room(*room);
+        }
+        std::cout << "[server] room " << room->id << " evicted" << std::endl;
+
+        const nlohmann::json message{ {"type", "evicted"}, {"room", room->id} };
+        for (int player = 0; player < 2; ++player)
+        {
+            if (player != room->botSeat)
             {
-                std::cerr << "[server] failed to notify player " << playerIndex << ": " << ex.what() << std::endl;
+                co_await notifyPlayer(*room, player, message);
+                co_await disconnect_player(*room, player);
             }
         }
     }
 
-    boost::asio::awaitable<void> HandlePlayer(WebSocketStream ws, int playerIndex)
+    // Раз в секунду вытесняет комнаты, простаивающие дольше ttl. Если в комнате за это время
+    // был запрос (к законченной партии можно ещё запросить состояние), она встаёт в конец очереди
+    boost::asio::awaitable<void> EvictIdleRooms(std::chrono::seconds ttl)
     {
-        ws.set_option(boost::beast::websocket::stream_base::timeout::suggested(
-            boost::beast::role_type::server));
-        co_await ws.async_accept();
-
-        // Регистрируем соединение игрока
+        boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+        for (;;)
         {
-            std::lock_guard<std::mutex> lock(g_state.socketsMutex);
-            g_state.playerSockets[playerIndex] = &ws;
-        }
+            timer.expires_after(std::chrono::seconds(1));
+            co_await timer.async_wait(boost::asio::use_awaitable);
 
-        // Убираем регистрацию при выходе
-        struct ScopeGuard {
-            int idx;
-            ~ScopeGuard() {
-                std::lock_guard<std::mutex> lock(g_state.socketsMutex);
-                g_state.playerSockets[idx] = nullptr;
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(g_state.mutex);
+            while (!g_state.idleRooms.empty() && now - g_state.idleRooms.front()->idleSince >= ttl)
+            {
+                auto& room = *g_state.idleRooms.front();
+                const std::chrono::steady_clock::time_point lastActivity{
+                    std::chrono::steady_clock::duration(room.lastActivity.load(std::memory_order_relaxed)) };
+                if (now - lastActivity < ttl)
+                {
+                    room.idleSince = now;
+                    g_state.idleRooms.splice(g_state.idleRooms.end(), g_state.idleRooms, room.idleEntry);
+                    continue;
+                }
+                evict_oldest();
             }
-        } guard{playerIndex};
-
-        {
-            nlohmann::json hello{
-                {"type", "hello"},
-                {"player", playerIndex},
-            };
-            auto payload = hello.dump();
-            co_await ws.async_write(boost::asio::buffer(payload), boost::asio::use_awaitable);
-            std::cout << "[server] player " << playerIndex << " connected" << std::endl;
         }
+    }
 
-        for (;;)
-        {
-            boost::beast::flat_buffer buffer;
-            auto [ec, bytes] = co_await ws.async_read(
-                buffer,
-                boost::asio::as_tuple(boost::asio::use_awaitable));
+    // Соединение /mux; выполняется на strand соединения. Канал 0 - ошибки самого соединения
+    boost::asio::awaitable<void> ServeMux(
+        std::shared_ptr<MuxConnection> connection,
+        boost::beast::http::request<boost::beast::http::string_body> request)
+    {
+        auto& ws = connection->ws;
+        configure_stream(ws);
+        co_await ws.async_accept(request, boost::asio::use_awaitable);
 
-            if (ec == boost::beast::websocket::error::closed)
+        // Каналы закрываются при любом выходе
+        struct ChannelsGuard {
+            MuxConnection& connection;
+            ~ChannelsGuard()
             {
-                std::cout << "[server] player " << playerIndex << " disconnected" << std::endl;
-                co_return;
+                while (!connection.channels.empty())
+                {
+                    close_channel(connection, connection.channels.begin()->first);
+                }
             }
+        } guard{ *connection };
+
+        std::uint64_t opened = 0;
+        std::cout << "[server] mux connection opened" << std::endl;
+        for (;;)
+        {
+            boost::beast::flat_buffer buffer;
+            auto [ec, bytes] = co_await ws.async_read(buffer, boost::asio::as_tuple(boost::asio::use_awaitable));
             if (ec)
             {
-                std::cerr << "[server] read error for player " << playerIndex
-                          << ": " << ec.message() << std::endl;
-                throw boost::system::system_error{ ec };
+                if (ec != boost::beast::websocket::error::closed)
+                {
+                    std::cerr << "[server] mux read error: " << ec.message() << std::endl;
+                }
+                break;
             }
 
-            std::string msg{ boost::beast::buffers_to_string(buffer.data()) };
-            std::cout << "[server] recv from player " << playerIndex
-                      << " (" << bytes << " bytes): " << msg << std::endl;
+            auto message = nlohmann::json::parse(boost::beast::buffers_to_string(buffer.data()), nullptr, false);
+            // Номер канала читается целиком: get<uint32_t> обрезал бы 2^32 + 1 до канала 1
+            if (!message.is_object() || !message.contains("ch") || !message["ch"].is_number_unsigned()
+                || message["ch"].get<std::uint64_t>() == 0
+                || message["ch"].get<std::uint64_t>() > std::numeric_limits<std::uint32_t>::max())
+            {
+                connection->Send(0, make_error("invalid_channel").dump());
+                continue;
+            }
+            const auto channel = static_cast<std::uint32_t>(message["ch"].get<std::uint64_t>());
+            message.erase("ch");
+            const std::string type = message.value("type", "");
 
-            std::optional<nlohmann::json> o;
-            try
+            if (type == "open")
             {
-                o = nlohmann::json::parse(msg);
+                opened += open_channel(*connection, channel, message.value("target", "/")) ? 1 : 0;
             }
-            catch (const std::exception& ex)
+            else if (type == "close")
             {
-                std::cerr << "[server] json parse error: " << ex.what() << std::endl;
+                close_channel(*connection, channel);
+                connection->Send(channel, R"({"type":"closed"})");
             }
-            if (!o)
+            else if (auto it = connection->channels.find(channel); it == connection->channels.end())
             {
-                auto payload = make_error("invalid_json").dump();
-                co_await ws.async_write(boost::asio::buffer(payload), boost::asio::use_awaitable);
-                continue;
+                connection->Send(channel, make_error("unknown_channel").dump());
             }
-            nlohmann::json request = *o;
-
-            const std::string type = request.value("type", "");
-            std::cout << "[server] request type='" << type << "' from player " << playerIndex << std::endl;
-
-            if (type == "shot")
+            else if (it->second.pending->load(std::memory_order_relaxed) >= MuxConnection::MaxPendingRequests)
             {
-                int row = request.value("row", -1);
-                int col = request.value("col", -1);
-
-                int previousPlayer = g_state.model.GetCurrentPlayer();
-                bool hit = g_state.model.ProcessShot(playerIndex, row, col);
-                int newPlayer = g_state.model.GetCurrentPlayer();
-
-                std::cout << "[server] shot from player " << playerIndex
-                          << " at (" << row << "," << col << ") hit=" << hit
-                          << " gameState=" << static_cast<int>(g_state.model.GetGameState())
-                          << " currentPlayer=" << g_state.model.GetCurrentPlayer()
-                          << std::endl;
+                // Канал шлёт запросы быстрее, чем комната их обрабатывает - не даём ему занять её strand
+                connection->Send(channel, make_error("channel_busy").dump());
+            }
+            else
+            {
+                auto& state = it->second;
+                state.pending->fetch_add(1, std::memory_order_relaxed);
+                boost::asio::co_spawn(
+                    state.room->strand,
+                    ChannelRequest(state.room, state.playerIndex, std::move(message), state.pending),
+                    boost::asio::detached);
+            }
+        }
+        std::cout << "[server] mux connection closed, channels opened=" << opened
+                  << " open=" << connection->channels.size() << std::endl;
+    }
 
-                nlohmann::json resp{
-                    {"type", "shot_result"},
-                    {"hit", hit},
-                    {"row", row},
-                    {"col", col},
-                    {"currentPlayer", g_state.model.GetCurrentPlayer()},
-                    {"gameState", static_cast<int>(g_state.model.GetGameState())},
-                };
+    // Цель ведёт в очередь подбора соперника (в assign_seat - ветка без комнаты по id)
+    bool is_match_target(std::string_view target)
+    {
+        return target != NewRoomTarget && target != MuxTarget && !(target == BotTarget && g_state.bots)
+            && !parse_room_target(target);
+    }
 
-                if (g_state.model.GetGameState() == SeaBattle::GameState::GameOver)
-                {
-                    resp["winner"] = g_state.model.GetWinner();
-                    std::cout << "[server] game over, winner=" << g_state.model.GetWinner() << std::endl;
-                }
+    // Очередь подбора: соединение принимается сразу, а место в комнате даётся, только когда игрок
+    // подтвердил игру - прислал set_name или join. Клиент открывает соединение заранее, пока
+    // игрок вводит имя, и передумавший игрок не должен занять место, которое ждёт соперник
+    boost::asio::awaitable<void> DoMatchSession(
+        WebSocketStream stream, boost::beast::http::request<boost::beast::http::string_body> request)
+    {
+        const std::string target{ request.target() };
+        configure_stream(stream);
+        co_await stream.async_accept(request, boost::asio::use_awaitable);
 
-                auto payload = resp.dump();
-                co_await ws.async_write(boost::asio::buffer(payload), boost::asio::use_awaitable);
-
-                // Уведомляем другого игрока о выстреле
-                int otherPlayer = 1 - playerIndex;
-                nlohmann::json notification{
-                    {"type", "opponent_shot"},
-                    {"row", row},
-                    {"col", col},
-                    {"hit", hit},
-                    {"currentPlayer", newPlayer},
-                    {"gameState", static_cast<int>(g_state.model.GetGameState())},
-                };
-                if (g_state.model.GetGameState() == SeaBattle::GameState::GameOver)
-                {
-                    notification["winner"] = g_state.model.GetWinner();
-                }
-                co_await notifyPlayer(otherPlayer, notification);
-            }
-            else if (type == "state")
+        nlohmann::json joinRequest;
+        for (;;)
+        {
+            boost::beast::flat_buffer buffer;
+            auto [ec, bytes] = co_await stream.async_read(buffer, boost::asio::as_tuple(boost::asio::use_awaitable));
+            if (ec)
             {
-                std::cout << "[server] state request from player " << playerIndex << std::endl;
-                auto payload = make_state(playerIndex).dump();
-                co_await ws.async_write(boost::asio::buffer(payload), boost::asio::use_awaitable);
+                // Ушёл, не начав игру
+                co_return;
             }
-            else if (type == "set_name")
+            joinRequest = nlohmann::json::parse(boost::beast::buffers_to_string(buffer.data()), nullptr, false);
+            const std::string type = joinRequest.is_object() ? joinRequest.value("type", "") : "";
+            if (type == "set_name" || type == "join")
             {
-                std::string name = request.value("name", "");
-                if (!name.empty())
-                {
-                    g_state.playerNames[playerIndex] = name;
-                    std::cout << "[server] player " << playerIndex << " set name to '" << name << "'" << std::endl;
-                }
+                break;
             }
-            else
+            co_await stream.async_write(boost::asio::buffer(make_error("not_joined").dump()), boost::asio::use_awaitable);
+        }
+
+        auto executor = co_await boost::asio::this_coro::executor;
+        auto seat = assign_seat(target, executor);
+        std::optional<nlohmann::json> refusal;
+        if (seat.full)
+        {
+            refusal = make_error("server_full");
+        }
+        else if (!seat.room)
+        {
+            // Соперник ждёт в комнате другого процесса: клиент подключается к ней по её id
+            refusal = make_error(seat.remoteOwner ? "room_elsewhere" : "room_not_found");
+            if (seat.remoteOwner)
             {
-                std::cerr << "[server] unknown request type='" << type << "' from player " << playerIndex << std::endl;
-                auto payload = make_error("unknown_type").dump();
-                co_await ws.async_write(boost::asio::buffer(payload), boost::asio::use_awaitable);
+                (*refusal)["location"] = "ws://" + local_address(stream) + ":" + std::to_string(seat.remoteOwner->port)
+                    + "/room/" + std::to_string(seat.remoteRoom);
+                std::cout << "[server] match in room " << seat.remoteRoom << " owned by pid " << seat.remoteOwner->pid << std::endl;
             }
         }
+        else if (seat.player < 0)
+        {
+            refusal = make_error("room_full");
+        }
+        if (refusal)
+        {
+            co_await stream.async_write(boost::asio::buffer(refusal->dump()), boost::asio::use_awaitable);
+            co_await stream.async_close(boost::beast::websocket::close_code::normal, boost::asio::use_awaitable);
+            co_return;
+        }
+
+        std::cout << "[server] new session, room=" << seat.room->id << " assignedPlayer=" << seat.player << std::endl;
+        co_await boost::asio::co_spawn(
+            seat.room->strand,
+            HandlePlayer(seat.room, std::move(stream), std::move(request), seat.player, seat.startGame, std::move(joinRequest)),
+            boost::asio::use_awaitable);
     }
 
     boost::asio::awaitable<void> DoSession(WebSocketStream stream)
     {
-        if (g_state.connectedPlayers >= 2)
+        // Сначала читаем HTTP-запрос на апгрейд: по его цели решаем, в какую комнату идёт игрок
+        boost::beast::flat_buffer buffer;
+        boost::beast::http::request<boost::beast::http::string_body> request;
+        stream.next_layer().expires_after(g_state.config.handshakeTimeout);
+        co_await boost::beast::http::async_read(stream.next_layer(), buffer, request, boost::asio::use_awaitable);
+        stream.next_layer().expires_never();
+
+        const std::string_view target{ request.target().data(), request.target().size() };
+        if (!boost::beast::websocket::is_upgrade(request))
+        {
+            co_await RespondHttp(stream, request, boost::beast::http::status::bad_request, {});
+            co_return;
+        }
+
+        auto executor = co_await boost::asio::this_coro::executor;
+        if (target == MuxTarget)
+        {
+            auto connection = std::make_shared<MuxConnection>(std::move(stream), executor);
+            co_await boost::asio::co_spawn(connection->strand, ServeMux(connection, std::move(request)), boost::asio::use_awaitable);
+            co_return;
+        }
+        if (is_match_target(target))
         {
-            std::cout << "[server] reject connection: already 2 players" << std::endl;
-            co_return; // only one game with two players
+            co_await DoMatchSession(std::move(stream), std::move(request));
+            co_return;
         }
 
-        int assignedPlayer = g_state.connectedPlayers;
-        ++g_state.connectedPlayers;
-        std::cout << "[server] new session, assignedPlayer=" << assignedPlayer
-                  << " totalPlayers=" << g_state.connectedPlayers << std::endl;
+        auto [room, remoteOwner, remoteRoom, assignedPlayer, startGame, full] = assign_seat(target, executor);
+
+        if (full)
+        {
+            std::cout << "[server] reject connection: room memory limit reached" << std::endl;
+            co_await RespondHttp(stream, request, boost::beast::http::status::service_unavailable, {});
+            co_return;
+        }
+        if (!room)
+        {
+            if (remoteOwner)
+            {
+                // Комната живёт в другом процессе: отправляем клиента на его собственный порт
+                // по тому же адресу, на который пришло подключение
+                std::string location = "ws://" + local_address(stream) + ":" + std::to_string(remoteOwner->port)
+                    + "/room/" + std::to_string(remoteRoom);
+                std::cout << "[server] redirect to room " << remoteRoom << " owned by pid " << remoteOwner->pid
+                          << ": " << location << std::endl;
+                co_await RespondHttp(stream, request, boost::beast::http::status::temporary_redirect, location);
+            }
+            else
+            {
+                std::cout << "[server] reject connection: room " << remoteRoom << " not found" << std::endl;
+                co_await RespondHttp(stream, request, boost::beast::http::status::not_found, {});
+            }
+            co_return;
+        }
 
-        if (!g_state.gameStarted && g_state.connectedPlayers == 2)
+        if (assignedPlayer < 0)
         {
-            g_state.model.StartGame();
-            g_state.gameStarted = true;
-            std::cout << "[server] game started" << std::endl;
+            std::cout << "[server] reject connection: room " << room->id << " already has 2 players" << std::endl;
+            co_await RespondHttp(stream, request, boost::beast::http::status::conflict, {});
+            co_return;
         }
 
-        co_await HandlePlayer(std::move(stream), assignedPlayer);
+        std::cout << "[server] new session, room=" << room->id << " assignedPlayer=" << assignedPlayer << std::endl;
+
+        // Дальше сессия работает на strand комнаты: оба игрока обращаются к одной модели
+        co_await boost::asio::co_spawn(
+            room->strand,
+            HandlePlayer(room, std::move(stream), std::move(request), assignedPlayer, startGame),
+            boost::asio::use_awaitable);
+    }
+
+    // Подключение к адресу админки: только GET /admin/*, WebSocket здесь не принимается
+    boost::asio::awaitable<void> DoAdminSession(WebSocketStream stream)
+    {
+        boost::beast::flat_buffer buffer;
+        boost::beast::http::request<boost::beast::http::string_body> request;
+        stream.next_layer().expires_after(g_state.config.handshakeTimeout);
+        co_await boost::beast::http::async_read(stream.next_layer(), buffer, request, boost::asio::use_awaitable);
+        stream.next_layer().expires_never();
+
+        const std::string_view target{ request.target().data(), request.target().size() };
+        if (request.method() != boost::beast::http::verb::get)
+        {
+            co_await RespondHttp(stream, request, boost::beast::http::status::method_not_allowed, {});
+            co_return;
+        }
+        auto snapshot = g_state.analytics.load();
+        if (target == AnalyticsTarget && snapshot)
+        {
+            co_await RespondHttp(stream, request, boost::beast::http::status::ok, {},
+                analytics_json(*snapshot, g_state.boardRows, g_state.boardCols).dump());
+            co_return;
+        }
+        if (target == RoomsTarget)
+        {
+            co_await RespondHttp(stream, request, boost::beast::http::status::ok, {}, rooms_json().dump());
+            co_return;
+        }
+        co_await RespondHttp(stream, request, boost::beast::http::status::not_found, {});
     }
 
-    boost::asio::awaitable<void> DoListen(boost::asio::ip::tcp::endpoint endpoint)
+    // Acceptor - tcp::acceptor или local::stream_protocol::acceptor; принятый сокет
+    // становится SessionSocket, дальше сессия не знает, по какому транспорту пришёл игрок.
+    // session - игровая сессия (DoSession) или админка (DoAdminSession)
+    template <typename Acceptor>
+    boost::asio::awaitable<void> DoListen(
+        Acceptor acceptor, boost::asio::awaitable<void> (*session)(WebSocketStream) = DoSession)
     {
         auto executor = co_await boost::asio::this_coro::executor;
-        auto acceptor = boost::asio::ip::tcp::acceptor{ executor, endpoint };
+        constexpr bool isTcp = std::is_same_v<Acceptor, boost::asio::ip::tcp::acceptor>;
 
-        std::cout << "[server] listening on " << endpoint << std::endl;
+        std::cout << "[server] listening on " << (isTcp ? "" : "unix:") << acceptor.local_endpoint() << std::endl;
 
         for (;;)
         {
+            SessionSocket socket(executor);
+            co_await acceptor.async_accept(socket, boost::asio::use_awaitable);
+            if constexpr (isTcp)
+            {
+                boost::system::error_code ec;
+                socket.set_option(boost::asio::ip::tcp::no_delay(g_state.config.tcpNoDelay), ec);
+            }
+
             boost::asio::co_spawn(
                 executor,
-                DoSession(WebSocketStream{ co_await acceptor.async_accept(boost::asio::use_awaitable) }),
+                session(WebSocketStream{ std::move(socket) }),
                 [](std::exception_ptr e)
                 {
                     if (e)
@@ -303,37 +2058,313 @@ namespace
                 });
         }
     }
+
+    // Общий порт (shared): несколько процессов сервера слушают его одновременно, ядро распределяет
+    // подключения. Размеры буферов задаются на слушающем сокете - принятые соединения их наследуют.
+    boost::asio::ip::tcp::acceptor make_acceptor(
+        boost::asio::thread_pool& ioc,
+        const boost::asio::ip::tcp::endpoint& endpoint,
+        bool shared)
+    {
+        const auto& config = g_state.config;
+        boost::asio::ip::tcp::acceptor acceptor{ ioc };
+        acceptor.open(endpoint.protocol());
+        acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+#ifdef SO_REUSEPORT
+        if (shared)
+        {
+            using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+            acceptor.set_option(reuse_port(true));
+        }
+#endif
+        if (config.sendBufferSize > 0)
+        {
+            acceptor.set_option(boost::asio::socket_base::send_buffer_size(config.sendBufferSize));
+        }
+        if (config.receiveBufferSize > 0)
+        {
+            acceptor.set_option(boost::asio::socket_base::receive_buffer_size(config.receiveBufferSize));
+        }
+        acceptor.bind(endpoint);
+        acceptor.listen(config.backlog > 0 ? config.backlog : boost::asio::socket_base::max_listen_connections);
+
+        // Самопроверка: ядро может округлить или ограничить запрошенные значения
+        boost::asio::socket_base::send_buffer_size sendBuffer;
+        boost::asio::socket_base::receive_buffer_size receiveBuffer;
+        acceptor.get_option(sendBuffer);
+        acceptor.get_option(receiveBuffer);
+        std::cout << "[server] effective socket settings on " << acceptor.local_endpoint()
+                  << ": sndbuf=" << sendBuffer.value() << " rcvbuf=" << receiveBuffer.value()
+                  << " nodelay=" << (config.tcpNoDelay ? "on" : "off") << std::endl;
+        return acceptor;
+    }
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    // Unix-сокет для клиента на той же машине: ни TCP, ни loopback-интерфейса. Удаляется только
+    // сокет, оставшийся от упавшего процесса (к нему не подключиться); сокет живого сервера -
+    // например, соседнего процесса на том же порту - или не сокет по этому пути - ошибка запуска
+    boost::asio::local::stream_protocol::acceptor make_local_acceptor(boost::asio::thread_pool& ioc, const std::string& path)
+    {
+        const auto& config = g_state.config;
+        const boost::asio::local::stream_protocol::endpoint endpoint(path);
+        std::error_code statusError;
+        const auto status = std::filesystem::symlink_status(path, statusError);
+        if (std::filesystem::exists(status))
+        {
+            if (status.type() != std::filesystem::file_type::socket)
+            {
+                throw std::runtime_error("unix socket path '" + path + "' exists and is not a socket");
+            }
+            boost::asio::local::stream_protocol::socket probe{ ioc };
+            boost::system::error_code ec;
+            probe.connect(endpoint, ec);
+            if (!ec)
+            {
+                throw std::runtime_error("unix socket '" + path + "' is in use by another server");
+            }
+            if (ec != boost::asio::error::connection_refused)
+            {
+                throw std::runtime_error("unix socket '" + path + "': " + ec.message());
+            }
+            std::filesystem::remove(path);
+        }
+
+        boost::asio::local::stream_protocol::acceptor acceptor{ ioc };
+        acceptor.open();
+        acceptor.bind(endpoint);
+        g_state.unixSocketCreated = true;
+        acceptor.listen(config.backlog > 0 ? config.backlog : boost::asio::socket_base::max_listen_connections);
+        return acceptor;
+    }
+#endif
+
+    void log_listen_error(std::exception_ptr e)
+    {
+        if (e)
+        {
+            try
+            {
+                std::rethrow_exception(e);
+            }
+            catch (std::exception const& ex)
+            {
+                std::cerr << "[server] Error: " << ex.what() << std::endl;
+            }
+        }
+    }
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-    auto const address = boost::asio::ip::make_address("127.0.0.7");
-    auto const port = static_cast<unsigned short>(1365);
+    auto& config = g_state.config;
+    try
+    {
+        config.ParseCommandLine(argc, argv);
+        config.Validate();
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "[server] " << ex.what() << std::endl;
+        SeaBattle::ServerConfig::PrintUsage(std::cerr);
+        return 1;
+    }
+
+    std::cout << "[server] starting, pid=" << SeaBattle::RoomDirectory::CurrentProcessId() << std::endl;
+    config.Print(std::cout);
+
+    if (!config.traceFile.empty())
+    {
+        SeaBattle::Trace::Enable("server");
+    }
+
+    std::tie(g_state.boardRows, g_state.boardCols) = std::visit(
+        [](const auto& model)
+        {
+            using Rules = typename std::decay_t<decltype(model)>::RulesType;
+            return std::pair{ Rules::Rows, Rules::Cols };
+        },
+        SeaBattle::MakeGameModel(config.mode));
+
+    g_state.fleetPool = std::make_unique<SeaBattle::FleetPool>(config.mode, config.fleetPoolSize);
+    g_state.fleetPool->Start();
+
+    if (!config.openingBook.empty())
+    {
+        try
+        {
+            auto start = std::chrono::steady_clock::now();
+            g_state.openingBook = std::make_shared<const SeaBattle::OpeningBook>(config.openingBook);
+            auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "[server] opening book: " << g_state.openingBook->Size() << " positions, depth "
+                      << g_state.openingBook->Depth() << ", " << g_state.openingBook->Bytes() << " bytes mapped in "
+                      << elapsed << " us" << std::endl;
+        }
+        catch (const std::exception& ex)
+        {
+            std::cerr << "[server] " << ex.what() << std::endl;
+            g_state.fleetPool->Stop();
+            return 1;
+        }
+    }
+
+    if (!config.archiveFile.empty())
+    {
+        try
+        {
+            g_state.archive = std::make_unique<SeaBattle::RoomArchive>(config.archiveFile);
+        }
+        catch (const std::exception& ex)
+        {
+            std::cerr << "[server] " << ex.what() << std::endl;
+            g_state.fleetPool->Stop();
+            return 1;
+        }
+    }
+
+    if (config.botThreads > 0 && config.mode == SeaBattle::GameMode::Classic)
+    {
+        SeaBattle::BotExecutorConfig bots;
+        bots.threads = config.botThreads;
+        bots.cpuShare = config.botCpuShare;
+        bots.moveDeadline = config.botMoveDeadline;
+        bots.book = g_state.openingBook;
+        g_state.bots = std::make_unique<SeaBattle::BotExecutor>(std::move(bots));
+        g_state.bots->Start();
+    }
+
+    boost::asio::thread_pool ioc(config.threads);
+
+    // Часы партий: несколько колёс со своими мьютексами (столько же, сколько потоков), а не
+    // steady_timer на комнату - очередь таймеров asio общая для всего пула, и каждый ход
+    // переставлял бы в ней таймер своей комнаты
+    if (config.turnTimeout.count() > 0 || config.gameTimeout.count() > 0)
+    {
+        g_state.clockEpoch = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < config.threads; ++i)
+        {
+            g_state.clockWheels.push_back(std::make_unique<ClockWheel>());
+        }
+        for (auto& clocks : g_state.clockWheels)
+        {
+            boost::asio::co_spawn(ioc, TickClocks(*clocks), boost::asio::detached);
+        }
+    }
+    if (config.roomTtl.count() > 0)
+    {
+        boost::asio::co_spawn(ioc, EvictIdleRooms(config.roomTtl), boost::asio::detached);
+    }
+
+    try
+    {
+        const auto& primary = config.listen.front();
+        auto const address = boost::asio::ip::make_address(primary.address);
+
+        g_state.directory = std::make_unique<SeaBattle::RoomDirectory>(
+            "SeaBattleRooms_" + std::to_string(primary.port), 1 << 16);
+        // Комнаты процессов, которые упали, не убрав их из каталога
+        if (const auto removed = g_state.directory->RemoveDeadOwners(); removed > 0)
+        {
+            std::cout << "[server] room directory: removed " << removed << " rooms of dead processes" << std::endl;
+        }
+
+        // Собственный порт процесса: сюда перенаправляются подключения к его комнатам
+        auto privateAcceptor = make_acceptor(ioc, boost::asio::ip::tcp::endpoint{ address, 0 }, false);
+        g_state.privatePort = privateAcceptor.local_endpoint().port();
+
+        for (const auto& endpoint : config.listen)
+        {
+            boost::asio::ip::tcp::endpoint tcpEndpoint{ boost::asio::ip::make_address(endpoint.address), endpoint.port };
+            boost::asio::co_spawn(ioc, DoListen(make_acceptor(ioc, tcpEndpoint, true)), log_listen_error);
+        }
+        boost::asio::co_spawn(ioc, DoListen(std::move(privateAcceptor)), log_listen_error);
+
+        if (!config.unixSocket.empty())
+        {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            boost::asio::co_spawn(ioc, DoListen(make_local_acceptor(ioc, config.unixSocket)), log_listen_error);
+#else
+            throw std::runtime_error("unix sockets are not supported on this platform");
+#endif
+        }
 
-    boost::asio::thread_pool ioc(1);
+        if (config.adminListen)
+        {
+            // Только этот процесс: без SO_REUSEPORT второй процесс на том же адресе не запустится
+            boost::asio::ip::tcp::endpoint adminEndpoint{
+                boost::asio::ip::make_address(config.adminListen->address), config.adminListen->port };
+            boost::asio::co_spawn(ioc, DoListen(make_acceptor(ioc, adminEndpoint, false), DoAdminSession), log_listen_error);
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "[server] startup failed: " << ex.what() << std::endl;
+        ioc.stop();
+        ioc.join();
+        return 1;
+    }
 
-    std::cout << "[server] starting, address=" << address.to_string()
-              << " port=" << port << std::endl;
+    if (config.analyticsInterval.count() > 0)
+    {
+        boost::asio::co_spawn(ioc, PublishAnalytics(config.analyticsInterval), boost::asio::detached);
+    }
 
-    boost::asio::co_spawn(
-        ioc,
-        DoListen(boost::asio::ip::tcp::endpoint{ address, port }),
-        [](std::exception_ptr e)
+    // Остановка по Ctrl+C / SIGTERM, чтобы успеть выгрузить трассу
+    boost::asio::signal_set signals(ioc, SIGINT, SIGTERM);
+    signals.async_wait([&ioc](const boost::system::error_code& ec, int)
         {
-            if (e)
+            if (!ec)
             {
-                try
-                {
-                    std::rethrow_exception(e);
-                }
-                catch (std::exception const& ex)
-                {
-                    std::cerr << "[server] Error: " << ex.what() << std::endl;
-                }
+                ioc.stop();
             }
         });
 
-    ioc.wait();
+    ioc.join();
+    g_state.fleetPool->Stop();
+    log_fleet_pool();
+    // Пул остановлен - комнаты больше никто не трогает. Оставшиеся закрываются тем же путём, что
+    // и вытесненные: запись в каталоге удаляется (иначе соседние процессы отправляли бы игроков
+    // на закрытый порт), начатая партия уходит в архив
+    while (!g_state.rooms.empty())
+    {
+        auto room = g_state.rooms.begin()->second;
+        {
+            std::lock_guard<std::mutex> lock(g_state.mutex);
+            drop_room(*room);
+        }
+        if (room->gameStarted)
+        {
+            archive_room(*room);
+        }
+    }
+    if (g_state.archive)
+    {
+        g_state.archive->Flush();
+        std::cout << "[server] archived " << g_state.archive->Games() << " games" << std::endl;
+    }
+    if (g_state.bots)
+    {
+        g_state.bots->Stop();
+        log_bots();
+    }
+    // Наши записи уже убраны; последний процесс на порту удаляет и сам сегмент каталога
+    g_state.directory.reset();
+    if (g_state.unixSocketCreated)
+    {
+        std::error_code ec;
+        std::filesystem::remove(config.unixSocket, ec);
+    }
+
+    if (!config.traceFile.empty())
+    {
+        if (SeaBattle::Trace::WriteChromeTrace(config.traceFile))
+        {
+            std::cout << "[server] trace written to " << config.traceFile << std::endl;
+        }
+        else
+        {
+            std::cerr << "[server] failed to write trace " << config.traceFile << std::endl;
+        }
+    }
 
     std::cout << "[server] stopped" << std::endl;
     return 0;
@@ -1,158 +1,260 @@
 #include "BattleField.h"
 
+#include <QStyle>
+
+namespace
+{
+    // Одна таблица стилей на поле вместо своей у каждой клетки и заголовка: Qt разбирает её
+    // один раз, а вид клетки выбирается свойством "look" (см. setLook)
+    const char* const FieldStyleSheet =
+        "QLabel {"
+        "    font-size: 14px; font-weight: bold; color: white; background-color: #1F2A44;"
+        "}"
+        "QPushButton {"
+        "    background-color: #87CEEB;"
+        "    border: 1px solid #4682B4;"
+        "}"
+        "QPushButton[look=\"water\"]:hover {"
+        "    background-color: #B0E0E6;"
+        "}"
+        "QPushButton[look=\"ship\"] {"
+        "    background-color: #2E8B57;"
+        "    border: 1px solid #228B22;"
+        "}"
+        "QPushButton[look=\"debug\"] {"
+        "    background-color: #FFD700;"
+        "    border: 2px dashed #B8860B;"
+        "}"
+        "QPushButton[look=\"pending\"] {"
+        "    background-color: #DCE3EC;"
+        "    border: 2px dashed #7F8FA6;"
+        "}"
+        "QPushButton[look=\"hit\"] {"
+        "    background-color: #FF6B6B;"
+        "    border: 1px solid #FF4757;"
+        "}"
+        "QPushButton[look=\"miss\"] {"
+        "    background-color: #FFFFFF;"
+        "    border: 1px solid #CCCCCC;"
+        "}";
+
+    const char* const Water = "water";
+    const char* const ShipLook = "ship";
+    const char* const Debug = "debug";
+    const char* const Pending = "pending";
+    const char* const Hit = "hit";
+    const char* const Miss = "miss";
+
+    QByteArray look(const QPushButton* cell)
+    {
+        return cell->property("look").toByteArray();
+    }
+
+    void setLook(QPushButton* cell, const char* value)
+    {
+        if (look(cell) == value)
+        {
+            return;
+        }
+        cell->setProperty("look", QByteArray(value));
+        // Селекторы по свойствам пересчитываются только при повторной полировке виджета
+        cell->style()->unpolish(cell);
+        cell->style()->polish(cell);
+    }
+
+    bool isPending(const QPushButton* cell)
+    {
+        return look(cell) == Pending;
+    }
+
+    bool isShot(const QPushButton* cell)
+    {
+        const QByteArray value = look(cell);
+        return value == Hit || value == Miss || value == Pending;
+    }
+}
+
 BattleField::BattleField(bool showShips, QWidget* parent)
     : QWidget(parent), m_showShips(showShips)
 {
-    QGridLayout* grid = new QGridLayout(this);
+    setStyleSheet(FieldStyleSheet);
+
+    m_grid = new QGridLayout(this);
     // Без зазоров между ячейками и без внешних отступов
-    grid->setSpacing(0);
-    grid->setHorizontalSpacing(0);
-    grid->setVerticalSpacing(0);
-    grid->setContentsMargins(0, 0, 0, 0);
+    m_grid->setSpacing(0);
+    m_grid->setHorizontalSpacing(0);
+    m_grid->setVerticalSpacing(0);
+    m_grid->setContentsMargins(0, 0, 0, 0);
+
+    setBoardSize(10, 10);
+}
 
-    // Создаем буквенные обозначения для столбцов
-    QStringList letters = { "А", "Б", "В", "Г", "Д", "Е", "Ж", "З", "И", "К" };
+void BattleField::setBoardSize(int rows, int cols)
+{
+    if (rows == m_rows && cols == m_cols)
+    {
+        return;
+    }
+
+    // Удаляем клетки и заголовки предыдущего размера
+    while (QLayoutItem* item = m_grid->takeAt(0))
+    {
+        delete item->widget();
+        delete item;
+    }
+    for (int col = 1; col <= m_cols; ++col)
+    {
+        m_grid->setColumnStretch(col, 0);
+    }
+    for (int row = 1; row <= m_rows; ++row)
+    {
+        m_grid->setRowStretch(row, 0);
+    }
+
+    m_rows = rows;
+    m_cols = cols;
+
+    // Создаем буквенные обозначения для столбцов (без Ё и Й, как на классическом поле)
+    static const QStringList letters = { "А", "Б", "В", "Г", "Д", "Е", "Ж", "З", "И", "К", "Л", "М", "Н", "О", "П" };
 
     // Добавляем пустой угол (оформление заголовков)
     QLabel* corner = new QLabel("");
     corner->setAlignment(Qt::AlignCenter);
     corner->setMinimumSize(30, 30);
     corner->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    corner->setStyleSheet("font-size: 14px; font-weight: bold; color: white; background-color: #1F2A44;");
-    grid->addWidget(corner, 0, 0);
+    m_grid->addWidget(corner, 0, 0);
 
     // Добавляем буквенные заголовки (выровнены по центру и читаемые)
-    for (int col = 0; col < 10; ++col)
+    for (int col = 0; col < m_cols; ++col)
     {
-        QLabel* label = new QLabel(letters[col]);
+        QLabel* label = new QLabel(col < letters.size() ? letters[col] : QString::number(col + 1));
         label->setAlignment(Qt::AlignCenter);
         label->setMinimumSize(30, 30);
         label->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        label->setStyleSheet("font-size: 14px; font-weight: bold; color: white; background-color: #1F2A44;");
-        grid->addWidget(label, 0, col + 1);
-        grid->setColumnStretch(col + 1, 1);
+        m_grid->addWidget(label, 0, col + 1);
+        m_grid->setColumnStretch(col + 1, 1);
     }
 
-    m_cells.resize(10);
-    for (int row = 0; row < 10; ++row)
+    m_cells.clear();
+    m_cells.resize(m_rows);
+    for (int row = 0; row < m_rows; ++row)
     {
-        m_cells[row].resize(10);
+        m_cells[row].resize(m_cols);
 
         QLabel* numberLabel = new QLabel(QString::number(row + 1));
         numberLabel->setAlignment(Qt::AlignCenter);
         numberLabel->setMinimumSize(30, 30);
         numberLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        numberLabel->setStyleSheet("font-size: 14px; font-weight: bold; color: white; background-color: #1F2A44;");
-        grid->addWidget(numberLabel, row + 1, 0);
-        grid->setRowStretch(row + 1, 1);
+        m_grid->addWidget(numberLabel, row + 1, 0);
+        m_grid->setRowStretch(row + 1, 1);
 
-        for (int col = 0; col < 10; ++col)
+        for (int col = 0; col < m_cols; ++col)
         {
             QPushButton* cell = new QPushButton();
             cell->setMinimumSize(30, 30);
             cell->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
             cell->setProperty("row", row);
             cell->setProperty("col", col);
+            // До добавления в сетку полировки ещё не было, достаточно задать свойство
+            cell->setProperty("look", QByteArray(Water));
 
-            cell->setStyleSheet(
-                "QPushButton {"
-                "    background-color: #87CEEB;"
-                "    border: 1px solid #4682B4;"
-                "}"
-                "QPushButton:hover {"
-                "    background-color: #B0E0E6;"
-                "}");
-
-            grid->addWidget(cell, row + 1, col + 1);
+            m_grid->addWidget(cell, row + 1, col + 1);
             m_cells[row][col] = cell;
             connect(cell, &QPushButton::clicked, this, &BattleField::onCellClicked);
         }
     }
 }
 
-static inline bool isShotStyle(const QString& style)
+bool BattleField::isValidCell(int row, int col) const
 {
-    return style.contains("#FF6B6B") || style.contains("#FFFFFF") || style.contains("#FF4757") || style.contains("#CCCCCC");
+    return row >= 0 && row < m_rows && col >= 0 && col < m_cols && m_cells[row][col];
 }
 
 void BattleField::markHit(int row, int col)
 {
-    if (row >= 0 && row < 10 && col >= 0 && col < 10 && m_cells[row][col])
+    if (isValidCell(row, col))
     {
         QPushButton* cell = m_cells[row][col];
-        cell->setStyleSheet(
-            "QPushButton {"
-            "    background-color: #FF6B6B;"
-            "    border: 1px solid #FF4757;"
-            "}");
+        setLook(cell, Hit);
         cell->setEnabled(false);
     }
 }
 
 void BattleField::markMiss(int row, int col)
 {
-    if (row >= 0 && row < 10 && col >= 0 && col < 10 && m_cells[row][col])
+    if (isValidCell(row, col))
     {
         QPushButton* cell = m_cells[row][col];
-        cell->setStyleSheet(
-            "QPushButton {"
-            "    background-color: #FFFFFF;"
-            "    border: 1px solid #CCCCCC;"
-            "}");
+        setLook(cell, Miss);
         cell->setEnabled(false);
     }
 }
 
 void BattleField::markShip(int row, int col)
 {
-    if (row >= 0 && row < 10 && col >= 0 && col < 10 && m_cells[row][col])
+    if (isValidCell(row, col))
     {
         QPushButton* cell = m_cells[row][col];
-        if (!isShotStyle(cell->styleSheet()))
+        if (!isShot(cell))
         {
-            cell->setStyleSheet(
-                "QPushButton {"
-                "    background-color: #2E8B57;"
-                "    border: 1px solid #228B22;"
-                "}");
+            setLook(cell, ShipLook);
         }
     }
 }
 
 void BattleField::markDebug(int row, int col)
 {
-    if (row >= 0 && row < 10 && col >= 0 && col < 10 && m_cells[row][col])
+    if (isValidCell(row, col))
     {
         QPushButton* cell = m_cells[row][col];
-        if (!isShotStyle(cell->styleSheet()))
+        if (!isShot(cell))
         {
-            cell->setStyleSheet(
-                "QPushButton {"
-                "    background-color: #FFD700;"
-                "    border: 2px dashed #B8860B;"
-                "}");
+            setLook(cell, Debug);
         }
     }
 }
 
+void BattleField::markPending(int row, int col)
+{
+    if (isValidCell(row, col))
+    {
+        QPushButton* cell = m_cells[row][col];
+        setLook(cell, Pending);
+        cell->setEnabled(false);
+    }
+}
+
+void BattleField::clearPending(int row, int col)
+{
+    if (isValidCell(row, col))
+    {
+        QPushButton* cell = m_cells[row][col];
+        if (isPending(cell))
+        {
+            setLook(cell, Water);
+        }
+    }
+}
+
+void BattleField::clearShot(int row, int col)
+{
+    if (isValidCell(row, col))
+    {
+        setLook(m_cells[row][col], Water);
+    }
+}
+
 void BattleField::resetUnfiredCellsStyle()
 {
-    for (int r = 0; r < 10; ++r)
+    for (int r = 0; r < m_rows; ++r)
     {
-        for (int c = 0; c < 10; ++c)
+        for (int c = 0; c < m_cols; ++c)
         {
             QPushButton* cell = m_cells[r][c];
             if (!cell) continue;
-            if (!isShotStyle(cell->styleSheet()))
+            if (!isShot(cell))
             {
-                cell->setStyleSheet(
-                    "QPushButton {"
-                    "    background-color: #87CEEB;"
-                    "    border: 1px solid #4682B4;"
-                    "}"
-                    "QPushButton:hover {"
-                    "    background-color: #B0E0E6;"
-                    "}");
+                setLook(cell, Water);
             }
         }
     }
@@ -160,20 +262,13 @@ void BattleField::resetUnfiredCellsStyle()
 
 void BattleField::clearAll()
 {
-    for (int r = 0; r < 10; ++r)
+    for (int r = 0; r < m_rows; ++r)
     {
-        for (int c = 0; c < 10; ++c)
+        for (int c = 0; c < m_cols; ++c)
         {
             QPushButton* cell = m_cells[r][c];
             if (!cell) continue;
-            cell->setStyleSheet(
-                "QPushButton {"
-                "    background-color: #87CEEB;"
-                "    border: 1px solid #4682B4;"
-                "}"
-                "QPushButton:hover {"
-                "    background-color: #B0E0E6;"
-                "}");
+            setLook(cell, Water);
             cell->setEnabled(true);
         }
     }
@@ -181,13 +276,13 @@ void BattleField::clearAll()
 
 void BattleField::enableUnshotCells()
 {
-    for (int r = 0; r < 10; ++r)
+    for (int r = 0; r < m_rows; ++r)
     {
-        for (int c = 0; c < 10; ++c)
+        for (int c = 0; c < m_cols; ++c)
         {
             QPushButton* cell = m_cells[r][c];
             if (!cell) continue;
-            if (!isShotStyle(cell->styleSheet()))
+            if (!isShot(cell))
             {
                 cell->setEnabled(true);
             }
@@ -197,7 +292,7 @@ void BattleField::enableUnshotCells()
 
 void BattleField::setCellEnabled(int row, int col, bool enabled)
 {
-    if (row >= 0 && row < 10 && col >= 0 && col < 10 && m_cells[row][col])
+    if (isValidCell(row, col))
     {
         m_cells[row][col]->setEnabled(enabled);
     }
@@ -205,9 +300,9 @@ void BattleField::setCellEnabled(int row, int col, bool enabled)
 
 void BattleField::disableAllCells()
 {
-    for (int row = 0; row < 10; ++row)
+    for (int row = 0; row < m_rows; ++row)
     {
-        for (int col = 0; col < 10; ++col)
+        for (int col = 0; col < m_cols; ++col)
         {
             if (m_cells[row][col])
             {
@@ -219,9 +314,9 @@ void BattleField::disableAllCells()
 
 void BattleField::enableAllCells()
 {
-    for (int row = 0; row < 10; ++row)
+    for (int row = 0; row < m_rows; ++row)
     {
-        for (int col = 0; col < 10; ++col)
+        for (int col = 0; col < m_cols; ++col)
         {
             if (m_cells[row][col])
             {
@@ -233,9 +328,9 @@ void BattleField::enableAllCells()
 
 void BattleField::setEnabled(bool enabled)
 {
-    for (int row = 0; row < 10; ++row)
+    for (int row = 0; row < m_rows; ++row)
     {
-        for (int col = 0; col < 10; ++col)
+        for (int col = 0; col < m_cols; ++col)
         {
             if (m_cells[row][col])
             {
@@ -2,17 +2,30 @@
 
 #include <QWidget>
 
+class QGridLayout;
+
 class BattleField : public QWidget
 {
     Q_OBJECT
 public:
     BattleField(bool showShips = false, QWidget* parent = nullptr);
 
+    // Перестраивает сетку под размер поля выбранного варианта игры
+    void setBoardSize(int rows, int cols);
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
 public slots:
     void markHit(int row, int col);
     void markMiss(int row, int col);
     void markShip(int row, int col);
     void markDebug(int row, int col);
+    // Выстрел отправлен, ответа сервера ещё нет: клетка уже выглядит обстрелянной и не нажимается
+    void markPending(int row, int col);
+    // Сервер отклонил выстрел - возвращаем клетке исходный вид
+    void clearPending(int row, int col);
+    // Перемотка записи назад: клетка снова выглядит необстрелянной
+    void clearShot(int row, int col);
     void setCellEnabled(int row, int col, bool enabled);
     void disableAllCells();
     void enableAllCells();
@@ -28,6 +41,11 @@ private slots:
     void onCellClicked();
 
 private:
+    bool isValidCell(int row, int col) const;
+
     bool m_showShips;
+    int m_rows = 0;
+    int m_cols = 0;
+    QGridLayout* m_grid;
     QVector<QVector<QPushButton*>> m_cells;
 };
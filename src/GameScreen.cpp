@@ -30,12 +30,16 @@ GameScreen::GameScreen(QWidget* parent)
     m_exitButton->setStyleSheet("font-size: 14px; padding: 10px;");
     m_exitButton->setVisible(false); // Изначально скрыта
 
+    m_rttLabel = new QLabel();
+    m_rttLabel->setStyleSheet("font-size: 14px; color: white;");
+
     // Собираем layout для игровых полей
     m_fieldsLayout->addLayout(m_leftLayout);
     m_fieldsLayout->addLayout(m_rightLayout);
 
     // Создаём горизонтальный layout для кнопок внизу
     m_buttonsLayout = new QHBoxLayout();
+    m_buttonsLayout->addWidget(m_rttLabel);
     m_buttonsLayout->addStretch(); // Растягивающий элемент слева для выравнивания кнопки вправо
     m_buttonsLayout->addWidget(m_exitButton);
 
@@ -66,6 +70,12 @@ void GameScreen::setLocalPlayer(int localPlayer)
     // rebuildLayoutsForCurrentPlayer будет вызван через onPlayerSwitched.
 }
 
+void GameScreen::setBoardSize(int rows, int cols)
+{
+    m_player1Field->setBoardSize(rows, cols);
+    m_player2Field->setBoardSize(rows, cols);
+}
+
 void GameScreen::setPlayerNames(const QString& localName, const QString& opponentName)
 {
     m_localPlayerName = localName;
@@ -73,6 +83,17 @@ void GameScreen::setPlayerNames(const QString& localName, const QString& opponen
     updateLabels();
 }
 
+void GameScreen::setRoundTripTime(double milliseconds)
+{
+    m_rttLabel->setText(QString("Задержка: %1 мс").arg(milliseconds, 0, 'f', 1));
+}
+
+void GameScreen::setReplayControls(QWidget* controls)
+{
+    m_buttonsLayout->insertWidget(1, controls, 1);
+    controls->show();
+}
+
 void GameScreen::updateLabels()
 {
     if (m_localPlayerName.isEmpty())
@@ -158,7 +179,13 @@ void GameScreen::onCellUpdated(int player, int row, int col, SeaBattle::CellStat
         case SeaBattle::CellState::Destroyed:
             targetField->markHit(row, col);
             break;
-        default:
+        case SeaBattle::CellState::Empty:
+            // Выстрел отменён (перемотка записи назад)
+            targetField->clearShot(row, col);
+            break;
+        case SeaBattle::CellState::Ship:
+            targetField->clearShot(row, col);
+            targetField->markShip(row, col);
             break;
         }
     }
@@ -194,7 +221,7 @@ void GameScreen::onGameOver(bool win)
 void GameScreen::onEnemyCellClicked(int row, int col)
 {
     // Не блокируем все поле: пусть модель решает исход.
-    // Клик по клетке будет визуально зафиксирован через markHit/markMiss.
+    // Клетка помечается "ожидающей" в MainWindow, итог - через markHit/markMiss.
     // Передаём локального игрока, так как именно он делает выстрел
     emit cellClicked(m_localPlayer, row, col);
 }
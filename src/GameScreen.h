@@ -24,9 +24,18 @@ public:
     // Устанавливает локального игрока для правильного отображения полей
     void setLocalPlayer(int localPlayer);
 
+    // Перестраивает оба поля под размер поля текущего варианта игры
+    void setBoardSize(int rows, int cols);
+
     // Устанавливает имена игроков для отображения
     void setPlayerNames(const QString& localName, const QString& opponentName);
 
+    // Показывает время ответа сервера на последний выстрел
+    void setRoundTripTime(double milliseconds);
+
+    // Панель просмотра записи (ReplayControls) в нижней строке, рядом с кнопкой выхода
+    void setReplayControls(QWidget* controls);
+
 public slots:
     void onPlayerSwitched(int newPlayer);
     void onCellUpdated(int player, int row, int col, SeaBattle::CellState state);
@@ -62,4 +71,5 @@ private:
     QLabel* m_player1Label;
     QLabel* m_player2Label;
     QPushButton* m_exitButton; // Кнопка выхода из игры
+    QLabel* m_rttLabel; // Задержка ответа сервера
 };
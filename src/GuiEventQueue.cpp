@@ -0,0 +1,142 @@
+#include "GuiEventQueue.h"
+
+#include "MainWindow.h"
+
+#include "Trace.h"
+
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+GuiEventQueue::GuiEventQueue(MainWindow& window, std::size_t capacity)
+    : m_window(window)
+    , m_queue(capacity)
+{
+}
+
+void GuiEventQueue::Push(const GuiEvent& event)
+{
+    // Кольцо заполнено, только если GUI давно не разбирал его; события терять нельзя.
+    // Писатель в потоке GUI (просмотр записи) ждать сам себя не может - разбирает сразу
+    while (!m_queue.TryPush(event))
+    {
+        if (QThread::currentThread() == m_window.thread())
+        {
+            drain();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    if (!m_drainScheduled.exchange(true, std::memory_order_acq_rel))
+    {
+        QMetaObject::invokeMethod(&m_window, [this]() { scheduleDrain(); }, Qt::QueuedConnection);
+    }
+}
+
+void GuiEventQueue::scheduleDrain()
+{
+    qint64 elapsed = m_sinceDrain.isValid() ? m_sinceDrain.elapsed() : FrameIntervalMs;
+    if (elapsed >= FrameIntervalMs)
+    {
+        drain();
+        return;
+    }
+    QTimer::singleShot(static_cast<int>(FrameIntervalMs - elapsed), &m_window, [this]() { drain(); });
+}
+
+void GuiEventQueue::drain()
+{
+    SeaBattle::Trace::Span span("GuiEventQueue::drain");
+
+    // Сбрасываем флаг до разбора: событие, пришедшее во время разбора, запланирует следующий
+    m_drainScheduled.store(false, std::memory_order_release);
+    m_sinceDrain.start();
+
+    // Изменения клеток в порядке поступления; повтор по той же клетке заменяет прежнее на месте
+    std::vector<GuiEvent> cells;
+    GuiEvent playerSwitch;
+    GuiEvent gameOver;
+    GuiEvent roundTrip;
+    bool hasPlayerSwitch = false;
+    bool hasGameOver = false;
+    bool hasRoundTrip = false;
+
+    GuiEvent event;
+    while (m_queue.TryPop(event))
+    {
+        switch (event.type)
+        {
+        case GuiEvent::Type::CellUpdate:
+        case GuiEvent::Type::ShotRejected:
+        {
+            // player - кто стрелял: так различаются одна и та же клетка на своём и чужом поле
+            auto same = std::find_if(cells.begin(), cells.end(), [&event](const GuiEvent& cell) {
+                return cell.player == event.player && cell.row == event.row && cell.col == event.col;
+            });
+            if (same != cells.end())
+            {
+                *same = event;
+            }
+            else
+            {
+                cells.push_back(event);
+            }
+            break;
+        }
+        case GuiEvent::Type::PlayerSwitch:
+            playerSwitch = event;
+            hasPlayerSwitch = true;
+            break;
+        case GuiEvent::Type::GameOver:
+            gameOver = event;
+            hasGameOver = true;
+            break;
+        case GuiEvent::Type::RoundTrip:
+            roundTrip = event;
+            hasRoundTrip = true;
+            break;
+        }
+    }
+
+    // Пачка клеток перекрашивается без промежуточных перерисовок, окно обновится один раз.
+    // Одиночную клетку так не обрабатываем: Qt перерисует только её, а не всё окно.
+    const bool batch = cells.size() > 1;
+    if (batch)
+    {
+        m_window.setUpdatesEnabled(false);
+    }
+    for (const auto& cell : cells)
+    {
+        if (cell.type == GuiEvent::Type::CellUpdate)
+        {
+            m_window.onCellUpdated(cell.player, cell.row, cell.col, cell.state);
+        }
+        else
+        {
+            m_window.onShotRejected(cell.row, cell.col);
+        }
+    }
+    if (hasRoundTrip)
+    {
+        m_window.onRoundTripMeasured(roundTrip.milliseconds);
+    }
+    if (batch)
+    {
+        m_window.setUpdatesEnabled(true);
+    }
+
+    // Смена хода и конец игры показывают модальные окна - после того, как поле перерисовано
+    if (hasPlayerSwitch)
+    {
+        m_window.onPlayerSwitched(playerSwitch.player);
+    }
+    if (hasGameOver)
+    {
+        m_window.onGameOver(gameOver.win);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "IModel.h"
+#include "SpscQueue.h"
+
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <cstdint>
+
+class MainWindow;
+
+// Событие модели для потока GUI; поля, не нужные типу события, не заполняются.
+// player - стрелявший (для отказа - локальный игрок) или новый текущий игрок при смене хода.
+struct GuiEvent
+{
+    enum class Type : std::uint8_t
+    {
+        CellUpdate,
+        ShotRejected,
+        PlayerSwitch,
+        GameOver,
+        RoundTrip
+    };
+
+    Type type = Type::CellUpdate;
+    std::int8_t player = 0;
+    std::int8_t row = 0;
+    std::int8_t col = 0;
+    SeaBattle::CellState state = SeaBattle::CellState::Empty;
+    bool win = false;
+    double milliseconds = 0.0;
+};
+
+// Мост от потока сети к окну: события копятся в кольце без блокировок, окно забирает их
+// пачкой не чаще раза за кадр. Перед применением пачка сворачивается: по каждой клетке
+// остаётся последнее изменение, из смен хода и замеров задержки - последние, поэтому
+// всплеск событий даёт одну перерисовку. Писатель - один поток: поток сети Client
+// или поток GUI при просмотре записи.
+class GuiEventQueue
+{
+public:
+    explicit GuiEventQueue(MainWindow& window, std::size_t capacity = 1024);
+
+    // Только поток-писатель
+    void Push(const GuiEvent& event);
+
+private:
+    // Поток GUI: откладывает разбор до следующего кадра, если предыдущий был недавно
+    void scheduleDrain();
+    void drain();
+
+    static constexpr qint64 FrameIntervalMs = 16;
+
+    MainWindow& m_window;
+    SeaBattle::SpscQueue<GuiEvent> m_queue;
+    // Разбор уже запланирован: следующие события не ставят в очередь Qt новых вызовов
+    std::atomic<bool> m_drainScheduled{ false };
+    QElapsedTimer m_sinceDrain;
+};
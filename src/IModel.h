@@ -1,5 +1,9 @@
 #pragma once
 
+#include "StaticVector.h"
+
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -14,36 +18,48 @@ namespace SeaBattle
         Destroyed
     };
 
-    enum class ShipType
+    enum class ShipType : std::uint8_t
     {
         SingleDeck = 1,
         DoubleDeck = 2,
         TripleDeck = 3,
-        FourDeck = 4
+        FourDeck = 4,
+        FiveDeck = 5
+    };
+
+    constexpr int MaxShipSize = 5;
+
+    struct Position
+    {
+        std::int8_t row = 0;
+        std::int8_t col = 0;
+
+        bool operator==(const Position&) const = default;
     };
 
     struct Ship
     {
-        ShipType type;
-        int health;
-        std::vector<std::pair<int, int>> positions; // координаты корабля
-        bool isVertical;
+        ShipType type = ShipType::SingleDeck;
+        std::int8_t health = 0;
+        bool isVertical = false;
+        StaticVector<Position, MaxShipSize> positions; // координаты корабля
+
+        Ship() = default;
 
         Ship(ShipType t, int startRow, int startCol, bool vertical)
             : type(t)
-            , health(static_cast<int>(t))
+            , health(static_cast<std::int8_t>(t))
             , isVertical(vertical)
         {
-            positions.reserve(health);
             for (int i = 0; i < health; ++i)
             {
                 if (vertical)
                 {
-                    positions.emplace_back(startRow + i, startCol);
+                    positions.push_back({ static_cast<std::int8_t>(startRow + i), static_cast<std::int8_t>(startCol) });
                 }
                 else
                 {
-                    positions.emplace_back(startRow, startCol + i);
+                    positions.push_back({ static_cast<std::int8_t>(startRow), static_cast<std::int8_t>(startCol + i) });
                 }
             }
         }
@@ -61,21 +77,36 @@ namespace SeaBattle
     enum class ConnectionStatus
     {
         WaitingForPlayers,
-        Loading
+        Loading,
+        // Сервер закрыл простаивающую комнату и отключил игрока: к партии не вернуться
+        Evicted
     };
 
     struct IModel
     {
         virtual ~IModel() = default;
 
+        // Подготовка к StartGame, пока игрок вводит имя (например, соединение с сервером).
+        // Не блокирует; если подготовка не удалась, StartGame выполнит её сам.
+        virtual void PrepareGame() = 0;
+        // Игрок передумал начинать игру: подготовленное в PrepareGame освобождается
+        virtual void CancelPrepare() = 0;
         virtual void StartGame() = 0;
+        // Выстрел локального игрока. Не ждёт результата: попадание, промах и смена хода
+        // приходят через колбэки модели. false - выстрел сразу отклонён (не наш ход,
+        // клетка уже обстреляна или предыдущий выстрел ещё без ответа).
         virtual bool ProcessShot(int row, int col) = 0;
 
-        virtual const std::vector<SeaBattle::Ship>& GetPlayerShips(int player) const = 0;
+        // Флот игрока - неизменяемый срез: его можно читать из любого потока, пока он удерживается
+        virtual std::shared_ptr<const std::vector<SeaBattle::Ship>> GetPlayerShips(int player) const = 0;
         virtual int GetCurrentPlayer() const = 0;
         virtual int GetLocalPlayer() const = 0;
         virtual GameState GetGameState() const = 0;
 
+        // Размеры поля зависят от варианта игры, выбранного сервером
+        virtual int GetBoardRows() const = 0;
+        virtual int GetBoardCols() const = 0;
+
         // Player name support
         virtual void SetPlayerName(const std::string& name) = 0;
         virtual std::string GetLocalPlayerName() const = 0;
@@ -0,0 +1,107 @@
+#include "LocalGame.h"
+
+#include "GameModel.h"
+#include "Strategy.h"
+
+struct LocalGame::Impl
+{
+    SeaBattle::GameModel model;
+    std::unique_ptr<SeaBattle::IShotStrategy> bot;
+    std::mt19937 gen;
+    std::vector<LocalGame::Shot> history;
+};
+
+LocalGame::LocalGame()
+    : m_impl(std::make_unique<Impl>())
+{
+}
+
+LocalGame::~LocalGame() = default;
+
+std::vector<std::string> LocalGame::BotStrategyNames()
+{
+    const auto& names = SeaBattle::StrategyNames();
+    return { names.begin(), names.end() };
+}
+
+bool LocalGame::SetBotStrategy(const std::string& name)
+{
+    m_impl->bot = SeaBattle::MakeStrategy(name);
+    return m_impl->bot != nullptr;
+}
+
+void LocalGame::Start(std::uint32_t seed)
+{
+    m_impl->gen.seed(seed);
+    m_impl->model.StartGame(m_impl->gen);
+    m_impl->history.clear();
+}
+
+bool LocalGame::Shoot(int player, int row, int col)
+{
+    if (!m_impl->model.IsValidShot(player, row, col))
+    {
+        return false;
+    }
+    m_impl->model.ProcessShot(player, row, col);
+    m_impl->history.push_back({ player, row, col });
+    return true;
+}
+
+bool LocalGame::NextBotShot(int player, int& row, int& col)
+{
+    if (!m_impl->bot)
+    {
+        return false;
+    }
+    auto board = SeaBattle::ShotBoard::FromEnemyField(m_impl->model.GetEnemyField(player));
+    SeaBattle::Position shot = m_impl->bot->NextShot(board, m_impl->gen);
+    row = shot.row;
+    col = shot.col;
+    return true;
+}
+
+int LocalGame::CurrentPlayer() const
+{
+    return m_impl->model.GetCurrentPlayer();
+}
+
+int LocalGame::State() const
+{
+    return static_cast<int>(m_impl->model.GetGameState());
+}
+
+int LocalGame::Winner() const
+{
+    return m_impl->model.GetWinner();
+}
+
+int LocalGame::Rows() const
+{
+    return SeaBattle::GameField::ROWS;
+}
+
+int LocalGame::Cols() const
+{
+    return SeaBattle::GameField::COLS;
+}
+
+int LocalGame::Cell(int owner, int row, int col) const
+{
+    return static_cast<int>(m_impl->model.GetPlayerField(owner).getCellState(row, col));
+}
+
+std::vector<LocalGame::ShipInfo> LocalGame::Ships(int player) const
+{
+    std::vector<ShipInfo> ships;
+    for (const auto& ship : m_impl->model.GetPlayerField(player).getShips())
+    {
+        ships.push_back({ static_cast<int>(ship.type), ship.positions[0].row, ship.positions[0].col, ship.isVertical });
+    }
+    return ships;
+}
+
+const std::vector<LocalGame::Shot>& LocalGame::History() const
+{
+    return m_impl->history;
+}
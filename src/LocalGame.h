@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Партия без сервера: игровая модель и стратегии бота из seabattle_core.
+// IModel.h и GameModel.h объявляют одноимённые типы в пространстве SeaBattle,
+// поэтому мост не пускает серверные типы наружу: состояния передаются числами
+// с той же нумерацией, что и в протоколе (GameState, CellState).
+class LocalGame
+{
+public:
+    struct ShipInfo
+    {
+        int size = 0;
+        int row = 0;
+        int col = 0;
+        bool vertical = false;
+    };
+
+    struct Shot
+    {
+        int player = 0;
+        int row = 0;
+        int col = 0;
+    };
+
+    LocalGame();
+    ~LocalGame();
+
+    // Имена стратегий бота для SetBotStrategy
+    static std::vector<std::string> BotStrategyNames();
+
+    // Бот для ходов через NextBotShot; false, если стратегии с таким именем нет
+    bool SetBotStrategy(const std::string& name);
+
+    void Start(std::uint32_t seed);
+    // false - выстрел недопустим (не его ход, клетка уже обстреляна или вне поля)
+    bool Shoot(int player, int row, int col);
+    // Выстрел бота за player по видимому ему полю противника; false, если бот не задан
+    bool NextBotShot(int player, int& row, int& col);
+
+    int CurrentPlayer() const;
+    int State() const;
+    int Winner() const;
+    int Rows() const;
+    int Cols() const;
+    // Состояние клетки поля игрока owner
+    int Cell(int owner, int row, int col) const;
+    std::vector<ShipInfo> Ships(int player) const;
+    // Принятые выстрелы с начала партии, по порядку - для записи партии (ReplayGame::Save)
+    const std::vector<Shot>& History() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
@@ -0,0 +1,240 @@
+#include "LocalModel.h"
+#include "LocalGame.h"
+#include "ReplayGame.h"
+
+#include "Trace.h"
+
+#include <iostream>
+#include <random>
+
+LocalModel::LocalModel(std::string botStrategy)
+    : m_botStrategy(std::move(botStrategy))
+{
+    m_names[1] = m_botStrategy.empty() ? "Игрок 2" : "Бот (" + m_botStrategy + ")";
+}
+
+LocalModel::~LocalModel() = default;
+
+void LocalModel::StartGame()
+{
+    if (m_statusCallback)
+    {
+        m_statusCallback(SeaBattle::ConnectionStatus::Loading);
+    }
+
+    m_game = std::make_unique<LocalGame>();
+    if (!m_botStrategy.empty())
+    {
+        // Имя проверяется при разборе командной строки, неизвестной стратегии здесь быть не может
+        m_game->SetBotStrategy(m_botStrategy);
+    }
+    m_game->Start(std::random_device{}());
+    m_viewer = 0;
+
+    for (int player = 0; player < 2; ++player)
+    {
+        std::vector<SeaBattle::Ship> ships;
+        for (const auto& ship : m_game->Ships(player))
+        {
+            ships.emplace_back(static_cast<SeaBattle::ShipType>(ship.size), ship.row, ship.col, ship.vertical);
+        }
+        m_ships[player] = std::make_shared<const std::vector<SeaBattle::Ship>>(std::move(ships));
+    }
+
+    notifyNames();
+    if (m_gameReadyCallback)
+    {
+        m_gameReadyCallback();
+    }
+}
+
+bool LocalModel::ProcessShot(int row, int col)
+{
+    if (!m_game)
+        return false;
+
+    SeaBattle::Trace::Span span("LocalModel::ProcessShot");
+
+    if (m_game->CurrentPlayer() != GetLocalPlayer() || !applyShot(GetLocalPlayer(), row, col))
+    {
+        return false;
+    }
+    if (!m_botStrategy.empty())
+    {
+        playBotTurns();
+    }
+    return true;
+}
+
+bool LocalModel::applyShot(int player, int row, int col)
+{
+    if (!m_game->Shoot(player, row, col))
+    {
+        return false;
+    }
+
+    const int target = 1 - player;
+    auto state = static_cast<SeaBattle::CellState>(m_game->Cell(target, row, col));
+    if (m_cellUpdateCallback)
+    {
+        m_cellUpdateCallback(player, row, col, state);
+    }
+
+    if (m_game->State() == static_cast<int>(SeaBattle::GameState::GameOver))
+    {
+        saveRecord();
+        if (m_gameOverCallback)
+        {
+            m_gameOverCallback(m_game->Winner() == GetLocalPlayer());
+        }
+        return true;
+    }
+
+    const int next = m_game->CurrentPlayer();
+    if (next == player)
+    {
+        return true;
+    }
+
+    if (m_botStrategy.empty())
+    {
+        // Hot-seat: поля очищаются до сообщения о смене хода, чтобы следующий игрок
+        // не увидел чужих кораблей, и заполняются уже с его стороны
+        m_viewer = next;
+        if (m_localPlayerCallback)
+        {
+            m_localPlayerCallback(m_viewer);
+        }
+        notifyNames();
+        if (m_playerSwitchCallback)
+        {
+            m_playerSwitchCallback(next);
+        }
+        replayShots(m_viewer);
+    }
+    else if (m_playerSwitchCallback)
+    {
+        m_playerSwitchCallback(next);
+    }
+    return true;
+}
+
+void LocalModel::playBotTurns()
+{
+    while (m_game->State() == static_cast<int>(SeaBattle::GameState::Playing) && m_game->CurrentPlayer() == BotPlayer)
+    {
+        int row = 0;
+        int col = 0;
+        // Стратегии выбирают только необстрелянные клетки; отказ значит ошибку в стратегии
+        if (!m_game->NextBotShot(BotPlayer, row, col) || !applyShot(BotPlayer, row, col))
+        {
+            break;
+        }
+    }
+}
+
+void LocalModel::replayShots(int viewer)
+{
+    if (!m_cellUpdateCallback)
+        return;
+
+    const int opponent = 1 - viewer;
+    for (int row = 0; row < m_game->Rows(); ++row)
+    {
+        for (int col = 0; col < m_game->Cols(); ++col)
+        {
+            // Выстрелы viewer по полю противника и выстрелы противника по его полю
+            auto enemyCell = static_cast<SeaBattle::CellState>(m_game->Cell(opponent, row, col));
+            if (enemyCell != SeaBattle::CellState::Empty && enemyCell != SeaBattle::CellState::Ship)
+            {
+                m_cellUpdateCallback(viewer, row, col, enemyCell);
+            }
+            auto ownCell = static_cast<SeaBattle::CellState>(m_game->Cell(viewer, row, col));
+            if (ownCell != SeaBattle::CellState::Empty && ownCell != SeaBattle::CellState::Ship)
+            {
+                m_cellUpdateCallback(opponent, row, col, ownCell);
+            }
+        }
+    }
+}
+
+void LocalModel::notifyNames()
+{
+    if (m_playerNamesCallback)
+    {
+        m_playerNamesCallback(GetLocalPlayerName(), GetOpponentName());
+    }
+}
+
+void LocalModel::saveRecord()
+{
+    if (m_recordPath.empty())
+        return;
+
+    std::string error;
+    if (!ReplayGame::Save(m_recordPath, m_names, *m_game, error))
+    {
+        std::cerr << "[client] failed to save replay: " << error << std::endl;
+    }
+}
+
+std::shared_ptr<const std::vector<SeaBattle::Ship>> LocalModel::GetPlayerShips(int player) const
+{
+    // Как и у сетевой модели, корабли видны только локальному игроку
+    if (m_game && player == GetLocalPlayer())
+    {
+        return m_ships[player];
+    }
+
+    static const auto empty = std::make_shared<const std::vector<SeaBattle::Ship>>();
+    return empty;
+}
+
+int LocalModel::GetCurrentPlayer() const
+{
+    if (!m_game)
+        return 0;
+    return m_game->CurrentPlayer();
+}
+
+int LocalModel::GetLocalPlayer() const
+{
+    return m_viewer;
+}
+
+SeaBattle::GameState LocalModel::GetGameState() const
+{
+    if (!m_game)
+        return SeaBattle::GameState::Welcome;
+    // Нумерация состояний совпадает с серверной (см. LocalGame.h)
+    return static_cast<SeaBattle::GameState>(m_game->State());
+}
+
+int LocalModel::GetBoardRows() const
+{
+    if (!m_game)
+        return 10;
+    return m_game->Rows();
+}
+
+int LocalModel::GetBoardCols() const
+{
+    if (!m_game)
+        return 10;
+    return m_game->Cols();
+}
+
+void LocalModel::SetPlayerName(const std::string& name)
+{
+    m_names[0] = name;
+}
+
+std::string LocalModel::GetLocalPlayerName() const
+{
+    return m_names[m_viewer];
+}
+
+std::string LocalModel::GetOpponentName() const
+{
+    return m_names[1 - m_viewer];
+}
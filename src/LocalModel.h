@@ -0,0 +1,82 @@
+#pragma once
+
+#include "IModel.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+class LocalGame;
+
+// Партия в том же процессе, без сервера: против встроенного бота или вдвоём за одним
+// компьютером (hot-seat). Колбэки вызываются синхронно внутри StartGame и ProcessShot.
+class LocalModel : public SeaBattle::IModel
+{
+public:
+    using CellUpdateCallback = std::function<void(int player, int row, int col, SeaBattle::CellState state)>;
+    using PlayerSwitchCallback = std::function<void(int newPlayer)>;
+    using GameOverCallback = std::function<void(bool)>;
+    using StatusCallback = std::function<void(SeaBattle::ConnectionStatus status)>;
+    using GameReadyCallback = std::function<void()>;
+    using PlayerNamesCallback = std::function<void(const std::string& localName, const std::string& opponentName)>;
+    using LocalPlayerCallback = std::function<void(int localPlayer)>;
+
+    // botStrategy - стратегия бота ("random", "hunt", "parity", "density", "endgame");
+    // пустая строка - hot-seat, оба игрока за этим компьютером
+    explicit LocalModel(std::string botStrategy);
+    ~LocalModel() override;
+
+    void PrepareGame() override {}
+    void CancelPrepare() override {}
+    void StartGame() override;
+    bool ProcessShot(int row, int col) override;
+
+    std::shared_ptr<const std::vector<SeaBattle::Ship>> GetPlayerShips(int player) const override;
+    int GetCurrentPlayer() const override;
+    int GetLocalPlayer() const override;
+    SeaBattle::GameState GetGameState() const override;
+    int GetBoardRows() const override;
+    int GetBoardCols() const override;
+
+    void SetPlayerName(const std::string& name) override;
+    std::string GetLocalPlayerName() const override;
+    std::string GetOpponentName() const override;
+
+    void setCellUpdateCallback(CellUpdateCallback callback) { m_cellUpdateCallback = callback; }
+    void setPlayerSwitchCallback(PlayerSwitchCallback callback) { m_playerSwitchCallback = callback; }
+    void setGameOverCallback(GameOverCallback callback) { m_gameOverCallback = callback; }
+    void setStatusCallback(StatusCallback callback) { m_statusCallback = callback; }
+    void setGameReadyCallback(GameReadyCallback callback) { m_gameReadyCallback = callback; }
+    void setPlayerNamesCallback(PlayerNamesCallback callback) { m_playerNamesCallback = callback; }
+    // Hot-seat: ход перешёл к другому игроку, поля нужно очистить и показать с его стороны.
+    // Обстрелянные клетки затем приходят заново через колбэк клетки.
+    void setLocalPlayerCallback(LocalPlayerCallback callback) { m_localPlayerCallback = callback; }
+
+    // Файл для записи партии (ReplayGame), сохраняется по окончании игры; пустой - не записывать
+    void setRecordPath(std::string path) { m_recordPath = std::move(path); }
+
+private:
+    // false - выстрел недопустим
+    bool applyShot(int player, int row, int col);
+    void playBotTurns();
+    void replayShots(int viewer);
+    void notifyNames();
+    void saveRecord();
+
+    static constexpr int BotPlayer = 1;
+
+    std::unique_ptr<LocalGame> m_game;
+    std::string m_botStrategy;
+    std::array<std::string, 2> m_names;
+    std::array<std::shared_ptr<const std::vector<SeaBattle::Ship>>, 2> m_ships;
+    int m_viewer = 0;
+    std::string m_recordPath;
+
+    CellUpdateCallback m_cellUpdateCallback;
+    PlayerSwitchCallback m_playerSwitchCallback;
+    GameOverCallback m_gameOverCallback;
+    StatusCallback m_statusCallback;
+    GameReadyCallback m_gameReadyCallback;
+    PlayerNamesCallback m_playerNamesCallback;
+    LocalPlayerCallback m_localPlayerCallback;
+};
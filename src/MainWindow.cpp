@@ -5,7 +5,13 @@
 #include "WaitingScreen.h"
 #include "WelcomeScreen.h"
 
+#include "Trace.h"
+
+#include "StartupTiming.h"
+
+#include <QEvent>
 #include <QStackedWidget>
+#include <QTimer>
 
 MainWindow::MainWindow(SeaBattle::IModel& model, QWidget* parent)
     : QMainWindow(parent)
@@ -17,20 +23,16 @@ MainWindow::MainWindow(SeaBattle::IModel& model, QWidget* parent)
     m_stackedWidget = new QStackedWidget(this);
     setCentralWidget(m_stackedWidget);
 
-    // Создаем экраны
+    // Сразу создаётся только экран приветствия. Игровой экран (два поля, больше двухсот
+    // виджетов) и экран ожидания достраиваются после первого кадра или по первому запросу.
     m_welcomeScreen = new WelcomeScreen();
-    m_waitingScreen = new WaitingScreen();
-    m_gameScreen = new GameScreen();
-
     m_stackedWidget->addWidget(m_welcomeScreen);
-    m_stackedWidget->addWidget(m_waitingScreen);
-    m_stackedWidget->addWidget(m_gameScreen);
 
     // Подключаем сигналы
     connect(m_welcomeScreen, &WelcomeScreen::startGameRequested, this, &MainWindow::showWaitingScreen);
-    connect(m_gameScreen, &GameScreen::returnToMainMenu, this, &MainWindow::showWelcomeScreen);
-    connect(m_gameScreen, &GameScreen::cellClicked, this, &MainWindow::onCellClicked);
-    connect(m_gameScreen, &GameScreen::exitGameRequested, this, &MainWindow::onExitGameRequested);
+    // Соединение с сервером открывается, пока игрок вводит имя, и закрывается, если он передумал
+    connect(m_welcomeScreen, &WelcomeScreen::nameEntryStarted, this, [this]() { m_gameModel.PrepareGame(); });
+    connect(m_welcomeScreen, &WelcomeScreen::nameEntryCancelled, this, [this]() { m_gameModel.CancelPrepare(); });
 }
 
 MainWindow::~MainWindow()
@@ -41,8 +43,64 @@ MainWindow::~MainWindow()
     }
 }
 
+void MainWindow::setReplayControls(QWidget* controls)
+{
+    m_replayControls = controls;
+    if (m_gameScreen)
+    {
+        m_gameScreen->setReplayControls(controls);
+    }
+    else
+    {
+        // До встраивания панель принадлежит окну, но не видна
+        controls->setParent(this);
+        controls->hide();
+    }
+}
+
+bool MainWindow::event(QEvent* event)
+{
+    bool result = QMainWindow::event(event);
+    if (event->type() == QEvent::Paint && !m_firstFramePainted)
+    {
+        m_firstFramePainted = true;
+        // Таймер срабатывает, когда первый кадр уже выведен: остальные экраны строятся,
+        // пока игрок вводит имя, и не задерживают появление окна
+        QTimer::singleShot(0, this, [this]() {
+            StartupTiming::Mark("first frame");
+            ensureGameScreens();
+            StartupTiming::Mark("game screens built");
+        });
+    }
+    return result;
+}
+
+void MainWindow::ensureGameScreens()
+{
+    if (m_gameScreen)
+    {
+        return;
+    }
+
+    m_waitingScreen = new WaitingScreen();
+    m_gameScreen = new GameScreen();
+
+    m_stackedWidget->addWidget(m_waitingScreen);
+    m_stackedWidget->addWidget(m_gameScreen);
+
+    connect(m_gameScreen, &GameScreen::returnToMainMenu, this, &MainWindow::showWelcomeScreen);
+    connect(m_gameScreen, &GameScreen::cellClicked, this, &MainWindow::onCellClicked);
+    connect(m_gameScreen, &GameScreen::exitGameRequested, this, &MainWindow::onExitGameRequested);
+
+    if (m_replayControls)
+    {
+        m_gameScreen->setReplayControls(m_replayControls);
+    }
+}
+
 void MainWindow::showWaitingScreen(const QString& playerName)
 {
+    ensureGameScreens();
     m_stackedWidget->setCurrentWidget(m_waitingScreen);
     m_waitingScreen->setStatusWaiting();
     
@@ -69,6 +127,9 @@ void MainWindow::showWaitingScreen(const QString& playerName)
 void MainWindow::showGameScreen()
 {
     m_stackedWidget->setCurrentWidget(m_gameScreen);
+
+    // Размер поля известен только после ответа сервера о выбранном варианте игры
+    m_gameScreen->setBoardSize(m_gameModel.GetBoardRows(), m_gameModel.GetBoardCols());
     
     // Устанавливаем локального игрока и текущего игрока в GameScreen
     m_gameScreen->setLocalPlayer(m_gameModel.GetLocalPlayer());
@@ -91,6 +152,21 @@ void MainWindow::onStatusUpdate(SeaBattle::ConnectionStatus status)
     {
         m_waitingScreen->setStatusLoading();
     }
+    else if (status == SeaBattle::ConnectionStatus::Evicted)
+    {
+        // Игрок мог уже уйти к приветствию после конца партии - тогда сообщать не о чем
+        if (m_stackedWidget->currentWidget() == m_welcomeScreen)
+        {
+            return;
+        }
+        onExitGameRequested();
+
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Соединение закрыто");
+        msgBox.setText("Сервер закрыл комнату: партия слишком долго простаивала.");
+        msgBox.addButton("Продолжить", QMessageBox::AcceptRole);
+        msgBox.exec();
+    }
 }
 
 void MainWindow::onGameReady()
@@ -103,6 +179,22 @@ void MainWindow::onPlayerNamesReceived(const QString& localName, const QString&
     m_gameScreen->setPlayerNames(localName, opponentName);
 }
 
+void MainWindow::onRoundTripMeasured(double milliseconds)
+{
+    m_gameScreen->setRoundTripTime(milliseconds);
+}
+
+void MainWindow::onShotRejected(int row, int col)
+{
+    BattleField* enemyField = m_gameScreen->getPlayer2Field();
+    enemyField->clearPending(row, col);
+    if (m_gameModel.GetCurrentPlayer() == m_gameModel.GetLocalPlayer()
+        && m_gameModel.GetGameState() == SeaBattle::GameState::Playing)
+    {
+        enemyField->enableUnshotCells();
+    }
+}
+
 void MainWindow::showWelcomeScreen()
 {
     m_stackedWidget->setCurrentWidget(m_welcomeScreen);
@@ -113,35 +205,30 @@ void MainWindow::showWelcomeScreen()
 
 void MainWindow::onCellClicked(int player, int row, int col)
 {
-    // Текущий игрок до выстрела
-    int before = m_gameModel.GetCurrentPlayer();
-    if (player != before)
-    {
-        return;
-    }
-
-    bool hit = m_gameModel.ProcessShot(row, col);
+    SeaBattle::Trace::Span span("MainWindow::onCellClicked");
 
-    // Если попадание и игра не окончена — разрешаем ОСТАВШИЕСЯ незастреленные клетки на поле противника
-    if (hit && m_gameModel.GetGameState() == SeaBattle::GameState::Playing)
+    if (player != m_gameModel.GetCurrentPlayer())
     {
-        // m_player2Field - всегда поле противника
-        m_gameScreen->getPlayer2Field()->enableUnshotCells();
         return;
     }
 
-    // Если промах — игрок сменится через колбэк, и нужное поле активируется в GameScreen
-    // Если выстрел недопустим (клик по уже обстрелянной клетке), модель вернет false и игрок НЕ сменится
-    int after = m_gameModel.GetCurrentPlayer();
-    if (after == before && m_gameModel.GetGameState() == SeaBattle::GameState::Playing)
+    // Клетка помечается до выстрела: сетевая модель отправляет его, не дожидаясь сервера, и ответ
+    // заменит отметку (onCellUpdated) или откатит её (onShotRejected), а локальная модель вызывает
+    // колбэки прямо внутри ProcessShot. m_player2Field - всегда поле противника; до ответа новых выстрелов нет
+    BattleField* enemyField = m_gameScreen->getPlayer2Field();
+    enemyField->markPending(row, col);
+    enemyField->disableAllCells();
+
+    if (!m_gameModel.ProcessShot(row, col))
     {
-        // Недопустимый выстрел: возвращаем доступ к незастреленным клеткам поля противника
-        m_gameScreen->getPlayer2Field()->enableUnshotCells();
+        enemyField->clearPending(row, col);
+        enemyField->enableUnshotCells();
     }
 }
 
 void MainWindow::onCellUpdated(int player, int row, int col, SeaBattle::CellState state)
 {
+    SeaBattle::Trace::Span span("MainWindow::onCellUpdated");
     m_gameScreen->onCellUpdated(player, row, col, state);
 }
 
@@ -152,6 +239,14 @@ void MainWindow::onPlayerSwitched(int newPlayer)
     refreshShipOverlaysForCurrentPlayer();
 }
 
+void MainWindow::onLocalPlayerChanged(int localPlayer)
+{
+    // Hot-seat: поля перерисовываются со стороны игрока, к которому перешёл ход
+    m_gameScreen->setLocalPlayer(localPlayer);
+    m_gameScreen->getPlayer1Field()->clearAll();
+    m_gameScreen->getPlayer2Field()->clearAll();
+}
+
 void MainWindow::onGameOver(bool win)
 {
     m_gameScreen->onGameOver(win);
@@ -181,17 +276,17 @@ void MainWindow::refreshShipOverlaysForCurrentPlayer()
     int localPlayer = m_gameModel.GetLocalPlayer();
 
     // Получаем корабли локального игрока
-    const auto& localShips = m_gameModel.GetPlayerShips(localPlayer);
+    const auto localShips = m_gameModel.GetPlayerShips(localPlayer);
 
     // m_player1Field - всегда "Ваше поле", поэтому корабли рисуем там
     BattleField* ownField = m_gameScreen->getPlayer1Field();
 
     // Наносим зелёные метки для своих кораблей
-    for (const auto& ship : localShips)
+    for (const auto& ship : *localShips)
     {
         for (const auto& pos : ship.positions)
         {
-            ownField->markShip(pos.first, pos.second);
+            ownField->markShip(pos.row, pos.col);
         }
     }
 }
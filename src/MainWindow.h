@@ -17,6 +17,9 @@ public:
     MainWindow(SeaBattle::IModel& model, QWidget* parent = nullptr);
     ~MainWindow() override;
 
+    // Панель просмотра записи; встраивается в игровой экран, когда он будет создан
+    void setReplayControls(QWidget* controls);
+
 public slots:
     void onCellUpdated(int player, int row, int col, SeaBattle::CellState state);
     void onPlayerSwitched(int newPlayer);
@@ -24,6 +27,9 @@ public slots:
     void onStatusUpdate(SeaBattle::ConnectionStatus status);
     void onGameReady();
     void onPlayerNamesReceived(const QString& localName, const QString& opponentName);
+    void onRoundTripMeasured(double milliseconds);
+    void onShotRejected(int row, int col);
+    void onLocalPlayerChanged(int localPlayer);
 
 private slots:
     void showWaitingScreen(const QString& playerName);
@@ -32,7 +38,12 @@ private slots:
     void onCellClicked(int player, int row, int col);
     void onExitGameRequested(); // Обработчик запроса на выход из игры
 
+protected:
+    bool event(QEvent* event) override;
+
 private:
+    // Создаёт экраны ожидания и игры, если их ещё нет
+    void ensureGameScreens();
     void updateBattleFields();
     void showTurnMessage(int player);
     void refreshShipOverlaysForCurrentPlayer();
@@ -40,8 +51,10 @@ private:
 private:
     QStackedWidget* m_stackedWidget;
     WelcomeScreen* m_welcomeScreen;
-    WaitingScreen* m_waitingScreen;
-    GameScreen* m_gameScreen;
+    WaitingScreen* m_waitingScreen = nullptr;
+    GameScreen* m_gameScreen = nullptr;
+    QWidget* m_replayControls = nullptr;
     SeaBattle::IModel& m_gameModel;
     std::unique_ptr<std::thread> m_connectionThread;
+    bool m_firstFramePainted = false;
 };
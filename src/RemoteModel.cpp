@@ -1,11 +1,16 @@
 #include "RemoteModel.h"
 
+#include "Trace.h"
+
 #include <boost/asio/as_tuple.hpp>
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/co_spawn.hpp>
-#include <boost/asio/connect.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
 
@@ -14,10 +19,51 @@
 #include <atomic>
 #include <future>
 #include <mutex>
+#include <optional>
+#include <string_view>
 #include <thread>
-#include <condition_variable>
 #include <boost/asio/thread_pool.hpp>
 
+namespace
+{
+    // Разбор Location вида ws://host:port/target
+    bool parseLocation(const std::string& location, std::string& host, unsigned short& port, std::string& target)
+    {
+        constexpr std::string_view scheme = "ws://";
+        if (location.compare(0, scheme.size(), scheme) != 0)
+        {
+            return false;
+        }
+        auto hostStart = scheme.size();
+        auto pathStart = location.find('/', hostStart);
+        auto colon = location.rfind(':', pathStart);
+        if (pathStart == std::string::npos || colon == std::string::npos || colon < hostStart)
+        {
+            return false;
+        }
+        host = location.substr(hostStart, colon - hostStart);
+        port = static_cast<unsigned short>(std::stoi(location.substr(colon + 1, pathStart - colon - 1)));
+        target = location.substr(pathStart);
+        return true;
+    }
+}
+
+// Неизменяемый срез состояния клиента. Поток сети публикует новый срез целиком,
+// GUI читает текущий без блокировок и всегда видит согласованные поля.
+struct ClientState
+{
+    int currentPlayer = 0;
+    int localPlayer = 0;
+    SeaBattle::GameState gameState = SeaBattle::GameState::Welcome;
+    int winner = -1;
+    int boardRows = 10;
+    int boardCols = 10;
+    // Флот меняется только до начала игры, срезы после выстрелов делят один вектор
+    std::shared_ptr<const std::vector<SeaBattle::Ship>> ships = std::make_shared<const std::vector<SeaBattle::Ship>>();
+    std::string localPlayerName;
+    std::string opponentName;
+};
+
 class Client
 {
 public:
@@ -26,56 +72,108 @@ public:
     using GameOverCallback = std::function<void(bool)>;
     using StatusCallback = std::function<void(SeaBattle::ConnectionStatus status)>;
     using PlayerNamesCallback = std::function<void(const std::string& localName, const std::string& opponentName)>;
+    using RoundTripCallback = std::function<void(double milliseconds)>;
+    using ShotRejectedCallback = std::function<void(int row, int col)>;
 
-    Client()
+    // socketPath - unix-сокет сервера на этой машине; пустой - TCP на 127.0.0.7:1365
+    explicit Client(std::string socketPath = {})
         : m_ws(m_ioc)
+        , m_socketPath(std::move(socketPath))
     {
     }
-    ~Client() = default;
+    ~Client()
+    {
+        // Корутины чтения и ping держат ссылки на сокет: закрываем его в потоке m_ioc и ждём,
+        // пока они завершатся, и только потом разрушаем члены класса
+        m_running.store(false);
+        boost::asio::post(m_ioc, [this]() {
+            m_keepAliveStop = true;
+            m_keepAliveTimer.cancel();
+            boost::system::error_code ec;
+            m_ws.next_layer().close(ec);
+        });
+        m_ioc.join();
+    }
 
     void setPlayerSwitchCallback(PlayerSwitchCallback callback) { m_playerSwitchCallback = callback; }
     void setCellUpdateCallback(CellUpdateCallback callback) { m_cellUpdateCallback = callback; }
     void setGameOverCallback(GameOverCallback callback) { m_gameOverCallback = callback; }
     void setStatusCallback(StatusCallback callback) { m_statusCallback = callback; }
     void setPlayerNamesCallback(PlayerNamesCallback callback) { m_playerNamesCallback = callback; }
+    void setRoundTripCallback(RoundTripCallback callback) { m_roundTripCallback = callback; }
+    void setShotRejectedCallback(ShotRejectedCallback callback) { m_shotRejectedCallback = callback; }
 
     void setPlayerName(const std::string& name) { m_playerName = name; }
 
-    bool connect()
+    // Подключение (TCP или unix-сокет) и рукопожатие WebSocket. Места в очереди подбора
+    // соединение ещё не занимает - его сервер даёт в ответ на имя (send_name)
+    boost::asio::awaitable<bool> open_async()
+    {
+        try
+        {
+            if (!m_socketPath.empty())
+            {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+                co_await m_ws.next_layer().async_connect(boost::asio::local::stream_protocol::endpoint(m_socketPath), boost::asio::use_awaitable);
+                co_await m_ws.async_handshake("localhost", "/", boost::asio::use_awaitable);
+#else
+                co_return false;
+#endif
+            }
+            else
+            {
+                const boost::asio::ip::tcp::endpoint server(boost::asio::ip::make_address("127.0.0.7"), 1365);
+                co_await m_ws.next_layer().async_connect(server, boost::asio::use_awaitable);
+                co_await m_ws.async_handshake("127.0.0.7", "/", boost::asio::use_awaitable);
+            }
+            co_return true;
+        }
+        catch (...)
+        {
+            co_return false;
+        }
+    }
+
+    // Имя игрока - он подтвердил игру: сервер сажает его в комнату и отвечает hello с номером
+    // игрока. Если соперник ждёт в комнате другого процесса сервера, ответ - ошибка
+    // room_elsewhere с его адресом: там место даётся при подключении, имя отправляется снова
+    bool send_name()
     {
         return run_sync<bool>(
             [this]() -> boost::asio::awaitable<bool>
             {
                 try
                 {
-                    auto executor = co_await boost::asio::this_coro::executor;
-                    boost::asio::ip::tcp::resolver resolver(executor);
-                    auto const results = co_await resolver.async_resolve("127.0.0.7", "1365", boost::asio::use_awaitable);
-
-                    co_await boost::asio::async_connect(m_ws.next_layer(), results, boost::asio::use_awaitable);
-                    co_await m_ws.async_handshake("127.0.0.7", "/", boost::asio::use_awaitable);
+                    const std::string setNameReq = nlohmann::json{
+                        {"type", "set_name"},
+                        {"name", m_playerName}
+                    }.dump();
+                    co_await m_ws.async_write(boost::asio::buffer(setNameReq), boost::asio::use_awaitable);
+                    nlohmann::json reply = co_await read_message();
 
-                    // Read hello message from server to get assigned player index
-                    boost::beast::flat_buffer buffer;
-                    auto [ec, bytes] = co_await m_ws.async_read(buffer, boost::asio::as_tuple(boost::asio::use_awaitable));
-                    if (!ec)
+                    if (reply.value("type", "") == "error" && reply.value("message", "") == "room_elsewhere")
                     {
-                        std::string msg{ boost::beast::buffers_to_string(buffer.data()) };
-                        nlohmann::json hello = nlohmann::json::parse(msg, nullptr, false);
-                        if (hello.is_object() && hello.value("type", "") == "hello")
-                        {
-                            std::lock_guard<std::mutex> lock(m_stateMutex);
-                            m_localPlayer = hello.value("player", 0);
-                        }
+                        std::string host;
+                        unsigned short port = 0;
+                        std::string target;
+                        if (!parseLocation(reply.value("location", ""), host, port, target))
+                            co_return false;
+                        // Сервер уже закрывает соединение: отвечаем на close, иначе поток останется открытым
+                        co_await m_ws.async_close(boost::beast::websocket::close_code::normal, boost::asio::as_tuple(boost::asio::use_awaitable));
+                        boost::system::error_code ignored;
+                        m_ws.next_layer().close(ignored);
+                        const boost::asio::ip::tcp::endpoint owner(boost::asio::ip::make_address(host), port);
+                        co_await m_ws.next_layer().async_connect(owner, boost::asio::use_awaitable);
+                        co_await m_ws.async_handshake(host, target, boost::asio::use_awaitable);
+                        reply = co_await read_message();
+                        co_await m_ws.async_write(boost::asio::buffer(setNameReq), boost::asio::use_awaitable);
                     }
 
-                    // Send player name to server
-                    nlohmann::json setNameReq{
-                        {"type", "set_name"},
-                        {"name", m_playerName}
-                    };
-                    co_await m_ws.async_write(boost::asio::buffer(setNameReq.dump()), boost::asio::use_awaitable);
-
+                    if (reply.value("type", "") != "hello")
+                        co_return false;
+                    update_state([&reply](ClientState& state) {
+                        state.localPlayer = reply.value("player", 0);
+                    });
                     co_return true;
                 }
                 catch (...)
@@ -85,6 +183,60 @@ public:
             });
     }
 
+    bool connect()
+    {
+        return run_sync<bool>([this]() { return open_async(); }) && send_name();
+    }
+
+    // Соединение в фоне, пока игрок вводит имя. Пока соединение не нужно, раз в
+    // KeepAlivePeriod уходит ping: сервер закрывает молчащие соединения по idle timeout.
+    void prewarm()
+    {
+        std::promise<bool> opened;
+        m_prewarmOpened = opened.get_future();
+        std::promise<void> done;
+        m_keepAliveDone = done.get_future();
+
+        boost::asio::co_spawn(
+            m_ioc,
+            [this, opened = std::move(opened), done = std::move(done)]() mutable -> boost::asio::awaitable<void>
+            {
+                bool ok = co_await open_async();
+                opened.set_value(ok);
+                while (ok && !m_keepAliveStop)
+                {
+                    m_keepAliveTimer.expires_after(KeepAlivePeriod);
+                    co_await m_keepAliveTimer.async_wait(boost::asio::as_tuple(boost::asio::use_awaitable));
+                    if (m_keepAliveStop)
+                        break;
+                    auto [ec] = co_await m_ws.async_ping({}, boost::asio::as_tuple(boost::asio::use_awaitable));
+                    if (ec)
+                    {
+                        m_prewarmBroken = true;
+                        break;
+                    }
+                }
+                done.set_value();
+            },
+            [](std::exception_ptr) {});
+    }
+
+    // Дожидается фонового соединения и останавливает ping (дальше соединение занято игрой).
+    // false - соединиться не удалось или оно уже разорвано, нужен новый Client.
+    bool finish_prewarm()
+    {
+        if (!m_prewarmOpened.valid() || !m_prewarmOpened.get())
+            return false;
+
+        boost::asio::post(m_ioc, [this]() {
+            m_keepAliveStop = true;
+            m_keepAliveTimer.cancel();
+        });
+        // Ping в полёте нельзя смешивать с другими записями в сокет
+        m_keepAliveDone.wait();
+        return !m_prewarmBroken && send_name();
+    }
+
     bool request_state()
     {
         return run_sync<bool>(
@@ -105,35 +257,45 @@ public:
                     if (!resp.is_object())
                         co_return false;
 
-                    std::lock_guard<std::mutex> lock(m_stateMutex);
-                    m_currentPlayer = resp.value("currentPlayer", 0);
-                    m_gameState = static_cast<SeaBattle::GameState>(resp.value("gameState", 0));
-                    
-                    if (resp.contains("ships") && resp["ships"].is_array())
-                    {
-                        m_ships.clear();
-                        for (const auto& shipJson : resp["ships"])
+                    update_state([&resp](ClientState& state) {
+                        state.currentPlayer = resp.value("currentPlayer", 0);
+                        state.gameState = static_cast<SeaBattle::GameState>(resp.value("gameState", 0));
+                        state.boardRows = resp.value("rows", state.boardRows);
+                        state.boardCols = resp.value("cols", state.boardCols);
+
+                        if (resp.contains("ships") && resp["ships"].is_array())
                         {
-                            SeaBattle::ShipType type = static_cast<SeaBattle::ShipType>(shipJson.value("type", 1));
-                            bool isVertical = shipJson.value("isVertical", false);
-                            if (shipJson.contains("positions") && shipJson["positions"].is_array() && !shipJson["positions"].empty())
+                            std::vector<SeaBattle::Ship> ships;
+                            for (const auto& shipJson : resp["ships"])
                             {
-                                int startRow = shipJson["positions"][0].value("row", 0);
-                                int startCol = shipJson["positions"][0].value("col", 0);
-                                m_ships.emplace_back(type, startRow, startCol, isVertical);
+                                SeaBattle::ShipType type = static_cast<SeaBattle::ShipType>(shipJson.value("type", 1));
+                                bool isVertical = shipJson.value("isVertical", false);
+                                if (shipJson.contains("positions") && shipJson["positions"].is_array() && !shipJson["positions"].empty())
+                                {
+                                    int startRow = shipJson["positions"][0].value("row", 0);
+                                    int startCol = shipJson["positions"][0].value("col", 0);
+                                    ships.emplace_back(type, startRow, startCol, isVertical);
+                                }
                             }
+                            state.ships = std::make_shared<const std::vector<SeaBattle::Ship>>(std::move(ships));
                         }
-                    }
 
-                    // Parse player names
-                    if (resp.contains("playerNames") && resp["playerNames"].is_array())
-                    {
-                        auto& names = resp["playerNames"];
-                        if (names.size() >= 2 && m_localPlayer >= 0 && m_localPlayer <= 1)
+                        // Parse player names
+                        if (resp.contains("playerNames") && resp["playerNames"].is_array())
                         {
-                            m_localPlayerName = names[m_localPlayer].get<std::string>();
-                            m_opponentName = names[1 - m_localPlayer].get<std::string>();
+                            auto& names = resp["playerNames"];
+                            if (names.size() >= 2 && state.localPlayer >= 0 && state.localPlayer <= 1)
+                            {
+                                state.localPlayerName = names[state.localPlayer].get<std::string>();
+                                state.opponentName = names[1 - state.localPlayer].get<std::string>();
+                            }
                         }
+                    });
+
+                    {
+                        auto current = state();
+                        std::lock_guard<std::mutex> lock(m_shotMutex);
+                        m_shotCells.assign(static_cast<std::size_t>(current->boardRows * current->boardCols), false);
                     }
                     
                     co_return true;
@@ -171,8 +333,8 @@ public:
                 // Notify about player names
                 if (m_playerNamesCallback)
                 {
-                    std::lock_guard<std::mutex> lock(m_stateMutex);
-                    m_playerNamesCallback(m_localPlayerName, m_opponentName);
+                    auto current = state();
+                    m_playerNamesCallback(current->localPlayerName, current->opponentName);
                 }
 
                 return true;
@@ -182,37 +344,62 @@ public:
         }
     }
 
-    // Отправка выстрела и ожидание результата через общий цикл чтения
+    // Отправка выстрела без ожидания ответа. Выстрел проверяется по известному состоянию
+    // и истории своих выстрелов; результат (или отказ сервера) приходит в цикл чтения.
+    // false - выстрел отклонён на месте и на сервер не ушёл.
     bool send_shot(int row, int col)
     {
-        // Отправляем запрос
-        auto sendResult = run_sync<bool>(
-            [this, row, col]() -> boost::asio::awaitable<bool>
+        // При включённой трассировке выстрел получает id, по которому сервер и утилита
+        // tracemerge связывают отрезки клиента и сервера
+        const std::uint64_t traceId = SeaBattle::Trace::Enabled() ? SeaBattle::Trace::NewTraceId() : 0;
+        {
+            std::lock_guard<std::mutex> shotLock(m_shotMutex);
+            // Пока предыдущий выстрел без ответа, неизвестно, сохранится ли ход
+            if (m_shotInFlight)
+                return false;
+
+            auto current = state();
+            if (current->gameState != SeaBattle::GameState::Playing || current->currentPlayer != current->localPlayer)
+                return false;
+            if (row < 0 || row >= current->boardRows || col < 0 || col >= current->boardCols)
+                return false;
+            const auto index = static_cast<std::size_t>(row * current->boardCols + col);
+            if (index >= m_shotCells.size() || m_shotCells[index])
+                return false;
+            m_shotCells[index] = true;
+
+            m_shotInFlight = true;
+            m_pendingShot = { row, col, std::chrono::steady_clock::now() };
+            m_roundTripSpan.emplace("Client::send_shot", traceId, SeaBattle::Trace::RoundTripCategory);
+        }
+
+        boost::asio::co_spawn(
+            m_ioc,
+            [this, row, col, traceId]() -> boost::asio::awaitable<void>
             {
-                try
+                SeaBattle::Trace::Span span("Client::write shot", traceId);
+                nlohmann::json req{
+                    {"type", "shot"},
+                    {"row", row},
+                    {"col", col},
+                };
+                if (traceId != 0)
                 {
-                    nlohmann::json req{
-                        {"type", "shot"},
-                        {"row", row},
-                        {"col", col},
-                    };
-                    co_await m_ws.async_write(boost::asio::buffer(req.dump()), boost::asio::use_awaitable);
-                    co_return true;
+                    req["trace"] = traceId;
+                    req["ts"] = SeaBattle::Trace::NowNs();
                 }
-                catch (...)
+                auto payload = req.dump();
+                auto [ec, bytes] = co_await m_ws.async_write(boost::asio::buffer(payload), boost::asio::as_tuple(boost::asio::use_awaitable));
+                if (ec)
                 {
-                    co_return false;
+                    // Ответа не будет - откатываем клетку
+                    finish_shot();
+                    reject_shot(row, col);
                 }
-            });
-
-        if (!sendResult)
-            return false;
+            },
+            [](std::exception_ptr) {});
 
-        // Ждём ответа через условную переменную
-        std::unique_lock<std::mutex> lock(m_shotMutex);
-        m_shotResultReady = false;
-        m_shotCV.wait(lock, [this]() { return m_shotResultReady; });
-        return m_lastShotHit;
+        return true;
     }
 
     // Запуск цикла чтения входящих сообщений
@@ -241,28 +428,59 @@ public:
                     
                     if (type == "shot_result")
                     {
-                        // Ответ на наш выстрел
+                        SeaBattle::Trace::Span span("Client::on shot_result", resp.value("trace", std::uint64_t{ 0 }));
+
+                        // Ответ на наш выстрел: сервер подтверждает или отклоняет уже показанную клетку
+                        bool accepted = resp.value("accepted", true);
                         bool hit = resp.value("hit", false);
+                        int newPlayer = resp.value("currentPlayer", 0);
+                        auto gameState = static_cast<SeaBattle::GameState>(resp.value("gameState", 0));
+
+                        auto previous = state();
+                        const int previousPlayer = previous->currentPlayer;
+                        const int localPlayer = previous->localPlayer;
+                        int winner = resp.contains("winner") ? resp.value("winner", -1) : previous->winner;
+                        update_state([&](ClientState& next) {
+                            next.currentPlayer = newPlayer;
+                            next.gameState = gameState;
+                            next.winner = winner;
+                        });
+
+                        // Следующий выстрел разрешается только после публикации нового хода:
+                        // иначе между ними send_shot видит старый срез и стреляет вне очереди
+                        PendingShot shot = finish_shot();
+                        if (m_roundTripCallback)
                         {
-                            std::lock_guard<std::mutex> lock(m_stateMutex);
-                            m_currentPlayer = resp.value("currentPlayer", 0);
-                            m_gameState = static_cast<SeaBattle::GameState>(resp.value("gameState", 0));
-                            if (resp.contains("winner"))
-                            {
-                                m_winner = resp.value("winner", -1);
-                            }
+                            m_roundTripCallback(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shot.sentAt).count());
+                        }
+
+                        int row = resp.value("row", shot.row);
+                        int col = resp.value("col", shot.col);
+
+                        if (!accepted)
+                        {
+                            reject_shot(row, col);
+                        }
+                        else if (m_cellUpdateCallback)
+                        {
+                            SeaBattle::CellState state = hit ? SeaBattle::CellState::Hit : SeaBattle::CellState::Miss;
+                            m_cellUpdateCallback(localPlayer, row, col, state);
+                        }
+
+                        if (m_playerSwitchCallback && previousPlayer != newPlayer)
+                        {
+                            m_playerSwitchCallback(newPlayer);
                         }
-                        
-                        // Разблокируем send_shot
+
+                        if (gameState == SeaBattle::GameState::GameOver && m_gameOverCallback)
                         {
-                            std::lock_guard<std::mutex> lock(m_shotMutex);
-                            m_lastShotHit = hit;
-                            m_shotResultReady = true;
+                            m_gameOverCallback(winner == localPlayer);
                         }
-                        m_shotCV.notify_one();
                     }
                     else if (type == "opponent_shot")
                     {
+                        SeaBattle::Trace::Span span("Client::on opponent_shot", resp.value("trace", std::uint64_t{ 0 }));
+
                         // Выстрел противника
                         int row = resp.value("row", -1);
                         int col = resp.value("col", -1);
@@ -270,17 +488,17 @@ public:
                         int newPlayer = resp.value("currentPlayer", 0);
                         auto gameState = static_cast<SeaBattle::GameState>(resp.value("gameState", 0));
 
-                        int previousPlayer;
-                        {
-                            std::lock_guard<std::mutex> lock(m_stateMutex);
-                            previousPlayer = m_currentPlayer;
-                            m_currentPlayer = newPlayer;
-                            m_gameState = gameState;
-                        }
+                        auto previous = state();
+                        const int previousPlayer = previous->currentPlayer;
+                        const int localPlayer = previous->localPlayer;
+                        update_state([&](ClientState& next) {
+                            next.currentPlayer = newPlayer;
+                            next.gameState = gameState;
+                        });
 
                         if (m_cellUpdateCallback)
                         {
-                            int opponent = 1 - local_player();
+                            int opponent = 1 - localPlayer;
                             SeaBattle::CellState state = hit ? SeaBattle::CellState::Hit : SeaBattle::CellState::Miss;
                             m_cellUpdateCallback(opponent, row, col, state);
                         }
@@ -294,7 +512,33 @@ public:
                         if (gameState == SeaBattle::GameState::GameOver && m_gameOverCallback)
                         {
                             int winner = resp.value("winner", -1);
-                            m_gameOverCallback(winner == m_localPlayer);
+                            m_gameOverCallback(winner == localPlayer);
+                        }
+                    }
+                    else if (type == "timeout")
+                    {
+                        // У игрока кончилось время: партия проиграна, проигравшего сервер отключает
+                        int winner = resp.value("winner", -1);
+                        const int localPlayer = state()->localPlayer;
+                        update_state([&](ClientState& next) {
+                            next.gameState = SeaBattle::GameState::GameOver;
+                            next.winner = winner;
+                        });
+                        if (m_gameOverCallback)
+                        {
+                            m_gameOverCallback(winner == localPlayer);
+                        }
+                    }
+                    else if (type == "evicted")
+                    {
+                        // Комната простаивала дольше срока сервера (--room-ttl) и закрыта, следом
+                        // сервер закрывает соединение. Недоигранная партия тоже кончается - без победителя
+                        update_state([](ClientState& next) {
+                            next.gameState = SeaBattle::GameState::GameOver;
+                        });
+                        if (m_statusCallback)
+                        {
+                            m_statusCallback(SeaBattle::ConnectionStatus::Evicted);
                         }
                     }
                 }
@@ -302,49 +546,73 @@ public:
             [](std::exception_ptr) {});
     }
 
-    int current_player() const
+    // Текущий срез состояния: без блокировок, срез не меняется, пока на него есть ссылка
+    std::shared_ptr<const ClientState> state() const
     {
-        std::lock_guard<std::mutex> lock(m_stateMutex);
-        return m_currentPlayer;
+        return m_state.load(std::memory_order_acquire);
     }
 
-    int local_player() const
-    {
-        std::lock_guard<std::mutex> lock(m_stateMutex);
-        return m_localPlayer;
-    }
+    int current_player() const { return state()->currentPlayer; }
+    int local_player() const { return state()->localPlayer; }
+    SeaBattle::GameState game_state() const { return state()->gameState; }
+    int winner() const { return state()->winner; }
+    int board_rows() const { return state()->boardRows; }
+    int board_cols() const { return state()->boardCols; }
 
-    SeaBattle::GameState game_state() const
+private:
+    struct PendingShot
     {
-        std::lock_guard<std::mutex> lock(m_stateMutex);
-        return m_gameState;
-    }
+        int row = -1;
+        int col = -1;
+        std::chrono::steady_clock::time_point sentAt;
+    };
 
-    int winner() const
+    // Следующее сообщение сервера; не JSON-объект - пустой объект
+    boost::asio::awaitable<nlohmann::json> read_message()
     {
-        std::lock_guard<std::mutex> lock(m_stateMutex);
-        return m_winner;
+        boost::beast::flat_buffer buffer;
+        co_await m_ws.async_read(buffer, boost::asio::use_awaitable);
+        nlohmann::json message = nlohmann::json::parse(boost::beast::buffers_to_string(buffer.data()), nullptr, false);
+        co_return message.is_object() ? message : nlohmann::json::object();
     }
 
-    const std::vector<SeaBattle::Ship>& ships() const
+    // Публикует новый срез: копия текущего, изменённая fn. Вызывается только из потока
+    // m_ioc, поэтому писатель один и хватает load + store без сравнения с обменом.
+    template <typename Fn>
+    void update_state(Fn fn)
     {
-        std::lock_guard<std::mutex> lock(m_stateMutex);
-        return m_ships;
+        auto next = std::make_shared<ClientState>(*m_state.load(std::memory_order_relaxed));
+        fn(*next);
+        m_state.store(std::move(next), std::memory_order_release);
     }
 
-    std::string local_player_name() const
+    // Снимает отметку "выстрел в полёте" и закрывает его отрезок трассы
+    PendingShot finish_shot()
     {
-        std::lock_guard<std::mutex> lock(m_stateMutex);
-        return m_localPlayerName;
+        std::lock_guard<std::mutex> lock(m_shotMutex);
+        m_shotInFlight = false;
+        m_roundTripSpan.reset();
+        return m_pendingShot;
     }
 
-    std::string opponent_name() const
+    // Выстрел не состоялся: клетку снова можно обстрелять, интерфейс откатывает отметку
+    void reject_shot(int row, int col)
     {
-        std::lock_guard<std::mutex> lock(m_stateMutex);
-        return m_opponentName;
+        {
+            auto current = state();
+            std::lock_guard<std::mutex> lock(m_shotMutex);
+            const auto index = static_cast<std::size_t>(row * current->boardCols + col);
+            if (row >= 0 && row < current->boardRows && col >= 0 && col < current->boardCols && index < m_shotCells.size())
+            {
+                m_shotCells[index] = false;
+            }
+        }
+        if (m_shotRejectedCallback)
+        {
+            m_shotRejectedCallback(row, col);
+        }
     }
 
-private:
     template <typename T, typename Fn>
     T run_sync(Fn fn)
     {
@@ -371,50 +639,96 @@ private:
         return fut.get();
     }
 
+    static constexpr auto KeepAlivePeriod = std::chrono::seconds(15);
+
     boost::asio::thread_pool m_ioc{ 1 };
-    boost::beast::websocket::stream<boost::asio::ip::tcp::socket> m_ws;
+    // Сокет без привязки к протоколу: тот же поток WebSocket поверх TCP и unix-сокета
+    boost::beast::websocket::stream<boost::asio::generic::stream_protocol::socket> m_ws;
+    std::string m_socketPath;
     std::atomic<bool> m_running{false};
 
-    mutable std::mutex m_stateMutex;
-    int m_currentPlayer = 0;
-    int m_localPlayer = 0;
-    SeaBattle::GameState m_gameState = SeaBattle::GameState::Welcome;
-    std::vector<SeaBattle::Ship> m_ships;
-    int m_winner = -1;
+    // Фоновое соединение (prewarm); флаги меняются только в потоке m_ioc
+    boost::asio::steady_timer m_keepAliveTimer{ m_ioc };
+    std::future<bool> m_prewarmOpened;
+    std::future<void> m_keepAliveDone;
+    bool m_keepAliveStop = false;
+    bool m_prewarmBroken = false;
+
+    std::atomic<std::shared_ptr<const ClientState>> m_state{ std::make_shared<const ClientState>() };
 
-    // Player names
     std::string m_playerName;
-    std::string m_localPlayerName;
-    std::string m_opponentName;
 
-    // Для синхронизации результата выстрела
+    // Выстрел, отправленный без ожидания ответа; одновременно в полёте не больше одного.
+    // Под m_shotMutex также история своих выстрелов.
     std::mutex m_shotMutex;
-    std::condition_variable m_shotCV;
-    bool m_shotResultReady = false;
-    bool m_lastShotHit = false;
+    // Клетки поля противника, по которым мы уже стреляли
+    std::vector<bool> m_shotCells;
+    bool m_shotInFlight = false;
+    PendingShot m_pendingShot;
+    std::optional<SeaBattle::Trace::Span> m_roundTripSpan;
 
     PlayerSwitchCallback m_playerSwitchCallback;
     CellUpdateCallback m_cellUpdateCallback;
     GameOverCallback m_gameOverCallback;
     StatusCallback m_statusCallback;
     PlayerNamesCallback m_playerNamesCallback;
+    RoundTripCallback m_roundTripCallback;
+    ShotRejectedCallback m_shotRejectedCallback;
 };
 
 RemoteModel::RemoteModel() = default;
 RemoteModel::~RemoteModel() = default;
 
+void RemoteModel::PrepareGame()
+{
+    std::lock_guard<std::mutex> lock(m_prewarmMutex);
+    if (m_prewarmed)
+        return;
+
+    m_prewarmed = std::make_unique<Client>(m_serverSocket);
+    m_prewarmed->prewarm();
+}
+
+void RemoteModel::CancelPrepare()
+{
+    // Соединение закрывается в деструкторе Client; места на сервере оно не занимало
+    std::lock_guard<std::mutex> lock(m_prewarmMutex);
+    m_prewarmed.reset();
+}
+
 void RemoteModel::StartGame()
 {
-    m_client = std::make_unique<Client>();
+    {
+        SeaBattle::Trace::Span span("RemoteModel::StartGame connect");
+
+        // Соединение, открытое заранее (PrepareGame), используется, если оно живо;
+        // иначе соединяемся, как раньше, после ввода имени
+        std::unique_ptr<Client> client;
+        {
+            std::lock_guard<std::mutex> lock(m_prewarmMutex);
+            client = std::move(m_prewarmed);
+        }
+        if (client)
+        {
+            client->setPlayerName(m_playerName);
+        }
+        if (!client || !client->finish_prewarm())
+        {
+            client = std::make_unique<Client>(m_serverSocket);
+            client->setPlayerName(m_playerName);
+            client->connect();
+        }
+        m_client = std::move(client);
+    }
     
     m_client->setPlayerSwitchCallback(m_playerSwitchCallback);
     m_client->setCellUpdateCallback(m_cellUpdateCallback);
     m_client->setGameOverCallback(m_gameOverCallback);
     m_client->setStatusCallback(m_statusCallback);
     m_client->setPlayerNamesCallback(m_playerNamesCallback);
-    m_client->setPlayerName(m_playerName);
+    m_client->setRoundTripCallback(m_roundTripCallback);
+    m_client->setShotRejectedCallback(m_shotRejectedCallback);
     
-    m_client->connect();
     m_client->wait_for_game_start();
     m_client->startListening();
     
@@ -430,38 +744,25 @@ bool RemoteModel::ProcessShot(int row, int col)
     if (!m_client)
         return false;
 
-    int localPlayer = m_client->local_player();
-    int previousPlayer = m_client->current_player();
-    const bool hit = m_client->send_shot(row, col);
-    int newPlayer = m_client->current_player();
+    SeaBattle::Trace::Span span("RemoteModel::ProcessShot");
 
-    if (m_cellUpdateCallback)
-    {
-        SeaBattle::CellState state = hit ? SeaBattle::CellState::Hit : SeaBattle::CellState::Miss;
-        m_cellUpdateCallback(localPlayer, row, col, state);
-    }
-
-    if (m_playerSwitchCallback && previousPlayer != newPlayer)
-    {
-        m_playerSwitchCallback(newPlayer);
-    }
-
-    if (m_gameOverCallback && m_client->game_state() == SeaBattle::GameState::GameOver)
-    {
-        m_gameOverCallback(m_client->winner() == localPlayer);
-    }
-
-    return hit;
+    // Не ждём сервера: результат придёт через колбэки клетки, смены хода и отказа
+    return m_client->send_shot(row, col);
 }
 
-const std::vector<SeaBattle::Ship>& RemoteModel::GetPlayerShips(int player) const
+std::shared_ptr<const std::vector<SeaBattle::Ship>> RemoteModel::GetPlayerShips(int player) const
 {
-    if (m_client && player == m_client->local_player())
+    if (m_client)
     {
-        return m_client->ships();
+        auto state = m_client->state();
+        if (player == state->localPlayer)
+        {
+            // Вектор флота в срезе не меняется: поток сети заменяет его целиком
+            return state->ships;
+        }
     }
-    
-    static std::vector<SeaBattle::Ship> empty;
+
+    static const auto empty = std::make_shared<const std::vector<SeaBattle::Ship>>();
     return empty;
 }
 
@@ -486,6 +787,20 @@ SeaBattle::GameState RemoteModel::GetGameState() const
     return m_client->game_state();
 }
 
+int RemoteModel::GetBoardRows() const
+{
+    if (!m_client)
+        return 10;
+    return m_client->board_rows();
+}
+
+int RemoteModel::GetBoardCols() const
+{
+    if (!m_client)
+        return 10;
+    return m_client->board_cols();
+}
+
 void RemoteModel::SetPlayerName(const std::string& name)
 {
     m_playerName = name;
@@ -495,9 +810,9 @@ std::string RemoteModel::GetLocalPlayerName() const
 {
     if (m_client)
     {
-        std::string clientName = m_client->local_player_name();
-        if (!clientName.empty())
-            return clientName;
+        auto state = m_client->state();
+        if (!state->localPlayerName.empty())
+            return state->localPlayerName;
     }
     return m_playerName;
 }
@@ -506,6 +821,6 @@ std::string RemoteModel::GetOpponentName() const
 {
     if (!m_client)
         return "";
-    return m_client->opponent_name();
+    return m_client->state()->opponentName;
 }
 
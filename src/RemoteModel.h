@@ -2,6 +2,11 @@
 
 #include "IModel.h"
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
 class Client;
 
 class RemoteModel : public SeaBattle::IModel
@@ -13,17 +18,27 @@ public:
     using StatusCallback = std::function<void(SeaBattle::ConnectionStatus status)>;
     using GameReadyCallback = std::function<void()>;
     using PlayerNamesCallback = std::function<void(const std::string& localName, const std::string& opponentName)>;
+    using RoundTripCallback = std::function<void(double milliseconds)>;
+    using ShotRejectedCallback = std::function<void(int row, int col)>;
 
     RemoteModel();
     ~RemoteModel() override;
 
+    // Путь к unix-сокету сервера на этой машине (server --unix-socket); пустой - TCP.
+    // Действует на следующее подключение
+    void SetServerSocket(std::string path) { m_serverSocket = std::move(path); }
+
+    void PrepareGame() override;
+    void CancelPrepare() override;
     void StartGame() override;
     bool ProcessShot(int row, int col) override;
 
-    const std::vector<SeaBattle::Ship>& GetPlayerShips(int player) const override;
+    std::shared_ptr<const std::vector<SeaBattle::Ship>> GetPlayerShips(int player) const override;
     int GetCurrentPlayer() const override;
     int GetLocalPlayer() const override;
     SeaBattle::GameState GetGameState() const override;
+    int GetBoardRows() const override;
+    int GetBoardCols() const override;
 
     // Player name support
     void SetPlayerName(const std::string& name) override;
@@ -36,10 +51,18 @@ public:
     void setStatusCallback(StatusCallback callback) { m_statusCallback = callback; }
     void setGameReadyCallback(GameReadyCallback callback) { m_gameReadyCallback = callback; }
     void setPlayerNamesCallback(PlayerNamesCallback callback) { m_playerNamesCallback = callback; }
+    // Время от отправки выстрела до ответа сервера, вызывается из потока GUI после каждого выстрела
+    void setRoundTripCallback(RoundTripCallback callback) { m_roundTripCallback = callback; }
+    // Сервер отклонил уже показанный выстрел, клетку нужно вернуть в исходный вид
+    void setShotRejectedCallback(ShotRejectedCallback callback) { m_shotRejectedCallback = callback; }
 
 private:
     std::unique_ptr<Client> m_client;
+    // Соединение, открытое в PrepareGame и ещё не занятое игрой
+    std::unique_ptr<Client> m_prewarmed;
+    std::mutex m_prewarmMutex;
     std::string m_playerName;
+    std::string m_serverSocket;
 
     CellUpdateCallback m_cellUpdateCallback;
     PlayerSwitchCallback m_playerSwitchCallback;
@@ -47,4 +70,6 @@ private:
     StatusCallback m_statusCallback;
     GameReadyCallback m_gameReadyCallback;
     PlayerNamesCallback m_playerNamesCallback;
+    RoundTripCallback m_roundTripCallback;
+    ShotRejectedCallback m_shotRejectedCallback;
 };
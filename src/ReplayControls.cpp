@@ -0,0 +1,132 @@
+#include "ReplayControls.h"
+
+#include "ReplayModel.h"
+
+#include <QComboBox>
+#include <QSlider>
+#include <QTimer>
+
+#include <cmath>
+
+ReplayControls::ReplayControls(ReplayModel& model, QWidget* parent)
+    : QWidget(parent)
+    , m_model(model)
+{
+    QHBoxLayout* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    m_playButton = new QPushButton("Пуск");
+    m_playButton->setStyleSheet("font-size: 14px; padding: 10px;");
+
+    m_slider = new QSlider(Qt::Horizontal);
+    m_slider->setRange(0, m_model.MoveCount());
+    m_slider->setMinimumWidth(300);
+
+    m_speedBox = new QComboBox();
+    for (double speed : { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0, 64.0 })
+    {
+        m_speedBox->addItem(QString("x%1").arg(speed), speed);
+    }
+    m_speedBox->setCurrentIndex(m_speedBox->findData(1.0));
+
+    m_positionLabel = new QLabel();
+    m_positionLabel->setStyleSheet("font-size: 14px; color: white;");
+    m_positionLabel->setMinimumWidth(220);
+
+    layout->addWidget(m_playButton);
+    layout->addWidget(m_slider, 1);
+    layout->addWidget(m_speedBox);
+    layout->addWidget(m_positionLabel);
+
+    m_timer = new QTimer(this);
+
+    connect(m_slider, &QSlider::valueChanged, this, &ReplayControls::onSliderMoved);
+    connect(m_playButton, &QPushButton::clicked, this, &ReplayControls::onPlayClicked);
+    connect(m_speedBox, &QComboBox::currentIndexChanged, this, &ReplayControls::onSpeedChanged);
+    connect(m_timer, &QTimer::timeout, this, &ReplayControls::onTick);
+
+    // Seek вызывает колбэк в потоке GUI, StartGame - в потоке подключения
+    m_model.setPositionCallback([this](int move) {
+        QMetaObject::invokeMethod(this, [this, move]() { showPosition(move); });
+        });
+    showPosition(0);
+}
+
+void ReplayControls::onSliderMoved(int move)
+{
+    // Ползунок двигает пользователь - воспроизведение останавливается
+    setPlaying(false);
+    m_model.Seek(move);
+}
+
+void ReplayControls::onPlayClicked()
+{
+    if (!m_timer->isActive() && m_model.Position() == m_model.MoveCount())
+    {
+        m_model.Seek(0);
+    }
+    setPlaying(!m_timer->isActive());
+}
+
+void ReplayControls::onSpeedChanged()
+{
+    if (m_timer->isActive())
+    {
+        // Новая скорость отсчитывается от текущей позиции
+        setPlaying(true);
+    }
+}
+
+void ReplayControls::onTick()
+{
+    const double elapsed = static_cast<double>(m_playClock.elapsed()) / 1000.0;
+    const int target = m_playFrom + static_cast<int>(std::floor(elapsed * movesPerSecond()));
+    m_model.Seek(target);
+    if (m_model.Position() >= m_model.MoveCount())
+    {
+        setPlaying(false);
+    }
+}
+
+void ReplayControls::setPlaying(bool playing)
+{
+    if (playing)
+    {
+        m_playFrom = m_model.Position();
+        m_playClock.start();
+        // Чаще кадра срабатывать незачем: переходы всё равно показываются раз за кадр
+        m_timer->start(std::max(FrameIntervalMs, static_cast<int>(1000.0 / movesPerSecond())));
+    }
+    else
+    {
+        m_timer->stop();
+    }
+    m_playButton->setText(playing ? "Пауза" : "Пуск");
+}
+
+double ReplayControls::movesPerSecond() const
+{
+    return BaseMovesPerSecond * m_speedBox->currentData().toDouble();
+}
+
+void ReplayControls::showPosition(int move)
+{
+    {
+        // Позицию уже выбрала модель - обратно в Seek её не отправляем
+        QSignalBlocker blocker(m_slider);
+        m_slider->setValue(move);
+    }
+
+    QString text = QString("Ход %1 из %2").arg(move).arg(m_model.MoveCount());
+    if (m_model.Winner() >= 0)
+    {
+        const bool localWon = m_model.Winner() == m_model.GetLocalPlayer();
+        text += QString(" - победил %1").arg(QString::fromStdString(localWon ? m_model.GetLocalPlayerName() : m_model.GetOpponentName()));
+    }
+    else if (move > 0)
+    {
+        const bool localShot = m_model.Shooter(move - 1) == m_model.GetLocalPlayer();
+        text += QString(" (стрелял %1)").arg(QString::fromStdString(localShot ? m_model.GetLocalPlayerName() : m_model.GetOpponentName()));
+    }
+    m_positionLabel->setText(text);
+}
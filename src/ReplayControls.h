@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QWidget>
+
+class QComboBox;
+class QLabel;
+class QPushButton;
+class QSlider;
+class QTimer;
+class ReplayModel;
+
+// Панель просмотра записи: ползунок позиции, воспроизведение и его скорость.
+// Воспроизведение считает позицию по прошедшему времени, а не по срабатываниям
+// таймера, поэтому скорость не ограничена частотой кадров: на больших скоростях
+// за кадр проходится несколько ходов одним переходом.
+class ReplayControls : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit ReplayControls(ReplayModel& model, QWidget* parent = nullptr);
+
+private slots:
+    void onSliderMoved(int move);
+    void onPlayClicked();
+    void onSpeedChanged();
+    void onTick();
+
+private:
+    void showPosition(int move);
+    void setPlaying(bool playing);
+    // Ходов в секунду при выбранной скорости
+    double movesPerSecond() const;
+
+    static constexpr double BaseMovesPerSecond = 2.0;
+    static constexpr int FrameIntervalMs = 16;
+
+    ReplayModel& m_model;
+    QPushButton* m_playButton;
+    QSlider* m_slider;
+    QComboBox* m_speedBox;
+    QLabel* m_positionLabel;
+    QTimer* m_timer;
+    // Отсчёт воспроизведения: позиция и время, от которых считается следующий ход
+    QElapsedTimer m_playClock;
+    int m_playFrom = 0;
+};
@@ -0,0 +1,219 @@
+#include "ReplayGame.h"
+
+#include "GameModel.h"
+#include "Replay.h"
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <optional>
+
+namespace
+{
+    constexpr int FormatVersion = 1;
+}
+
+struct ReplayGame::Impl
+{
+    std::array<std::string, 2> names;
+    std::array<std::vector<LocalGame::ShipInfo>, 2> ships;
+    std::optional<SeaBattle::Replay> replay;
+};
+
+ReplayGame::ReplayGame()
+    : m_impl(std::make_unique<Impl>())
+{
+}
+
+ReplayGame::~ReplayGame() = default;
+
+bool ReplayGame::Save(const std::string& path, const std::array<std::string, 2>& names, const LocalGame& game, std::string& error)
+{
+    nlohmann::json fleets = nlohmann::json::array();
+    for (int player = 0; player < 2; ++player)
+    {
+        nlohmann::json fleet = nlohmann::json::array();
+        for (const auto& ship : game.Ships(player))
+        {
+            fleet.push_back({ {"type", ship.size}, {"row", ship.row}, {"col", ship.col}, {"isVertical", ship.vertical} });
+        }
+        fleets.push_back(std::move(fleet));
+    }
+
+    nlohmann::json shots = nlohmann::json::array();
+    for (const auto& shot : game.History())
+    {
+        shots.push_back({ shot.player, shot.row, shot.col });
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    out << nlohmann::json{
+        {"version", FormatVersion},
+        {"names", names},
+        {"fleets", std::move(fleets)},
+        {"shots", std::move(shots)} }.dump() << std::endl;
+    if (!out)
+    {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool ReplayGame::Load(const std::string& path, std::string& error)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    nlohmann::json json = nlohmann::json::parse(in, nullptr, false);
+    if (json.is_discarded() || !json.is_object())
+    {
+        error = path + " is not valid JSON";
+        return false;
+    }
+    if (json.value("version", 0) != FormatVersion)
+    {
+        error = "unsupported replay version";
+        return false;
+    }
+
+    const auto& fleets = json.value("fleets", nlohmann::json::array());
+    const auto& shots = json.value("shots", nlohmann::json::array());
+    if (!fleets.is_array() || fleets.size() != 2 || !shots.is_array())
+    {
+        error = "replay must have two fleets and a list of shots";
+        return false;
+    }
+
+    // Начальная позиция: пустые поля, затем расстановки с той же проверкой, что и place_fleet
+    SeaBattle::GameModel start;
+    start.StartGame(SeaBattle::GameField{}, SeaBattle::GameField{});
+    std::array<std::vector<LocalGame::ShipInfo>, 2> ships;
+    for (int player = 0; player < 2; ++player)
+    {
+        std::vector<SeaBattle::ShipPlacement> placement;
+        for (const auto& ship : fleets[player])
+        {
+            if (!ship.is_object())
+            {
+                error = "fleet entry is not an object";
+                return false;
+            }
+            placement.push_back({ ship.value("type", 0), ship.value("row", -1), ship.value("col", -1), ship.value("isVertical", false) });
+            ships[player].push_back({ placement.back().size, placement.back().row, placement.back().col, placement.back().vertical });
+        }
+        SeaBattle::FleetError fleetError = start.PlaceFleet(player, placement);
+        if (fleetError != SeaBattle::FleetError::None)
+        {
+            error = "fleet of player " + std::to_string(player) + ": " + std::string(SeaBattle::ToString(fleetError));
+            return false;
+        }
+    }
+
+    std::vector<SeaBattle::ReplayShot> moves;
+    moves.reserve(shots.size());
+    for (const auto& shot : shots)
+    {
+        if (!shot.is_array() || shot.size() != 3 || !shot[0].is_number_integer() || !shot[1].is_number_integer() || !shot[2].is_number_integer())
+        {
+            error = "shot must be [player, row, col]";
+            return false;
+        }
+        const int player = shot[0].get<int>();
+        const int row = shot[1].get<int>();
+        const int col = shot[2].get<int>();
+        // Очерёдность и повторы проверит Replay; здесь - только то, что не влезет в ReplayShot
+        if ((player != 0 && player != 1) || !SeaBattle::GameField::isValidCoordinate(row, col))
+        {
+            error = "shot " + std::to_string(moves.size() + 1) + " is outside the board";
+            return false;
+        }
+        moves.push_back({ static_cast<std::int8_t>(player), static_cast<std::int8_t>(row), static_cast<std::int8_t>(col) });
+    }
+
+    try
+    {
+        m_impl->replay.emplace(start, std::move(moves));
+    }
+    catch (const std::invalid_argument& e)
+    {
+        error = e.what();
+        return false;
+    }
+
+    const auto& names = json.value("names", nlohmann::json::array());
+    for (int player = 0; player < 2; ++player)
+    {
+        m_impl->names[player] = names.is_array() && names.size() == 2 && names[player].is_string()
+            ? names[player].get<std::string>()
+            : "Игрок " + std::to_string(player + 1);
+    }
+    m_impl->ships = std::move(ships);
+    return true;
+}
+
+int ReplayGame::MoveCount() const
+{
+    return m_impl->replay ? m_impl->replay->MoveCount() : 0;
+}
+
+int ReplayGame::Position() const
+{
+    return m_impl->replay ? m_impl->replay->Position() : 0;
+}
+
+void ReplayGame::Seek(int move)
+{
+    if (m_impl->replay)
+    {
+        m_impl->replay->Seek(move);
+    }
+}
+
+int ReplayGame::Shooter(int move) const
+{
+    return m_impl->replay->Shot(move).player;
+}
+
+const std::string& ReplayGame::Name(int player) const
+{
+    return m_impl->names[player];
+}
+
+int ReplayGame::CurrentPlayer() const
+{
+    return m_impl->replay ? m_impl->replay->Current().GetCurrentPlayer() : 0;
+}
+
+int ReplayGame::State() const
+{
+    return static_cast<int>(m_impl->replay ? m_impl->replay->Current().GetGameState() : SeaBattle::GameState::WaitingForPlayers);
+}
+
+int ReplayGame::Winner() const
+{
+    return m_impl->replay ? m_impl->replay->Current().GetWinner() : -1;
+}
+
+int ReplayGame::Rows() const
+{
+    return SeaBattle::GameField::ROWS;
+}
+
+int ReplayGame::Cols() const
+{
+    return SeaBattle::GameField::COLS;
+}
+
+int ReplayGame::Cell(int owner, int row, int col) const
+{
+    return static_cast<int>(m_impl->replay->Current().GetPlayerField(owner).getCellState(row, col));
+}
+
+std::vector<LocalGame::ShipInfo> ReplayGame::Ships(int player) const
+{
+    return m_impl->ships[player];
+}
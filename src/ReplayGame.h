@@ -0,0 +1,51 @@
+#pragma once
+
+#include "LocalGame.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Записанная партия (JSON) с перемоткой к любому ходу. Как и LocalGame, мост не пускает
+// типы из GameModel.h наружу: состояния передаются числами в нумерации протокола.
+//
+// Формат файла:
+// {"version": 1, "names": ["...", "..."],
+//  "fleets": [[{"type", "row", "col", "isVertical"}, ...], [...]],
+//  "shots": [[player, row, col], ...]}
+// Флоты - расстановки игроков до первого выстрела, как в запросе place_fleet.
+class ReplayGame
+{
+public:
+    ReplayGame();
+    ~ReplayGame();
+
+    // Записывает партию локальной игры; false и текст ошибки, если файл не удалось записать
+    static bool Save(const std::string& path, const std::array<std::string, 2>& names, const LocalGame& game, std::string& error);
+
+    // false и текст ошибки, если файл не читается, флот не по правилам или выстрел недопустим
+    bool Load(const std::string& path, std::string& error);
+
+    int MoveCount() const;
+    int Position() const;
+    // Позиция после move выстрелов: ближайшая контрольная точка и несколько выстрелов от неё
+    void Seek(int move);
+    // Кто стрелял ходом move (0 .. MoveCount() - 1)
+    int Shooter(int move) const;
+
+    const std::string& Name(int player) const;
+    int CurrentPlayer() const;
+    int State() const;
+    int Winner() const;
+    int Rows() const;
+    int Cols() const;
+    // Состояние клетки поля игрока owner в текущей позиции
+    int Cell(int owner, int row, int col) const;
+    // Корабли игрока в начальной расстановке
+    std::vector<LocalGame::ShipInfo> Ships(int player) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
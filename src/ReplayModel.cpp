@@ -0,0 +1,156 @@
+#include "ReplayModel.h"
+#include "ReplayGame.h"
+
+#include "Trace.h"
+
+ReplayModel::ReplayModel(std::unique_ptr<ReplayGame> game)
+    : m_game(std::move(game))
+{
+    for (int player = 0; player < 2; ++player)
+    {
+        std::vector<SeaBattle::Ship> ships;
+        for (const auto& ship : m_game->Ships(player))
+        {
+            ships.emplace_back(static_cast<SeaBattle::ShipType>(ship.size), ship.row, ship.col, ship.vertical);
+        }
+        m_ships[player] = std::make_shared<const std::vector<SeaBattle::Ship>>(std::move(ships));
+    }
+}
+
+ReplayModel::~ReplayModel() = default;
+
+void ReplayModel::StartGame()
+{
+    if (m_statusCallback)
+    {
+        m_statusCallback(SeaBattle::ConnectionStatus::Loading);
+    }
+
+    // Окно очищает поля перед каждой игрой - показанных выстрелов нет
+    m_game->Seek(0);
+    const auto cells = static_cast<std::size_t>(m_game->Rows() * m_game->Cols());
+    for (auto& shown : m_shown)
+    {
+        shown.assign(cells, 0);
+    }
+
+    if (m_playerNamesCallback)
+    {
+        m_playerNamesCallback(GetLocalPlayerName(), GetOpponentName());
+    }
+    if (m_positionCallback)
+    {
+        m_positionCallback(0);
+    }
+    if (m_gameReadyCallback)
+    {
+        m_gameReadyCallback();
+    }
+}
+
+void ReplayModel::Seek(int move)
+{
+    SeaBattle::Trace::Span span("ReplayModel::Seek");
+
+    if (move == m_game->Position())
+    {
+        return;
+    }
+    m_game->Seek(move);
+    showDifferences();
+    if (m_positionCallback)
+    {
+        m_positionCallback(m_game->Position());
+    }
+}
+
+void ReplayModel::showDifferences()
+{
+    const int cols = m_game->Cols();
+    for (int owner = 0; owner < 2; ++owner)
+    {
+        // Колбэк клетки принимает стрелявшего: по полю owner стрелял его противник
+        const int shooter = 1 - owner;
+        auto& shown = m_shown[owner];
+        for (int row = 0; row < m_game->Rows(); ++row)
+        {
+            for (int col = 0; col < cols; ++col)
+            {
+                auto state = static_cast<SeaBattle::CellState>(m_game->Cell(owner, row, col));
+                const bool shot = state != SeaBattle::CellState::Empty && state != SeaBattle::CellState::Ship;
+                const auto value = static_cast<std::uint8_t>(shot ? state : SeaBattle::CellState::Empty);
+                std::uint8_t& current = shown[static_cast<std::size_t>(row * cols + col)];
+                if (current == value)
+                {
+                    continue;
+                }
+                current = value;
+                if (m_cellUpdateCallback)
+                {
+                    // Необстрелянная клетка: корабль показывается только на своём поле
+                    if (!shot && owner != Viewer)
+                    {
+                        state = SeaBattle::CellState::Empty;
+                    }
+                    m_cellUpdateCallback(shooter, row, col, state);
+                }
+            }
+        }
+    }
+}
+
+int ReplayModel::Position() const
+{
+    return m_game->Position();
+}
+
+int ReplayModel::MoveCount() const
+{
+    return m_game->MoveCount();
+}
+
+int ReplayModel::Shooter(int move) const
+{
+    return m_game->Shooter(move);
+}
+
+int ReplayModel::Winner() const
+{
+    return m_game->Winner();
+}
+
+std::shared_ptr<const std::vector<SeaBattle::Ship>> ReplayModel::GetPlayerShips(int player) const
+{
+    return m_ships[player];
+}
+
+int ReplayModel::GetCurrentPlayer() const
+{
+    return m_game->CurrentPlayer();
+}
+
+SeaBattle::GameState ReplayModel::GetGameState() const
+{
+    // Нумерация состояний совпадает с серверной (см. LocalGame.h)
+    return static_cast<SeaBattle::GameState>(m_game->State());
+}
+
+int ReplayModel::GetBoardRows() const
+{
+    return m_game->Rows();
+}
+
+int ReplayModel::GetBoardCols() const
+{
+    return m_game->Cols();
+}
+
+std::string ReplayModel::GetLocalPlayerName() const
+{
+    return m_game->Name(Viewer);
+}
+
+std::string ReplayModel::GetOpponentName() const
+{
+    return m_game->Name(1 - Viewer);
+}
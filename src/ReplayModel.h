@@ -0,0 +1,79 @@
+#pragma once
+
+#include "IModel.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class ReplayGame;
+
+// Просмотр записанной партии со стороны первого игрока. Выстрелов нет: позицию выбирает
+// ReplayControls через Seek. После перехода окну отправляются только клетки, которые
+// выглядят иначе, чем в показанной позиции (в том числе возврат к необстрелянной клетке
+// при перемотке назад). Колбэки клеток вызываются в потоке GUI внутри Seek.
+class ReplayModel : public SeaBattle::IModel
+{
+public:
+    using CellUpdateCallback = std::function<void(int player, int row, int col, SeaBattle::CellState state)>;
+    using StatusCallback = std::function<void(SeaBattle::ConnectionStatus status)>;
+    using GameReadyCallback = std::function<void()>;
+    using PlayerNamesCallback = std::function<void(const std::string& localName, const std::string& opponentName)>;
+    using PositionCallback = std::function<void(int move)>;
+
+    explicit ReplayModel(std::unique_ptr<ReplayGame> game);
+    ~ReplayModel() override;
+
+    void PrepareGame() override {}
+    void CancelPrepare() override {}
+    // Возвращает запись к началу партии
+    void StartGame() override;
+    bool ProcessShot(int, int) override { return false; }
+
+    std::shared_ptr<const std::vector<SeaBattle::Ship>> GetPlayerShips(int player) const override;
+    int GetCurrentPlayer() const override;
+    int GetLocalPlayer() const override { return Viewer; }
+    SeaBattle::GameState GetGameState() const override;
+    int GetBoardRows() const override;
+    int GetBoardCols() const override;
+
+    // Имя из записи важнее введённого на экране приветствия
+    void SetPlayerName(const std::string&) override {}
+    std::string GetLocalPlayerName() const override;
+    std::string GetOpponentName() const override;
+
+    // Только поток GUI
+    void Seek(int move);
+    int Position() const;
+    int MoveCount() const;
+    // Кто стрелял ходом move (0 .. MoveCount() - 1)
+    int Shooter(int move) const;
+    // -1, пока партия в текущей позиции не окончена
+    int Winner() const;
+
+    void setCellUpdateCallback(CellUpdateCallback callback) { m_cellUpdateCallback = callback; }
+    void setStatusCallback(StatusCallback callback) { m_statusCallback = callback; }
+    void setGameReadyCallback(GameReadyCallback callback) { m_gameReadyCallback = callback; }
+    void setPlayerNamesCallback(PlayerNamesCallback callback) { m_playerNamesCallback = callback; }
+    // Позиция изменилась: после Seek и при StartGame (тогда - из потока StartGame)
+    void setPositionCallback(PositionCallback callback) { m_positionCallback = callback; }
+
+private:
+    // Отправляет клетки, отличающиеся от показанных
+    void showDifferences();
+
+    static constexpr int Viewer = 0;
+
+    std::unique_ptr<ReplayGame> m_game;
+    std::array<std::shared_ptr<const std::vector<SeaBattle::Ship>>, 2> m_ships;
+    // Показанное состояние клеток обоих полей: 0 - не обстреляна, иначе CellState выстрела
+    std::array<std::vector<std::uint8_t>, 2> m_shown;
+
+    CellUpdateCallback m_cellUpdateCallback;
+    StatusCallback m_statusCallback;
+    GameReadyCallback m_gameReadyCallback;
+    PlayerNamesCallback m_playerNamesCallback;
+    PositionCallback m_positionCallback;
+};
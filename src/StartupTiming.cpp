@@ -0,0 +1,38 @@
+#include "StartupTiming.h"
+
+#include <QElapsedTimer>
+
+#include <iostream>
+
+namespace
+{
+    bool g_enabled = false;
+    QElapsedTimer g_timer;
+    qint64 g_lastNs = 0;
+}
+
+namespace StartupTiming
+{
+    void Enable()
+    {
+        g_enabled = true;
+        g_timer.start();
+        g_lastNs = 0;
+    }
+
+    bool Enabled()
+    {
+        return g_enabled;
+    }
+
+    void Mark(const char* phase)
+    {
+        if (!g_enabled)
+            return;
+
+        qint64 now = g_timer.nsecsElapsed();
+        std::cerr << "[client] startup " << phase << ": +" << (now - g_lastNs) / 1000000.0
+                  << " ms, total " << now / 1000000.0 << " ms" << std::endl;
+        g_lastNs = now;
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Замеры фаз запуска клиента (--startup-timing): время от начала main до каждой отметки
+// печатается в stderr. Выключено по умолчанию, Mark без Enable ничего не делает.
+namespace StartupTiming
+{
+    // Вызывается в начале main, от этого момента отсчитываются все отметки
+    void Enable();
+    bool Enabled();
+    void Mark(const char* phase);
+}
@@ -53,6 +53,8 @@ WelcomeScreen::WelcomeScreen(QWidget* parent)
 
 void WelcomeScreen::onStartButtonClicked()
 {
+    emit nameEntryStarted();
+
     QDialog dialog(this);
     dialog.setWindowTitle("Введите имя игрока");
     dialog.setModal(true);
@@ -85,6 +87,8 @@ void WelcomeScreen::onStartButtonClicked()
         if (!playerName.isEmpty())
         {
             emit startGameRequested(playerName);
+            return;
         }
     }
+    emit nameEntryCancelled();
 }
@@ -9,6 +9,10 @@ public:
     WelcomeScreen(QWidget* parent = nullptr);
 
 signals:
+    // Открыт диалог ввода имени - игрок собирается начать игру
+    void nameEntryStarted();
+    // Диалог закрыт без имени - игра не начинается
+    void nameEntryCancelled();
     void startGameRequested(const QString& playerName);
 
 private slots:
@@ -1,9 +1,60 @@
+#include "GuiEventQueue.h"
+#include "LocalGame.h"
+#include "LocalModel.h"
 #include "RemoteModel.h"
+#include "ReplayControls.h"
+#include "ReplayGame.h"
+#include "ReplayModel.h"
 #include "MainWindow.h"
+#include "StartupTiming.h"
+
+#include "Trace.h"
+
+#include <QCommandLineParser>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    // Колбэки подключения, общие для сетевой и локальной модели. Они приходят из потока
+    // StartGame по разу за игру, поэтому идут через очередь событий окна.
+    template <typename Model>
+    void connectSession(Model& gameModel, MainWindow& window)
+    {
+        gameModel.setStatusCallback([&window](SeaBattle::ConnectionStatus status) {
+            QMetaObject::invokeMethod(&window, &MainWindow::onStatusUpdate, status);
+            });
+
+        gameModel.setGameReadyCallback([&window]() {
+            QMetaObject::invokeMethod(&window, &MainWindow::onGameReady);
+            });
+
+        gameModel.setPlayerNamesCallback([&window](const std::string& localName, const std::string& opponentName) {
+            QMetaObject::invokeMethod(&window, &MainWindow::onPlayerNamesReceived,
+                QString::fromStdString(localName), QString::fromStdString(opponentName));
+            });
+    }
+}
 
 int main(int argc, char* argv[])
 {
+    // SEABATTLE_STARTUP_TIMING=1: печатать длительность фаз запуска до первого кадра
+    if (qEnvironmentVariableIntValue("SEABATTLE_STARTUP_TIMING") != 0)
+    {
+        StartupTiming::Enable();
+    }
+
     QApplication app(argc, argv);
+    StartupTiming::Mark("QApplication");
+
+    // SEABATTLE_TRACE=<файл>: записать отрезки обработки выстрелов в Chrome trace-event при выходе
+    const QString traceFile = qEnvironmentVariable("SEABATTLE_TRACE");
+    if (!traceFile.isEmpty())
+    {
+        SeaBattle::Trace::Enable("client");
+    }
 
     // Устанавливаем стиль приложения
     app.setStyleSheet(
@@ -12,36 +63,169 @@ int main(int argc, char* argv[])
         "                               stop:0 #1E3C72, stop:1 #2A5298);"
         "}");
 
-    auto gameModel = RemoteModel();
+    // --bot <стратегия> - партия против встроенного бота, --hotseat - вдвоём за одним компьютером.
+    // Обе работают без сервера; без ключей - сетевая игра. --record <файл> сохраняет такую
+    // партию, --replay <файл> открывает записанную партию для просмотра.
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption botOption("bot", "Play offline against a built-in bot.", "strategy");
+    QCommandLineOption hotSeatOption("hotseat", "Play offline, two players on one computer.");
+    QCommandLineOption recordOption("record", "Save the finished offline game to a replay file.", "file");
+    QCommandLineOption replayOption("replay", "Watch a recorded game.", "file");
+    QCommandLineOption serverSocketOption("server-socket", "Connect to a server on this machine through its unix socket.", "path");
+    parser.addOption(botOption);
+    parser.addOption(hotSeatOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(serverSocketOption);
+    parser.process(app);
+
+    std::unique_ptr<RemoteModel> remoteModel;
+    std::unique_ptr<LocalModel> localModel;
+    std::unique_ptr<ReplayModel> replayModel;
+    SeaBattle::IModel* gameModel = nullptr;
+    if (parser.isSet(replayOption))
+    {
+        auto replay = std::make_unique<ReplayGame>();
+        std::string error;
+        if (!replay->Load(parser.value(replayOption).toStdString(), error))
+        {
+            std::cerr << "[client] cannot open replay: " << error << std::endl;
+            return 1;
+        }
+        replayModel = std::make_unique<ReplayModel>(std::move(replay));
+        gameModel = replayModel.get();
+    }
+    else if (parser.isSet(botOption) || parser.isSet(hotSeatOption))
+    {
+        std::string strategy = parser.isSet(botOption) ? parser.value(botOption).toStdString() : std::string{};
+        const auto names = LocalGame::BotStrategyNames();
+        if (!strategy.empty() && std::find(names.begin(), names.end(), strategy) == names.end())
+        {
+            std::cerr << "[client] unknown bot strategy '" << strategy << "', expected one of:";
+            for (const auto& name : names)
+            {
+                std::cerr << " " << name;
+            }
+            std::cerr << std::endl;
+            return 1;
+        }
+        localModel = std::make_unique<LocalModel>(strategy);
+        localModel->setRecordPath(parser.value(recordOption).toStdString());
+        gameModel = localModel.get();
+    }
+    else
+    {
+        remoteModel = std::make_unique<RemoteModel>();
+        remoteModel->SetServerSocket(parser.value(serverSocketOption).toStdString());
+        gameModel = remoteModel.get();
+    }
 
-    MainWindow window(gameModel);
+    StartupTiming::Mark("model");
+
+    MainWindow window(*gameModel);
+    StartupTiming::Mark("main window");
     // Подключаем callback'и к GameScreen
-    gameModel.setCellUpdateCallback([&window](int player, int row, int col, SeaBattle::CellState state) {
-        QMetaObject::invokeMethod(&window, &MainWindow::onCellUpdated, player, row, col, state);
-        });
+    std::unique_ptr<GuiEventQueue> events;
+    if (remoteModel)
+    {
+        connectSession(*remoteModel, window);
+
+        // События игры приходят из потока сети пачками - через кольцо, разбираемое раз за кадр
+        events = std::make_unique<GuiEventQueue>(window);
+        RemoteModel* model = remoteModel.get();
+        GuiEventQueue* queue = events.get();
+
+        remoteModel->setCellUpdateCallback([queue](int player, int row, int col, SeaBattle::CellState state) {
+            GuiEvent event;
+            event.type = GuiEvent::Type::CellUpdate;
+            event.player = static_cast<std::int8_t>(player);
+            event.row = static_cast<std::int8_t>(row);
+            event.col = static_cast<std::int8_t>(col);
+            event.state = state;
+            queue->Push(event);
+            });
+
+        remoteModel->setShotRejectedCallback([queue, model](int row, int col) {
+            GuiEvent event;
+            event.type = GuiEvent::Type::ShotRejected;
+            event.player = static_cast<std::int8_t>(model->GetLocalPlayer());
+            event.row = static_cast<std::int8_t>(row);
+            event.col = static_cast<std::int8_t>(col);
+            queue->Push(event);
+            });
+
+        remoteModel->setPlayerSwitchCallback([queue](int newPlayer) {
+            GuiEvent event;
+            event.type = GuiEvent::Type::PlayerSwitch;
+            event.player = static_cast<std::int8_t>(newPlayer);
+            queue->Push(event);
+            });
 
-    gameModel.setPlayerSwitchCallback([&window](int newPlayer) {
-        QMetaObject::invokeMethod(&window, &MainWindow::onPlayerSwitched, newPlayer);
-        });
+        remoteModel->setGameOverCallback([queue](bool win) {
+            GuiEvent event;
+            event.type = GuiEvent::Type::GameOver;
+            event.win = win;
+            queue->Push(event);
+            });
 
-    gameModel.setGameOverCallback([&window](bool win) {
-        QMetaObject::invokeMethod(&window, &MainWindow::onGameOver, win);
-        });
+        remoteModel->setRoundTripCallback([queue](double milliseconds) {
+            GuiEvent event;
+            event.type = GuiEvent::Type::RoundTrip;
+            event.milliseconds = milliseconds;
+            queue->Push(event);
+            });
+    }
+    else if (replayModel)
+    {
+        connectSession(*replayModel, window);
 
-    gameModel.setStatusCallback([&window](SeaBattle::ConnectionStatus status) {
-        QMetaObject::invokeMethod(&window, &MainWindow::onStatusUpdate, status);
-        });
+        // Переход по записи меняет десятки клеток сразу - они сворачиваются в одну перерисовку за кадр
+        events = std::make_unique<GuiEventQueue>(window);
+        GuiEventQueue* queue = events.get();
+        replayModel->setCellUpdateCallback([queue](int player, int row, int col, SeaBattle::CellState state) {
+            GuiEvent event;
+            event.type = GuiEvent::Type::CellUpdate;
+            event.player = static_cast<std::int8_t>(player);
+            event.row = static_cast<std::int8_t>(row);
+            event.col = static_cast<std::int8_t>(col);
+            event.state = state;
+            queue->Push(event);
+            });
 
-    gameModel.setGameReadyCallback([&window]() {
-        QMetaObject::invokeMethod(&window, &MainWindow::onGameReady);
-        });
+        window.setReplayControls(new ReplayControls(*replayModel));
+    }
+    else
+    {
+        connectSession(*localModel, window);
 
-    gameModel.setPlayerNamesCallback([&window](const std::string& localName, const std::string& opponentName) {
-        QMetaObject::invokeMethod(&window, &MainWindow::onPlayerNamesReceived,
-            QString::fromStdString(localName), QString::fromStdString(opponentName));
-        });
+        // Локальная модель вызывает колбэки в потоке GUI внутри ProcessShot - сразу
+        localModel->setCellUpdateCallback([&window](int player, int row, int col, SeaBattle::CellState state) {
+            window.onCellUpdated(player, row, col, state);
+            });
+
+        localModel->setPlayerSwitchCallback([&window](int newPlayer) {
+            window.onPlayerSwitched(newPlayer);
+            });
+
+        localModel->setGameOverCallback([&window](bool win) {
+            window.onGameOver(win);
+            });
+
+        localModel->setLocalPlayerCallback([&window](int localPlayer) {
+            window.onLocalPlayerChanged(localPlayer);
+            });
+    }
 
     window.show();
+    StartupTiming::Mark("show");
+
+    int result = app.exec();
+
+    if (!traceFile.isEmpty() && !SeaBattle::Trace::WriteChromeTrace(traceFile.toStdString()))
+    {
+        std::cerr << "[client] failed to write trace " << traceFile.toStdString() << std::endl;
+    }
 
-    return app.exec();
+    return result;
 }
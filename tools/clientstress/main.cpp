@@ -0,0 +1,229 @@
+#include "RemoteModel.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Нагрузочная проверка срезов состояния клиента: две RemoteModel играют партии против
+// запущенного сервера, а потоки-читатели всё это время опрашивают геттеры. Геттеры
+// читают срез без блокировок, и каждое прочитанное значение должно быть из одного целого
+// среза: игрок 0 или 1, известное состояние, флот внутри поля, имена игроков целиком. Под
+// ThreadSanitizer заодно видны гонки (с TSAN_OPTIONS=suppressions=tools/clientstress/tsan.supp
+// для libstdc++ 12). Сервер - с ботами или без, но без других игроков:
+// обе модели должны попасть в одну комнату через "/".
+namespace
+{
+    using namespace SeaBattle;
+    using Clock = std::chrono::steady_clock;
+
+    struct Player
+    {
+        RemoteModel model;
+        std::string name;
+        // Имя соперника на начало партии: сервер мог не успеть получить его set_name и
+        // прислать имя по умолчанию, но за партию оно уже не меняется
+        std::string opponentName;
+        std::atomic<int> rejected{ 0 };
+        std::atomic<int> gameOver{ -1 };  // -1 - партия идёт, 1 - победа, 0 - поражение
+    };
+
+    struct Counters
+    {
+        std::atomic<std::uint64_t> reads{ 0 };
+        std::atomic<std::uint64_t> inconsistent{ 0 };
+    };
+
+    void report(Counters& counters, std::string_view what)
+    {
+        if (counters.inconsistent.fetch_add(1, std::memory_order_relaxed) < 10)
+        {
+            std::cerr << "[clientstress] inconsistent read: " << what << std::endl;
+        }
+    }
+
+    // Геттеры, которые GUI вызывает из любого потока
+    void readScalars(const Player& player, Counters& counters)
+    {
+        const RemoteModel& model = player.model;
+        const int current = model.GetCurrentPlayer();
+        const int local = model.GetLocalPlayer();
+        const GameState state = model.GetGameState();
+        const int rows = model.GetBoardRows();
+        const int cols = model.GetBoardCols();
+        const std::string localName = model.GetLocalPlayerName();
+        const std::string opponentName = model.GetOpponentName();
+
+        if (current < 0 || current > 1 || local < 0 || local > 1)
+            report(counters, "player index");
+        if (state != GameState::Welcome && state != GameState::Playing && state != GameState::GameOver)
+            report(counters, "game state");
+        if (rows <= 0 || cols <= 0 || rows > 64 || cols > 64)
+            report(counters, "board size");
+        if (localName != player.name)
+            report(counters, "local name");
+        if (opponentName != player.opponentName)
+            report(counters, "opponent name");
+        counters.reads.fetch_add(7, std::memory_order_relaxed);
+    }
+
+    void readFleet(const Player& player, Counters& counters)
+    {
+        const RemoteModel& model = player.model;
+        const int rows = model.GetBoardRows();
+        const int cols = model.GetBoardCols();
+        const auto ships = model.GetPlayerShips(model.GetLocalPlayer());
+        for (const auto& ship : *ships)
+        {
+            if (ship.positions.size() != static_cast<std::size_t>(ship.type))
+                report(counters, "ship length");
+            for (const auto& position : ship.positions)
+            {
+                if (position.row < 0 || position.row >= rows || position.col < 0 || position.col >= cols)
+                    report(counters, "ship outside the board");
+            }
+        }
+        counters.reads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Стреляет по клеткам подряд, пока партия не кончится; false - партия не уложилась в timeout
+    bool play(Player& player, Clock::duration timeout)
+    {
+        const auto deadline = Clock::now() + timeout;
+        int cell = 0;
+        while (player.gameOver.load() < 0 && Clock::now() < deadline)
+        {
+            RemoteModel& model = player.model;
+            const int rows = model.GetBoardRows();
+            const int cols = model.GetBoardCols();
+            if (model.GetGameState() == GameState::Playing && model.GetCurrentPlayer() == model.GetLocalPlayer()
+                && cell < rows * cols && model.ProcessShot(cell / cols, cell % cols))
+            {
+                ++cell;
+            }
+            std::this_thread::yield();
+        }
+        return player.gameOver.load() >= 0;
+    }
+
+    // Одна партия двух моделей при работающих читателях; false - партия не доиграна
+    bool runGame(Player& first, Player& second, unsigned readers, Counters& counters)
+    {
+        for (Player* player : { &first, &second })
+        {
+            player->gameOver = -1;
+            player->model.SetPlayerName(player->name);
+            player->model.setShotRejectedCallback([player](int, int) { ++player->rejected; });
+            player->model.setGameOverCallback([player](bool won) { player->gameOver = won ? 1 : 0; });
+        }
+
+        // StartGame ждёт соперника - модели подключаются одновременно.
+        // Читатели - как GUI - начинают после StartGame, когда соединение модели уже есть
+        std::thread secondStart([&second]() { second.model.StartGame(); });
+        first.model.StartGame();
+        secondStart.join();
+        first.opponentName = first.model.GetOpponentName();
+        second.opponentName = second.model.GetOpponentName();
+
+        std::atomic<bool> stop{ false };
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < readers; ++i)
+        {
+            threads.emplace_back([&, i]()
+                {
+                    const Player& player = i % 2 == 0 ? first : second;
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        readScalars(player, counters);
+                        readFleet(player, counters);
+                    }
+                });
+        }
+
+        bool secondFinished = false;
+        std::thread secondPlay([&]() { secondFinished = play(second, std::chrono::seconds(60)); });
+        const bool finished = play(first, std::chrono::seconds(60));
+        secondPlay.join();
+
+        stop = true;
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        if (finished && secondFinished && first.gameOver + second.gameOver != 1)
+        {
+            report(counters, "both or neither player won");
+        }
+        return finished && secondFinished;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string socketPath;
+    int games = 20;
+    unsigned readers = 6;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--socket" && hasValue)
+            {
+                socketPath = argv[++i];
+            }
+            else if (arg == "--games" && hasValue)
+            {
+                games = std::stoi(argv[++i]);
+            }
+            else if (arg == "--readers" && hasValue)
+            {
+                readers = static_cast<unsigned>(std::stoul(argv[++i]));
+            }
+            else
+            {
+                std::cerr << "usage: clientstress [--socket PATH] [--games N] [--readers N]\n"
+                             "  server: 127.0.0.7:1365 or the unix socket from server --unix-socket" << std::endl;
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "[clientstress] " << ex.what() << std::endl;
+        return 1;
+    }
+
+    Counters counters;
+    int played = 0;
+    int rejected = 0;
+    const auto start = Clock::now();
+    for (int game = 0; game < games; ++game)
+    {
+        // Модель рассчитана на одну партию: на каждую - новые
+        Player first;
+        Player second;
+        first.name = "stress-" + std::to_string(game) + "-a";
+        second.name = "stress-" + std::to_string(game) + "-b";
+        first.model.SetServerSocket(socketPath);
+        second.model.SetServerSocket(socketPath);
+        if (!runGame(first, second, readers, counters))
+        {
+            std::cerr << "[clientstress] game " << game << " did not finish" << std::endl;
+            break;
+        }
+        ++played;
+        rejected += first.rejected + second.rejected;
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "[clientstress] games=" << played << "/" << games << " readers=" << readers
+              << " reads=" << counters.reads.load() << " (" << counters.reads.load() / seconds / 1e6 << " M/s)"
+              << " inconsistent=" << counters.inconsistent.load() << " rejectedShots=" << rejected << std::endl;
+    return played == games && counters.inconsistent == 0 && rejected == 0 ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#include "OpeningBook.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Строит книгу дебютов для сервера (--opening-book): выборка расстановок ShipPlacer,
+// дерево выстрелов по наибольшей вероятности попадания, запись в бинарный файл.
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "usage: openingbook --out FILE [--samples N] [--depth N] [--min-samples N] [--seed N]" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace SeaBattle;
+
+    OpeningBookOptions options;
+    std::string outputPath;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--out" && hasValue)
+            {
+                outputPath = argv[++i];
+            }
+            else if (arg == "--samples" && hasValue)
+            {
+                options.samples = std::stoi(argv[++i]);
+            }
+            else if (arg == "--depth" && hasValue)
+            {
+                options.depth = std::stoi(argv[++i]);
+            }
+            else if (arg == "--min-samples" && hasValue)
+            {
+                options.minSamples = std::stoi(argv[++i]);
+            }
+            else if (arg == "--seed" && hasValue)
+            {
+                options.seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            }
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        if (outputPath.empty() || options.samples <= 0 || options.depth <= 0 || options.minSamples <= 0)
+        {
+            printUsage();
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto moves = OpeningBook::Build(options);
+        OpeningBook::Write(outputPath, moves, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Проверяем записанное тем же путём, каким его откроет сервер
+        OpeningBook book(outputPath);
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "[openingbook] " << book.Size() << " positions, depth " << book.Depth() << ", "
+                  << options.samples << " samples, " << static_cast<double>(book.Bytes()) / 1024.0 << " KiB in "
+                  << seconds << " s -> " << outputPath << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[openingbook] " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
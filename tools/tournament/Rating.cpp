@@ -0,0 +1,86 @@
+#include "Rating.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SeaBattle::Tournament
+{
+    namespace
+    {
+        constexpr double BaseElo = 1500.0;
+        constexpr double EloScale = 400.0 / 2.302585092994046;  // 400 / ln(10)
+        // Половина виртуальной победы и поражения против каждого соперника:
+        // стратегия без единой победы получает конечный рейтинг
+        constexpr double Prior = 0.5;
+    }
+
+    std::vector<Rating> ComputeRatings(const std::vector<std::vector<std::uint64_t>>& wins)
+    {
+        const std::size_t n = wins.size();
+        std::vector<double> strength(n, 1.0);
+
+        auto games = [&](std::size_t i, std::size_t j)
+        {
+            return static_cast<double>(wins[i][j] + wins[j][i]) + 2.0 * Prior;
+        };
+
+        // Итерации minorization-maximization (Hunter, 2004)
+        for (int iteration = 0; iteration < 1000; ++iteration)
+        {
+            double maxChange = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                double won = 0.0;
+                double denominator = 0.0;
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    if (i == j)
+                    {
+                        continue;
+                    }
+                    won += static_cast<double>(wins[i][j]) + Prior;
+                    denominator += games(i, j) / (strength[i] + strength[j]);
+                }
+                double updated = denominator > 0.0 ? won / denominator : 1.0;
+                maxChange = std::max(maxChange, std::abs(std::log(updated / strength[i])));
+                strength[i] = updated;
+            }
+
+            // Нормируем на среднее геометрическое, чтобы средний рейтинг был BaseElo
+            double meanLog = 0.0;
+            for (double s : strength)
+            {
+                meanLog += std::log(s);
+            }
+            meanLog /= static_cast<double>(n);
+            for (double& s : strength)
+            {
+                s /= std::exp(meanLog);
+            }
+
+            if (maxChange < 1e-10)
+            {
+                break;
+            }
+        }
+
+        // Стандартная ошибка по диагонали информации Фишера
+        std::vector<Rating> ratings(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double information = 0.0;
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                if (i == j)
+                {
+                    continue;
+                }
+                double p = strength[i] / (strength[i] + strength[j]);
+                information += games(i, j) * p * (1.0 - p);
+            }
+            ratings[i].elo = BaseElo + EloScale * std::log(strength[i]);
+            ratings[i].ci95 = information > 0.0 ? 1.96 * EloScale / std::sqrt(information) : 0.0;
+        }
+        return ratings;
+    }
+}
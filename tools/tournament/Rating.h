@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace SeaBattle::Tournament
+{
+    struct Rating
+    {
+        double elo = 0.0;
+        double ci95 = 0.0;  // полуширина 95% доверительного интервала, в пунктах Эло
+    };
+
+    // Рейтинги по модели Брэдли-Терри, подобранные по всей таблице результатов сразу.
+    // В отличие от пошагового пересчёта Эло результат не зависит от порядка партий.
+    // wins[i][j] - сколько раз стратегия i выиграла у стратегии j.
+    std::vector<Rating> ComputeRatings(const std::vector<std::vector<std::uint64_t>>& wins);
+}
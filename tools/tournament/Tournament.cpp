@@ -0,0 +1,335 @@
+#include "Tournament.h"
+
+#include "GameModel.h"
+#include "Strategy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace SeaBattle::Tournament
+{
+    namespace
+    {
+        constexpr std::uint64_t GamesPerChunk = 256;
+        constexpr std::string_view CheckpointMagic = "seabattle-tournament 1";
+
+        std::uint64_t splitmix64(std::uint64_t x)
+        {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        std::uint64_t gameSeed(std::uint64_t seed, std::size_t pair, std::uint64_t game)
+        {
+            return splitmix64(splitmix64(seed ^ splitmix64(pair)) ^ game);
+        }
+
+        struct Chunk
+        {
+            std::size_t pair = 0;
+            std::uint64_t firstGame = 0;
+            std::uint64_t games = 0;
+        };
+
+        struct Schedule
+        {
+            std::vector<std::pair<std::size_t, std::size_t>> pairs;
+            std::vector<Chunk> chunks;
+        };
+
+        Schedule makeSchedule(const Config& config)
+        {
+            Schedule schedule;
+            for (std::size_t i = 0; i < config.strategies.size(); ++i)
+            {
+                for (std::size_t j = i + 1; j < config.strategies.size(); ++j)
+                {
+                    schedule.pairs.emplace_back(i, j);
+                }
+            }
+            for (std::size_t pair = 0; pair < schedule.pairs.size(); ++pair)
+            {
+                for (std::uint64_t first = 0; first < config.gamesPerPair; first += GamesPerChunk)
+                {
+                    schedule.chunks.push_back({ pair, first, std::min(GamesPerChunk, config.gamesPerPair - first) });
+                }
+            }
+            return schedule;
+        }
+
+        // Одна партия на классических правилах. Расстановка и выстрелы каждого игрока
+        // берут случайность из своих генераторов, выведенных из зерна партии.
+        void playGame(IShotStrategy& first, IShotStrategy& second, std::uint64_t seed, bool secondMovesFirst,
+            PairResult& result)
+        {
+            std::mt19937 placementGen(static_cast<std::uint32_t>(seed));
+            std::array<std::mt19937, 2> shotGens{
+                std::mt19937(static_cast<std::uint32_t>(seed >> 32)),
+                std::mt19937(static_cast<std::uint32_t>(splitmix64(seed))) };
+
+            GameModel model;
+            model.StartGame(placementGen);
+
+            std::array<IShotStrategy*, 2> players{ &first, &second };
+            if (secondMovesFirst)
+            {
+                std::swap(players[0], players[1]);
+            }
+
+            std::array<std::uint64_t, 2> shots{ 0, 0 };
+            // Ограничитель на случай ошибки в стратегии: честная партия не длиннее 2 * 100 выстрелов
+            while (model.GetGameState() == GameState::Playing && shots[0] + shots[1] < 2 * ClassicRules::Cells)
+            {
+                int player = model.GetCurrentPlayer();
+                ShotBoard board = ShotBoard::FromEnemyField(model.GetEnemyField(player));
+                Position shot = players[player]->NextShot(board, shotGens[player]);
+                model.ProcessShot(player, shot.row, shot.col);
+                ++shots[player];
+            }
+
+            int winner = model.GetWinner();
+            int firstSeat = secondMovesFirst ? 1 : 0;
+            if (winner == firstSeat)
+            {
+                ++result.winsFirst;
+            }
+            else if (winner >= 0)
+            {
+                ++result.winsSecond;
+            }
+            result.shotsFirst += shots[firstSeat];
+            result.shotsSecond += shots[1 - firstSeat];
+        }
+
+        std::string joinNames(const std::vector<std::string>& names)
+        {
+            std::string joined;
+            for (const auto& name : names)
+            {
+                joined += (joined.empty() ? "" : ",") + name;
+            }
+            return joined;
+        }
+
+        std::string checkpointHeader(const Config& config)
+        {
+            std::ostringstream header;
+            header << CheckpointMagic << "\n"
+                   << "seed " << config.seed << "\n"
+                   << "games " << config.gamesPerPair << "\n"
+                   << "strategies " << joinNames(config.strategies) << "\n";
+            return header.str();
+        }
+
+        // Формат контрольной точки - текст: заголовок с параметрами турнира
+        // и по строке "chunk <номер> <winsFirst> <winsSecond> <shotsFirst> <shotsSecond>"
+        // на каждый готовый блок. Параметры должны совпадать с текущим запуском.
+        std::size_t loadCheckpoint(const Config& config, std::vector<PairResult>& results,
+            std::vector<std::uint8_t>& done)
+        {
+            std::ifstream in(config.checkpointPath);
+            if (!in)
+            {
+                return 0;
+            }
+
+            std::string expected = checkpointHeader(config);
+            std::string header;
+            std::string line;
+            for (int i = 0; i < 4 && std::getline(in, line); ++i)
+            {
+                header += line + "\n";
+            }
+            if (header != expected)
+            {
+                throw std::runtime_error("checkpoint " + config.checkpointPath
+                    + " was written for a different tournament (seed, games or strategies differ)");
+            }
+
+            std::size_t loaded = 0;
+            while (std::getline(in, line))
+            {
+                std::istringstream fields(line);
+                std::string tag;
+                std::size_t index = 0;
+                PairResult result;
+                if (!(fields >> tag >> index >> result.winsFirst >> result.winsSecond >> result.shotsFirst
+                        >> result.shotsSecond)
+                    || tag != "chunk" || index >= results.size())
+                {
+                    throw std::runtime_error("malformed checkpoint line: " + line);
+                }
+                if (!done[index])
+                {
+                    results[index] = result;
+                    done[index] = 1;
+                    ++loaded;
+                }
+            }
+            return loaded;
+        }
+
+        // Пишем во временный файл и переименовываем, чтобы обрыв не оставил испорченную точку
+        void saveCheckpoint(const Config& config, const std::vector<PairResult>& results,
+            const std::unique_ptr<std::atomic<bool>[]>& done)
+        {
+            std::string tmpPath = config.checkpointPath + ".tmp";
+            {
+                std::ofstream out(tmpPath, std::ios::trunc);
+                out << checkpointHeader(config);
+                for (std::size_t i = 0; i < results.size(); ++i)
+                {
+                    if (done[i].load(std::memory_order_acquire))
+                    {
+                        const auto& r = results[i];
+                        out << "chunk " << i << " " << r.winsFirst << " " << r.winsSecond << " "
+                            << r.shotsFirst << " " << r.shotsSecond << "\n";
+                    }
+                }
+                if (!out)
+                {
+                    std::cerr << "[tournament] failed to write checkpoint " << tmpPath << std::endl;
+                    return;
+                }
+            }
+            std::error_code ec;
+            std::filesystem::rename(tmpPath, config.checkpointPath, ec);
+            if (ec)
+            {
+                std::cerr << "[tournament] failed to replace checkpoint: " << ec.message() << std::endl;
+            }
+        }
+    }
+
+    Result Run(const Config& config)
+    {
+        if (config.strategies.size() < 2)
+        {
+            throw std::runtime_error("at least two strategies are required");
+        }
+        for (const auto& name : config.strategies)
+        {
+            if (!MakeStrategy(name))
+            {
+                throw std::runtime_error("unknown strategy '" + name + "'");
+            }
+        }
+
+        const Schedule schedule = makeSchedule(config);
+        const std::size_t chunkCount = schedule.chunks.size();
+
+        std::vector<PairResult> chunkResults(chunkCount);
+        auto done = std::make_unique<std::atomic<bool>[]>(chunkCount);
+
+        Result result;
+        if (!config.checkpointPath.empty())
+        {
+            std::vector<std::uint8_t> loaded(chunkCount, 0);
+            loadCheckpoint(config, chunkResults, loaded);
+            for (std::size_t i = 0; i < chunkCount; ++i)
+            {
+                done[i].store(loaded[i] != 0, std::memory_order_relaxed);
+                result.gamesResumed += loaded[i] ? schedule.chunks[i].games : 0;
+            }
+        }
+
+        std::atomic<std::size_t> nextChunk{ 0 };
+        std::atomic<std::uint64_t> gamesPlayed{ 0 };
+        std::atomic<unsigned> activeWorkers{ 0 };
+
+        auto worker = [&]()
+        {
+            // Экземпляры стратегий у каждого потока свои: стратегии могут хранить состояние
+            std::vector<std::unique_ptr<IShotStrategy>> strategies;
+            for (const auto& name : config.strategies)
+            {
+                strategies.push_back(MakeStrategy(name));
+            }
+
+            for (std::size_t index = nextChunk++; index < chunkCount; index = nextChunk++)
+            {
+                if (done[index].load(std::memory_order_relaxed))
+                {
+                    continue;
+                }
+                const Chunk& chunk = schedule.chunks[index];
+                auto [first, second] = schedule.pairs[chunk.pair];
+                PairResult chunkResult;
+                for (std::uint64_t game = chunk.firstGame; game < chunk.firstGame + chunk.games; ++game)
+                {
+                    playGame(*strategies[first], *strategies[second], gameSeed(config.seed, chunk.pair, game),
+                        game % 2 == 1, chunkResult);
+                }
+                chunkResults[index] = chunkResult;
+                done[index].store(true, std::memory_order_release);
+                gamesPlayed += chunk.games;
+            }
+            --activeWorkers;
+        };
+
+        unsigned threadCount = config.threads != 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        activeWorkers = threadCount;
+        for (unsigned i = 0; i < threadCount; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+
+        auto lastCheckpoint = start;
+        while (activeWorkers.load() > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            auto now = std::chrono::steady_clock::now();
+            if (!config.checkpointPath.empty() && now - lastCheckpoint >= config.checkpointInterval)
+            {
+                saveCheckpoint(config, chunkResults, done);
+                lastCheckpoint = now;
+                double elapsed = std::chrono::duration<double>(now - start).count();
+                std::cout << "[tournament] checkpoint: " << result.gamesResumed + gamesPlayed.load() << " games, "
+                          << static_cast<double>(gamesPlayed.load()) / elapsed << " games/s" << std::endl;
+            }
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!config.checkpointPath.empty())
+        {
+            saveCheckpoint(config, chunkResults, done);
+        }
+
+        // Свод по парам строго в порядке блоков - сумма не зависит от того, кто и когда их посчитал
+        result.pairs.resize(schedule.pairs.size());
+        std::uint64_t digest = 0xCBF29CE484222325ull;
+        for (std::size_t i = 0; i < chunkCount; ++i)
+        {
+            const auto& chunk = chunkResults[i];
+            auto& pair = result.pairs[schedule.chunks[i].pair];
+            pair.winsFirst += chunk.winsFirst;
+            pair.winsSecond += chunk.winsSecond;
+            pair.shotsFirst += chunk.shotsFirst;
+            pair.shotsSecond += chunk.shotsSecond;
+            for (std::uint64_t value : { chunk.winsFirst, chunk.winsSecond, chunk.shotsFirst, chunk.shotsSecond })
+            {
+                digest = (digest ^ value) * 0x100000001B3ull;
+            }
+        }
+        result.digest = digest;
+        result.gamesPlayed = gamesPlayed.load();
+        result.gamesTotal = result.gamesResumed + result.gamesPlayed;
+        return result;
+    }
+}
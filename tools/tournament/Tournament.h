@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SeaBattle::Tournament
+{
+    struct Config
+    {
+        std::vector<std::string> strategies;
+        std::uint64_t gamesPerPair = 1000;
+        std::uint64_t seed = 1365;
+        unsigned threads = 0;  // 0 - по числу ядер
+        std::string checkpointPath;
+        std::chrono::seconds checkpointInterval{ 10 };
+    };
+
+    // Итог встреч пары стратегий first < second (индексы в Config::strategies)
+    struct PairResult
+    {
+        std::uint64_t winsFirst = 0;
+        std::uint64_t winsSecond = 0;
+        std::uint64_t shotsFirst = 0;
+        std::uint64_t shotsSecond = 0;
+    };
+
+    struct Result
+    {
+        std::vector<PairResult> pairs;   // в порядке (0,1), (0,2), ..., (1,2), ...
+        std::uint64_t gamesTotal = 0;
+        std::uint64_t gamesResumed = 0;  // взяты из контрольной точки
+        std::uint64_t gamesPlayed = 0;   // сыграны в этом запуске
+        double elapsedSeconds = 0.0;
+        std::uint64_t digest = 0;        // отпечаток всех результатов для сравнения запусков
+    };
+
+    // Круговой турнир: каждая пара стратегий играет gamesPerPair партий, по очереди
+    // начиная первой. Партии разбиты на блоки фиксированного размера, потоки разбирают
+    // блоки в произвольном порядке, но зерно партии зависит только от (seed, пара, номер
+    // партии), а блоки складываются по номеру - итог не зависит от числа потоков.
+    // Готовые блоки периодически сохраняются в checkpointPath, повторный запуск с тем же
+    // файлом продолжает турнир. Бросает std::runtime_error при ошибке в конфигурации.
+    Result Run(const Config& config);
+}
@@ -0,0 +1,134 @@
+#include "Rating.h"
+#include "Strategy.h"
+#include "Tournament.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "usage: tournament [--strategies a,b,...] [--games N] [--seed N] [--threads N]\n"
+                     "                  [--checkpoint FILE] [--checkpoint-interval SECONDS]\n"
+                     "available strategies:";
+        for (auto name : SeaBattle::StrategyNames())
+        {
+            std::cerr << " " << name;
+        }
+        std::cerr << std::endl;
+    }
+
+    std::vector<std::string> splitList(std::string_view list)
+    {
+        std::vector<std::string> items;
+        while (!list.empty())
+        {
+            auto comma = list.find(',');
+            items.emplace_back(list.substr(0, comma));
+            list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+        }
+        return items;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace SeaBattle;
+
+    Tournament::Config config;
+    for (auto name : StrategyNames())
+    {
+        config.strategies.emplace_back(name);
+    }
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--strategies" && hasValue)
+            {
+                config.strategies = splitList(argv[++i]);
+            }
+            else if (arg == "--games" && hasValue)
+            {
+                config.gamesPerPair = std::stoull(argv[++i]);
+            }
+            else if (arg == "--seed" && hasValue)
+            {
+                config.seed = std::stoull(argv[++i]);
+            }
+            else if (arg == "--threads" && hasValue)
+            {
+                config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--checkpoint" && hasValue)
+            {
+                config.checkpointPath = argv[++i];
+            }
+            else if (arg == "--checkpoint-interval" && hasValue)
+            {
+                config.checkpointInterval = std::chrono::seconds(std::stoll(argv[++i]));
+            }
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+
+        auto result = Tournament::Run(config);
+
+        const std::size_t n = config.strategies.size();
+        std::vector<std::vector<std::uint64_t>> wins(n, std::vector<std::uint64_t>(n, 0));
+        std::vector<std::uint64_t> games(n, 0);
+        std::vector<std::uint64_t> shots(n, 0);
+        std::size_t pairIndex = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = i + 1; j < n; ++j, ++pairIndex)
+            {
+                const auto& pair = result.pairs[pairIndex];
+                wins[i][j] = pair.winsFirst;
+                wins[j][i] = pair.winsSecond;
+                games[i] += config.gamesPerPair;
+                games[j] += config.gamesPerPair;
+                shots[i] += pair.shotsFirst;
+                shots[j] += pair.shotsSecond;
+            }
+        }
+        auto ratings = Tournament::ComputeRatings(wins);
+
+        std::cout << "[tournament] " << result.gamesTotal << " games (" << result.gamesResumed
+                  << " from checkpoint), seed " << config.seed << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            std::uint64_t won = 0;
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                won += wins[i][j];
+            }
+            std::cout << "[tournament] " << std::left << std::setw(10) << config.strategies[i] << std::right
+                      << " elo " << std::setw(7) << ratings[i].elo << " +/- " << std::setw(5) << ratings[i].ci95
+                      << "  wins " << won << "/" << games[i]
+                      << "  shots/game " << static_cast<double>(shots[i]) / static_cast<double>(games[i])
+                      << std::endl;
+        }
+        std::cout << "[tournament] throughput: "
+                  << static_cast<double>(result.gamesPlayed) / result.elapsedSeconds << " games/s" << std::endl;
+        std::cout << "[tournament] result digest: " << std::hex << result.digest << std::dec << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[tournament] " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
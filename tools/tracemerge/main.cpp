@@ -0,0 +1,220 @@
+#include "Trace.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Сводит трассы клиента и сервера (Chrome trace-event) в одну временную шкалу.
+// Часы процессов выравниваются по выстрелам, которые есть в обеих трассах: клиентский
+// отрезок "rtt" [t0, t3] охватывает серверный "handler" [t1, t2], и по формуле NTP
+// смещение часов равно ((t1 - t0) + (t2 - t3)) / 2. Берётся медиана по всем выстрелам.
+// Оценка считает путь туда и обратно симметричным; для процессов на одной машине
+// часы и так общие (монотонные), и выравнивание можно отключить флагом --same-clock.
+namespace
+{
+    struct Span
+    {
+        double start = 0.0;  // мкс
+        double end = 0.0;
+    };
+
+    struct TraceFile
+    {
+        std::string path;
+        nlohmann::json events;
+        std::map<std::string, Span> roundTrips;  // id трассы -> клиентский отрезок
+        std::map<std::string, Span> handlers;    // id трассы -> серверный отрезок
+    };
+
+    std::string traceId(const nlohmann::json& event)
+    {
+        if (!event.contains("args") || !event["args"].contains("trace"))
+        {
+            return {};
+        }
+        const auto& id = event["args"]["trace"];
+        std::string value = id.is_string() ? id.get<std::string>() : id.dump();
+        return value == "0" ? std::string{} : value;
+    }
+
+    bool load(const std::string& path, TraceFile& file)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::cerr << "[tracemerge] cannot open " << path << std::endl;
+            return false;
+        }
+        nlohmann::json json = nlohmann::json::parse(in, nullptr, false);
+        if (json.is_discarded())
+        {
+            std::cerr << "[tracemerge] " << path << " is not valid JSON" << std::endl;
+            return false;
+        }
+
+        file.path = path;
+        file.events = json.is_array() ? json : json.value("traceEvents", nlohmann::json::array());
+        for (const auto& event : file.events)
+        {
+            if (event.value("ph", "") != "X")
+            {
+                continue;
+            }
+            std::string id = traceId(event);
+            if (id.empty())
+            {
+                continue;
+            }
+            double start = event.value("ts", 0.0);
+            Span span{ start, start + event.value("dur", 0.0) };
+            std::string category = event.value("cat", "");
+            if (category == SeaBattle::Trace::RoundTripCategory)
+            {
+                file.roundTrips[id] = span;
+            }
+            else if (category == SeaBattle::Trace::HandlerCategory)
+            {
+                file.handlers[id] = span;
+            }
+        }
+        return true;
+    }
+
+    double median(std::vector<double> values)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2), values.end());
+        return values[values.size() / 2];
+    }
+
+    // Пары клиент-сервер по id выстрела: смещение часов и разбивка задержки
+    struct Alignment
+    {
+        std::vector<double> offsets;
+        std::vector<double> roundTrips;
+        std::vector<double> handlers;
+    };
+
+    Alignment align(const TraceFile& a, const TraceFile& b)
+    {
+        Alignment result;
+        // Клиентом считается та трасса, в которой есть отрезки "rtt" для общих выстрелов
+        auto collect = [&result](const TraceFile& client, const TraceFile& server, double sign)
+        {
+            for (const auto& [id, roundTrip] : client.roundTrips)
+            {
+                auto it = server.handlers.find(id);
+                if (it == server.handlers.end())
+                {
+                    continue;
+                }
+                const Span& handler = it->second;
+                result.offsets.push_back(sign * ((handler.start - roundTrip.start) + (handler.end - roundTrip.end)) / 2.0);
+                result.roundTrips.push_back(roundTrip.end - roundTrip.start);
+                result.handlers.push_back(handler.end - handler.start);
+            }
+        };
+        collect(a, b, 1.0);
+        collect(b, a, -1.0);
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    bool sameClock = false;
+    if (!args.empty() && args.front() == "--same-clock")
+    {
+        sameClock = true;
+        args.erase(args.begin());
+    }
+    if (args.size() < 3)
+    {
+        std::cerr << "usage: tracemerge [--same-clock] OUTPUT.json REFERENCE.json OTHER.json [OTHER.json...]\n"
+                     "  times of every OTHER trace are shifted onto the clock of REFERENCE;\n"
+                     "  --same-clock keeps timestamps as is (all processes ran on one host)" << std::endl;
+        return 1;
+    }
+    const std::string outputPath = args[0];
+
+    std::vector<TraceFile> files(args.size() - 1);
+    for (std::size_t i = 1; i < args.size(); ++i)
+    {
+        if (!load(args[i], files[i - 1]))
+        {
+            return 1;
+        }
+    }
+
+    nlohmann::json merged = nlohmann::json::array();
+    std::set<std::int64_t> usedPids;
+    std::cout << std::fixed << std::setprecision(1);
+
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        double offset = 0.0;
+        if (i > 0)
+        {
+            Alignment alignment = align(files[0], files[i]);
+            if (alignment.offsets.empty())
+            {
+                std::cerr << "[tracemerge] " << files[i].path
+                          << ": no shots shared with the reference trace, clocks are left as is" << std::endl;
+            }
+            else
+            {
+                offset = sameClock ? 0.0 : median(alignment.offsets);
+                double roundTrip = median(alignment.roundTrips);
+                double handler = median(alignment.handlers);
+                std::cout << "[tracemerge] " << files[i].path << ": " << alignment.offsets.size()
+                          << " shared shots, clock offset " << median(alignment.offsets) << " us"
+                          << (sameClock ? " (not applied)" : "") << std::endl;
+                std::cout << "[tracemerge]   median round trip " << roundTrip << " us = server "
+                          << handler << " us + network/client " << roundTrip - handler << " us" << std::endl;
+            }
+        }
+
+        // Трассы из разных процессов могут иметь одинаковый pid (например, с разных машин)
+        std::map<std::int64_t, std::int64_t> pidMap;
+        for (auto event : files[i].events)
+        {
+            std::int64_t pid = event.value("pid", std::int64_t{ 0 });
+            auto [it, inserted] = pidMap.emplace(pid, pid);
+            if (inserted)
+            {
+                while (usedPids.count(it->second) != 0)
+                {
+                    ++it->second;
+                }
+                usedPids.insert(it->second);
+            }
+            event["pid"] = it->second;
+            if (event.contains("ts"))
+            {
+                event["ts"] = event["ts"].get<double>() - offset;
+            }
+            merged.push_back(std::move(event));
+        }
+    }
+
+    std::ofstream out(outputPath, std::ios::trunc);
+    out << nlohmann::json{ {"displayTimeUnit", "ns"}, {"traceEvents", merged} }.dump() << std::endl;
+    if (!out)
+    {
+        std::cerr << "[tracemerge] failed to write " << outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "[tracemerge] " << merged.size() << " events written to " << outputPath << std::endl;
+    return 0;
+}